@@ -88,6 +88,10 @@
 %template(VectorConstHolderPtr) std::vector<const Holder*>;
 
 %template(VectorPartitionSlot) std::vector<PartitionSlot>;
+%template(VectorPartitionRequest) std::vector<PartitionRequest>;
+
+%template(VectorTimeEntry) std::vector<TimeEntry>;
+%template(VectorCommandStatistics) std::vector<CommandStatistics>;
 
 %template(VectorPtType) std::vector<PtType>;
 
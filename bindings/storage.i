@@ -8,6 +8,7 @@
 %ignore "clone";
 %ignore "operator <<";
 %ignore "get_all_if";
+%ignore storage::Region::Region(const storage::Region::Impl&);
 
 %rename("==") "operator==";
 %rename("!=") "operator!=";
@@ -39,6 +40,7 @@
 #include "storage/Utils/Remote.h"
 #include "storage/FreeInfo.h"
 #include "storage/UsedFeatures.h"
+#include "storage/ProbeStatistics.h"
 
 #include "storage/Devices/Device.h"
 #include "storage/Filesystems/Mountable.h"
@@ -116,6 +118,7 @@
 %include "../../storage/Utils/Remote.h"
 %include "../../storage/FreeInfo.h"
 %include "../../storage/UsedFeatures.h"
+%include "../../storage/ProbeStatistics.h"
 
 %include "../../storage/Devices/Device.h"
 %include "../../storage/Filesystems/Mountable.h"
@@ -56,6 +56,13 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const {}
 
+	    /**
+	     * Whether the action modifies /etc/fstab, /etc/crypttab or
+	     * /etc/mdadm.conf via the CommitData. Such actions are never
+	     * committed in parallel.
+	     */
+	    virtual bool modifies_etc_files() const { return false; }
+
 	    /**
 	     * Returns a string representing some information, sid and some
 	     * flags, of the action.
@@ -122,6 +129,8 @@ namespace storage
 
 	    RenameIn(sid_t sid) : Modify(sid) {}
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	    virtual const BlkDevice* get_renamed_blk_device(const Actiongraph::Impl& actiongraph,
 							    Side side) const = 0;
 
@@ -21,6 +21,12 @@
  */
 
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <chrono>
 #include <boost/graph/copy.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/transitive_reduction.hpp>
@@ -28,11 +34,16 @@
 #include <boost/graph/graphviz.hpp>
 
 #include "storage/Utils/Stopwatch.h"
+#include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/LoggerImpl.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/PartitionTableImpl.h"
 #include "storage/Filesystems/BlkFilesystemImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
+#include "storage/Filesystems/BtrfsSubvolume.h"
+#include "storage/Filesystems/Btrfs.h"
+#include "storage/Filesystems/Xfs.h"
 #include "storage/Devicegraph.h"
 #include "storage/Utils/GraphUtils.h"
 #include "storage/Action.h"
@@ -504,14 +515,72 @@ namespace storage
 
 
     void
-    Actiongraph::Impl::commit(const CommitCallbacks* commit_callbacks) const
+    Actiongraph::Impl::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks) const
     {
 	CommitData commit_data(*this, Tense::PRESENT_CONTINUOUS);
 
+	if (commit_options.parallel_actions > 1)
+	    commit_parallel(commit_data, commit_callbacks, commit_options.parallel_actions);
+	else
+	    commit_sequential(commit_data, commit_callbacks);
+    }
+
+
+    bool
+    Actiongraph::Impl::keeps_tmp_mounts(const Action::Base* action) const
+    {
+	for (Side side : { RHS, LHS })
+	{
+	    const Devicegraph* devicegraph = get_devicegraph(side);
+	    if (devicegraph->device_exists(action->sid))
+		return is_btrfs_subvolume(devicegraph->find_device(action->sid));
+	}
+
+	return false;
+    }
+
+
+    bool
+    Actiongraph::Impl::uses_tmp_mounts(const Action::Base* action) const
+    {
+	// Actions on btrfs subvolumes and resizing btrfs and xfs need the
+	// filesystem mounted, see BtrfsSubvolume::Impl and do_resize() of
+	// Btrfs::Impl and Xfs::Impl.
+
+	for (Side side : { RHS, LHS })
+	{
+	    const Devicegraph* devicegraph = get_devicegraph(side);
+	    if (devicegraph->device_exists(action->sid))
+	    {
+		const Device* device = devicegraph->find_device(action->sid);
+
+		if (is_btrfs_subvolume(device))
+		    return true;
+
+		return dynamic_cast<const Action::Resize*>(action) && (is_btrfs(device) || is_xfs(device));
+	    }
+	}
+
+	return false;
+    }
+
+
+    void
+    Actiongraph::Impl::commit_sequential(CommitData& commit_data, const CommitCallbacks* commit_callbacks) const
+    {
+	// Consecutive actions on btrfs subvolumes share the temporary mount
+	// of the btrfs. Before any other action the temporary mounts are
+	// released since the action may need the filesystem unmounted.
+
+	Storage::Impl::MountSession mount_session(storage.get_impl());
+
 	for (const vertex_descriptor& vertex : order)
 	{
 	    const Action::Base* action = graph[vertex].get();
 
+	    if (!keeps_tmp_mounts(action))
+		storage.get_impl().release_tmp_mounts();
+
 	    Text text = action->text(commit_data);
 
 	    y2mil("Commit Action \"" << text.native << "\" [" << action->details() << "]");
@@ -541,6 +610,295 @@ namespace storage
     }
 
 
+    void
+    Actiongraph::Impl::commit_parallel(CommitData& commit_data, const CommitCallbacks* commit_callbacks,
+				       unsigned int parallel_actions) const
+    {
+	// The actions are committed by worker threads. All worker threads
+	// run with the mutex locked except while SystemCmd waits for a
+	// command. So the data structures of the library are never used
+	// concurrently while the external commands run in parallel.
+	//
+	// The commit callbacks and the logger are only called from the
+	// calling thread since they may be implemented in Ruby or Python,
+	// which do not allow calls from foreign threads. The calling thread
+	// schedules the actions, calls the commit callbacks and passes the
+	// log lines queued by the worker threads to the logger.
+	//
+	// Temporary mounts are handled like in commit_sequential(). Since
+	// the mount of a worker thread could be released by another one the
+	// actions using temporary mounts are started one after another.
+
+	enum class State { WAITING, QUEUED, RUNNING, FINISHED, DONE };
+
+	struct Entry
+	{
+	    Entry(vertex_descriptor vertex, size_t predecessors)
+		: vertex(vertex), predecessors(predecessors), state(State::WAITING), text(),
+		  exception(), what(), callback_allowed(false) {}
+
+	    vertex_descriptor vertex;
+	    size_t predecessors;
+	    State state;
+	    Text text;
+
+	    // exception thrown by the commit of the action, if the error
+	    // callback may decide to continue what holds the message
+	    std::exception_ptr exception;
+	    string what;
+	    bool callback_allowed;
+	};
+
+	// entries are in the order of the topological sort so picking the
+	// first ready entry keeps the commit close to the sequential one
+	vector<Entry> entries;
+	map<vertex_descriptor, size_t> indexes;
+
+	for (const vertex_descriptor& vertex : order)
+	{
+	    indexes[vertex] = entries.size();
+	    entries.emplace_back(vertex, boost::in_degree(vertex, graph));
+	}
+
+	Storage::Impl::MountSession mount_session(storage.get_impl());
+
+	LogQueue log_queue;
+	LogQueue::Redirect log_redirect(log_queue);
+
+	std::mutex mutex;
+	std::condition_variable condition;
+
+	std::deque<size_t> queue;
+	bool stop = false;
+
+	size_t done = 0;
+	size_t running = 0;
+	bool etc_files_busy = false;
+	bool tmp_mounts_busy = false;
+	std::exception_ptr exception;
+
+	// Returns the next action that can be started or entries.end().
+	// Actions modifying files in /etc and actions using temporary
+	// mounts are started one after another in the order of the
+	// topological sort.
+	auto next = [&]() {
+	    bool etc_files_pending = false;
+	    bool tmp_mounts_pending = false;
+
+	    for (vector<Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+	    {
+		if (it->state != State::WAITING)
+		    continue;
+
+		const Action::Base* action = graph[it->vertex].get();
+
+		bool modifies_etc_files = action->modifies_etc_files();
+		bool needs_tmp_mounts = uses_tmp_mounts(action);
+
+		if (it->predecessors == 0 && !(modifies_etc_files && (etc_files_busy || etc_files_pending)) &&
+		    !(needs_tmp_mounts && (tmp_mounts_busy || tmp_mounts_pending)))
+		    return it;
+
+		if (modifies_etc_files)
+		    etc_files_pending = true;
+
+		if (needs_tmp_mounts)
+		    tmp_mounts_pending = true;
+	    }
+
+	    return entries.end();
+	};
+
+	auto worker = [&]() {
+	    LogQueue::Redirect log_redirect(log_queue);
+
+	    std::unique_lock<std::mutex> lock(mutex);
+
+	    SystemCmd::UnlockWhileWaiting unlock_while_waiting(lock);
+
+	    while (true)
+	    {
+		condition.wait(lock, [&]() { return stop || !queue.empty(); });
+
+		if (queue.empty())
+		    break;
+
+		// the reference stays valid since entries is never modified
+		Entry& entry = entries[queue.front()];
+		queue.pop_front();
+
+		entry.state = State::RUNNING;
+
+		const Action::Base* action = graph[entry.vertex].get();
+
+		try
+		{
+		    if (!action->nop)
+			action->commit(commit_data);
+		}
+		catch (const Exception& e)
+		{
+		    ST_CAUGHT(e);
+
+		    entry.exception = std::current_exception();
+		    entry.what = e.what();
+		    entry.callback_allowed = true;
+		}
+		catch (...)
+		{
+		    entry.exception = std::current_exception();
+		}
+
+		entry.state = State::FINISHED;
+
+		condition.notify_all();
+	    }
+	};
+
+	// Calls a commit callback with the mutex unlocked so that the
+	// worker threads can proceed meanwhile.
+	auto call_unlocked = [&](std::unique_lock<std::mutex>& lock, std::function<void()> function) {
+	    lock.unlock();
+
+	    log_queue.flush();
+
+	    try
+	    {
+		function();
+	    }
+	    catch (...)
+	    {
+		if (!exception)
+		    exception = std::current_exception();
+	    }
+
+	    lock.lock();
+	};
+
+	y2mil("commit with " << parallel_actions << " parallel actions");
+
+	vector<std::thread> threads;
+	for (unsigned int i = 0; i < std::min<size_t>(parallel_actions, entries.size()); ++i)
+	    threads.emplace_back(worker);
+
+	{
+	    std::unique_lock<std::mutex> lock(mutex);
+
+	    while (true)
+	    {
+		// finish the actions committed by the worker threads
+
+		for (Entry& entry : entries)
+		{
+		    if (entry.state != State::FINISHED)
+			continue;
+
+		    entry.state = State::DONE;
+
+		    if (entry.exception)
+		    {
+			bool cont = false;
+
+			if (entry.callback_allowed && commit_callbacks && !exception)
+			{
+			    call_unlocked(lock, [&]() {
+				cont = commit_callbacks->error(entry.text.translated, entry.what);
+			    });
+			}
+
+			if (cont)
+			    y2mil("user decides to continue after error");
+			else if (!exception)
+			    exception = entry.exception;
+		    }
+
+		    ++done;
+		    --running;
+
+		    if (graph[entry.vertex]->modifies_etc_files())
+			etc_files_busy = false;
+
+		    if (uses_tmp_mounts(graph[entry.vertex].get()))
+			tmp_mounts_busy = false;
+
+		    for (vertex_descriptor successor : children(entry.vertex))
+			--entries[indexes[successor]].predecessors;
+		}
+
+		// start the actions that are ready
+
+		while (!exception && running < threads.size())
+		{
+		    vector<Entry>::iterator it = next();
+		    if (it == entries.end())
+			break;
+
+		    const Action::Base* action = graph[it->vertex].get();
+
+		    it->text = action->text(commit_data);
+
+		    y2mil("Commit Action \"" << it->text.native << "\" [" << action->details() << "]");
+
+		    if (commit_callbacks)
+		    {
+			call_unlocked(lock, [&]() {
+			    commit_callbacks->message(it->text.translated);
+			});
+
+			if (exception)
+			    break;
+		    }
+
+		    if (action->modifies_etc_files())
+			etc_files_busy = true;
+
+		    if (uses_tmp_mounts(action))
+			tmp_mounts_busy = true;
+
+		    if (!keeps_tmp_mounts(action))
+			storage.get_impl().release_tmp_mounts();
+
+		    it->state = State::QUEUED;
+		    ++running;
+
+		    queue.push_back(it - entries.begin());
+		    condition.notify_all();
+		}
+
+		if (done == entries.size() || (exception && running == 0))
+		    break;
+
+		// wait for a finished action, meanwhile pass the log lines of
+		// the worker threads to the logger from time to time
+
+		auto finished = [&]() {
+		    return any_of(entries.begin(), entries.end(), [](const Entry& entry) {
+			return entry.state == State::FINISHED;
+		    });
+		};
+
+		while (!condition.wait_for(lock, std::chrono::seconds(1), finished))
+		{
+		    lock.unlock();
+		    log_queue.flush();
+		    lock.lock();
+		}
+	    }
+
+	    stop = true;
+	    condition.notify_all();
+	}
+
+	for (std::thread& thread : threads)
+	    thread.join();
+
+	log_queue.flush();
+
+	if (exception)
+	    std::rethrow_exception(exception);
+    }
+
+
     void
     Actiongraph::Impl::generate_compound_actions(const Actiongraph* actiongraph)
     {
@@ -46,6 +46,7 @@ namespace storage
 
     class Devicegraph;
     class Storage;
+    class CommitOptions;
     class CommitCallbacks;
     class EtcFstab;
     class EtcCrypttab;
@@ -171,7 +172,7 @@ namespace storage
 	void print_order() const;
 
 	vector<const Action::Base*> get_commit_actions() const;
-	void commit(const CommitCallbacks* commit_callbacks) const;
+	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks) const;
 
 	void generate_compound_actions(const Actiongraph* actiongraph);
 	vector<const CompoundAction*> get_compound_actions() const;
@@ -189,6 +190,21 @@ namespace storage
 	void remove_only_syncs();
 	void calculate_order();
 
+	/**
+	 * Whether temporary mounts can be kept while the action is
+	 * committed, see Storage::Impl::MountSession.
+	 */
+	bool keeps_tmp_mounts(const Action::Base* action) const;
+
+	/**
+	 * Whether the action uses temporary mounts, see EnsureMounted.
+	 */
+	bool uses_tmp_mounts(const Action::Base* action) const;
+
+	void commit_sequential(CommitData& commit_data, const CommitCallbacks* commit_callbacks) const;
+	void commit_parallel(CommitData& commit_data, const CommitCallbacks* commit_callbacks,
+			     unsigned int parallel_actions) const;
+
 	const Storage& storage;
 
 	const Devicegraph* lhs;
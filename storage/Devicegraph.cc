@@ -151,6 +151,20 @@ namespace storage
     }
 
 
+    void
+    Devicegraph::load_binary(const string& filename)
+    {
+	get_impl().load_binary(this, filename);
+    }
+
+
+    void
+    Devicegraph::save_binary(const string& filename) const
+    {
+	get_impl().save_binary(filename);
+    }
+
+
     bool
     Devicegraph::empty() const
     {
@@ -257,6 +271,8 @@ namespace storage
 
 	    Device* d_out = g_out.get_impl().graph[v_out].get();
 	    d_out->get_impl().set_devicegraph_and_vertex(&g_out, v_out);
+
+	    g_out.get_impl().index_vertex(v_out);
 	}
 
 	void operator()(const Devicegraph::Impl::edge_descriptor& e_in,
@@ -266,6 +282,8 @@ namespace storage
 
 	    Holder* h_out = g_out.get_impl().graph[e_out].get();
 	    h_out->get_impl().set_devicegraph_and_edge(&g_out, e_out);
+
+	    g_out.get_impl().index_edge(e_out);
 	}
 
     private:
@@ -378,6 +396,8 @@ namespace storage
 	boost::copy_graph(get_impl().graph, dest.get_impl().graph,
 			  vertex_index_map(vertex_index_map_generator.get()).
 			  vertex_copy(copier).edge_copy(copier));
+
+	dest.get_impl().copy_ordinals(get_impl());
     }
 
 
@@ -172,6 +172,24 @@ namespace storage
 	 */
 	void save(const std::string& filename) const;
 
+	/**
+	 * Load the devicegraph from a file in the binary format written by
+	 * save_binary().
+	 *
+	 * @throw Exception
+	 */
+	void load_binary(const std::string& filename);
+
+	/**
+	 * Save the devicegraph in a compact binary format. Compared to the
+	 * xml format of save() it is smaller and faster to save and load
+	 * but not human readable. The format is versioned but files are not
+	 * meant to be exchanged between different versions of the library.
+	 *
+	 * @throw Exception
+	 */
+	void save_binary(const std::string& filename) const;
+
 	bool empty() const;
 
 	size_t num_devices() const;
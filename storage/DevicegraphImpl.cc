@@ -21,57 +21,60 @@
  */
 
 
+#include <string.h>
 #include <boost/graph/copy.hpp>
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/graph_utility.hpp>
+#include <boost/algorithm/string/join.hpp>
 
 #include "storage/DevicegraphImpl.h"
 #include "storage/Utils/GraphUtils.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
-#include "storage/Devices/Disk.h"
-#include "storage/Devices/Dasd.h"
-#include "storage/Devices/Multipath.h"
-#include "storage/Devices/DmRaid.h"
-#include "storage/Devices/Md.h"
-#include "storage/Devices/MdContainer.h"
-#include "storage/Devices/MdMember.h"
-#include "storage/Devices/Msdos.h"
-#include "storage/Devices/Gpt.h"
-#include "storage/Devices/DasdPt.h"
-#include "storage/Devices/Partition.h"
+#include "storage/Devices/DiskImpl.h"
+#include "storage/Devices/DasdImpl.h"
+#include "storage/Devices/MultipathImpl.h"
+#include "storage/Devices/DmRaidImpl.h"
+#include "storage/Devices/MdImpl.h"
+#include "storage/Devices/MdContainerImpl.h"
+#include "storage/Devices/MdMemberImpl.h"
+#include "storage/Devices/MsdosImpl.h"
+#include "storage/Devices/GptImpl.h"
+#include "storage/Devices/DasdPtImpl.h"
+#include "storage/Devices/PartitionImpl.h"
 #include "storage/Devices/PartitionTable.h"
-#include "storage/Devices/LvmPv.h"
-#include "storage/Devices/LvmVg.h"
-#include "storage/Devices/LvmLv.h"
-#include "storage/Devices/Encryption.h"
-#include "storage/Devices/Luks.h"
-#include "storage/Devices/Bcache.h"
-#include "storage/Devices/BcacheCset.h"
-#include "storage/Filesystems/Ext2.h"
-#include "storage/Filesystems/Ext3.h"
-#include "storage/Filesystems/Ext4.h"
-#include "storage/Filesystems/Ntfs.h"
-#include "storage/Filesystems/Vfat.h"
-#include "storage/Filesystems/Btrfs.h"
-#include "storage/Filesystems/BtrfsSubvolume.h"
-#include "storage/Filesystems/Reiserfs.h"
-#include "storage/Filesystems/Xfs.h"
-#include "storage/Filesystems/Swap.h"
-#include "storage/Filesystems/Iso9660.h"
-#include "storage/Filesystems/Udf.h"
-#include "storage/Filesystems/Nfs.h"
-#include "storage/Filesystems/MountPoint.h"
+#include "storage/Devices/LvmPvImpl.h"
+#include "storage/Devices/LvmVgImpl.h"
+#include "storage/Devices/LvmLvImpl.h"
+#include "storage/Devices/EncryptionImpl.h"
+#include "storage/Devices/LuksImpl.h"
+#include "storage/Devices/BcacheImpl.h"
+#include "storage/Devices/BcacheCsetImpl.h"
+#include "storage/Filesystems/Ext2Impl.h"
+#include "storage/Filesystems/Ext3Impl.h"
+#include "storage/Filesystems/Ext4Impl.h"
+#include "storage/Filesystems/NtfsImpl.h"
+#include "storage/Filesystems/VfatImpl.h"
+#include "storage/Filesystems/BtrfsImpl.h"
+#include "storage/Filesystems/BtrfsSubvolumeImpl.h"
+#include "storage/Filesystems/ReiserfsImpl.h"
+#include "storage/Filesystems/XfsImpl.h"
+#include "storage/Filesystems/SwapImpl.h"
+#include "storage/Filesystems/Iso9660Impl.h"
+#include "storage/Filesystems/UdfImpl.h"
+#include "storage/Filesystems/NfsImpl.h"
+#include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Holders/HolderImpl.h"
-#include "storage/Holders/User.h"
-#include "storage/Holders/MdUser.h"
-#include "storage/Holders/FilesystemUser.h"
-#include "storage/Holders/Subdevice.h"
-#include "storage/Holders/MdSubdevice.h"
+#include "storage/Holders/UserImpl.h"
+#include "storage/Holders/MdUserImpl.h"
+#include "storage/Holders/FilesystemUserImpl.h"
+#include "storage/Holders/SubdeviceImpl.h"
+#include "storage/Holders/MdSubdeviceImpl.h"
 #include "storage/Storage.h"
 #include "storage/FreeInfo.h"
 
@@ -214,6 +217,14 @@ namespace storage
 		if (holder->get_impl().get_edge() != edge)
 		    ST_THROW(LogicException("wrong edge in back references"));
 	    }
+
+	    // check sid indexes
+
+	    if (vertex_index.size() != num_devices() || edge_index.size() != num_holders())
+		ST_THROW(LogicException("sid indexes out of sync"));
+
+	    if (ordinals.size() != num_devices())
+		ST_THROW(LogicException("type buckets out of sync"));
 	}
 
 	{
@@ -312,7 +323,11 @@ namespace storage
     Devicegraph::Impl::vertex_descriptor
     Devicegraph::Impl::add_vertex(Device* device)
     {
-	return boost::add_vertex(shared_ptr<Device>(device), graph);
+	vertex_descriptor vertex = boost::add_vertex(shared_ptr<Device>(device), graph);
+
+	index_vertex(vertex);
+
+	return vertex;
     }
 
 
@@ -327,6 +342,8 @@ namespace storage
 	    ST_THROW(HolderAlreadyExists(graph[source_vertex]->get_sid(),
 					 graph[target_vertex]->get_sid()));
 
+	index_edge(tmp.first);
+
 	// TODO should also set devicegraph and edge in holder but the
 	// devicegraph is not available here
 
@@ -334,6 +351,34 @@ namespace storage
     }
 
 
+    void
+    Devicegraph::Impl::index_vertex(vertex_descriptor vertex)
+    {
+	modified();
+
+	vertex_index[graph[vertex]->get_sid()] = vertex;
+
+	size_t ordinal = next_ordinal++;
+	ordinals[vertex] = ordinal;
+	type_buckets[graph[vertex]->get_impl().get_classname()][ordinal] = vertex;
+
+	index_keys_t keys;
+	graph[vertex]->get_impl().get_index_keys(keys);
+
+	for (const pair<IndexType, string>& key : keys)
+	    get_key_index(key.first).emplace(key.second, vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::index_edge(edge_descriptor edge)
+    {
+	modified();
+
+	edge_index[make_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid())] = edge;
+    }
+
+
     set<sid_t>
     Devicegraph::Impl::get_device_sids() const
     {
@@ -357,54 +402,96 @@ namespace storage
     bool
     Devicegraph::Impl::device_exists(sid_t sid) const
     {
-	for (vertex_descriptor vertex : vertices())
-	{
-	    if (graph[vertex]->get_sid() == sid)
-		return true;
-	}
-
-	return false;
+	return vertex_index.find(sid) != vertex_index.end();
     }
 
 
     bool
     Devicegraph::Impl::holder_exists(sid_t source_sid, sid_t target_sid) const
     {
-	for (edge_descriptor edge : edges())
-	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return true;
-	}
-
-	return false;
+	return edge_index.find(make_pair(source_sid, target_sid)) != edge_index.end();
     }
 
 
     Devicegraph::Impl::vertex_descriptor
     Devicegraph::Impl::find_vertex(sid_t sid) const
     {
-	for (vertex_descriptor vertex : vertices())
-	{
-	    if (graph[vertex]->get_sid() == sid)
-		return vertex;
-	}
+	vertex_index_t::const_iterator it = vertex_index.find(sid);
+	if (it == vertex_index.end())
+	    ST_THROW(DeviceNotFoundBySid(sid));
 
-	ST_THROW(DeviceNotFoundBySid(sid));
-     }
+	return it->second;
+    }
 
 
     Devicegraph::Impl::edge_descriptor
     Devicegraph::Impl::find_edge(sid_t source_sid, sid_t target_sid) const
     {
-	for (edge_descriptor edge : edges())
+	edge_index_t::const_iterator it = edge_index.find(make_pair(source_sid, target_sid));
+	if (it == edge_index.end())
+	    ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+
+	return it->second;
+    }
+
+
+    Devicegraph::Impl::key_index_t&
+    Devicegraph::Impl::get_key_index(IndexType index_type)
+    {
+	switch (index_type)
 	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return edge;
+	    case IndexType::NAME:
+		return name_index;
+
+	    case IndexType::UUID:
+		return uuid_index;
+
+	    case IndexType::VG_NAME:
+		return vg_name_index;
 	}
 
-	ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+	ST_THROW(LogicException("unknown index type"));
+    }
+
+
+    const Devicegraph::Impl::key_index_t&
+    Devicegraph::Impl::get_key_index(IndexType index_type) const
+    {
+	return const_cast<Devicegraph::Impl*>(this)->get_key_index(index_type);
+    }
+
+
+    boost::iterator_range<Devicegraph::Impl::key_index_t::const_iterator>
+    Devicegraph::Impl::find_vertices(IndexType index_type, const string& key) const
+    {
+	return boost::make_iterator_range(get_key_index(index_type).equal_range(key));
+    }
+
+
+    void
+    Devicegraph::Impl::remove_index_key(IndexType index_type, const string& key,
+					vertex_descriptor vertex)
+    {
+	key_index_t& key_index = get_key_index(index_type);
+
+	pair<key_index_t::iterator, key_index_t::iterator> range = key_index.equal_range(key);
+	for (key_index_t::iterator it = range.first; it != range.second; ++it)
+	{
+	    if (it->second == vertex)
+	    {
+		key_index.erase(it);
+		return;
+	    }
+	}
+    }
+
+
+    void
+    Devicegraph::Impl::update_index_key(IndexType index_type, const string& old_key,
+					const string& new_key, vertex_descriptor vertex)
+    {
+	remove_index_key(index_type, old_key, vertex);
+	get_key_index(index_type).emplace(new_key, vertex);
     }
 
 
@@ -430,13 +517,51 @@ namespace storage
     void
     Devicegraph::Impl::clear()
     {
+	modified();
+
 	graph.clear();
+
+	vertex_index.clear();
+	edge_index.clear();
+
+	name_index.clear();
+	uuid_index.clear();
+	vg_name_index.clear();
+
+	type_buckets.clear();
+	ordinals.clear();
     }
 
 
     void
     Devicegraph::Impl::remove_vertex(vertex_descriptor vertex)
     {
+	modified();
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	    edge_index.erase(make_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid()));
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	    edge_index.erase(make_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid()));
+
+	vertex_index.erase(graph[vertex]->get_sid());
+
+	std::map<string, bucket_t>::iterator it = type_buckets.find(graph[vertex]->get_impl().get_classname());
+	if (it != type_buckets.end())
+	{
+	    it->second.erase(ordinals[vertex]);
+	    if (it->second.empty())
+		type_buckets.erase(it);
+	}
+
+	ordinals.erase(vertex);
+
+	index_keys_t keys;
+	graph[vertex]->get_impl().get_index_keys(keys);
+
+	for (const pair<IndexType, string>& key : keys)
+	    remove_index_key(key.first, key.second, vertex);
+
 	boost::clear_vertex(vertex, graph);
 	boost::remove_vertex(vertex, graph);
     }
@@ -445,6 +570,10 @@ namespace storage
     void
     Devicegraph::Impl::remove_edge(edge_descriptor edge)
     {
+	modified();
+
+	edge_index.erase(make_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid()));
+
 	boost::remove_edge(edge, graph);
     }
 
@@ -453,6 +582,211 @@ namespace storage
     Devicegraph::Impl::swap(Devicegraph::Impl& x)
     {
 	graph.swap(x.graph);
+
+	vertex_index.swap(x.vertex_index);
+	edge_index.swap(x.edge_index);
+
+	name_index.swap(x.name_index);
+	uuid_index.swap(x.uuid_index);
+	vg_name_index.swap(x.vg_name_index);
+
+	type_buckets.swap(x.type_buckets);
+	ordinals.swap(x.ordinals);
+	std::swap(next_ordinal, x.next_ordinal);
+
+	// The generation moves with the content since the devices keep the
+	// generation of their devicegraph in caches. Bumping it afterwards
+	// makes these caches invalid in both devicegraphs.
+
+	std::swap(generation, x.generation);
+	modified();
+	x.modified();
+    }
+
+
+    namespace
+    {
+
+	string
+	identity(const Devicegraph::Impl& impl, Devicegraph::Impl::vertex_descriptor vertex,
+		 map<Devicegraph::Impl::vertex_descriptor, string>& identities)
+	{
+	    map<Devicegraph::Impl::vertex_descriptor, string>::const_iterator it = identities.find(vertex);
+	    if (it != identities.end())
+		return it->second;
+
+	    const Device* device = impl[vertex];
+
+	    string ret = string(device->get_impl().get_classname()) + ":" + device->get_displayname();
+
+	    if (!is_blk_device(device) && !is_lvm_vg(device) && !is_bcache_cset(device) && !is_nfs(device))
+	    {
+		vector<string> tmp;
+		for (Devicegraph::Impl::vertex_descriptor parent : impl.parents(vertex))
+		    tmp.push_back(identity(impl, parent, identities));
+
+		sort(tmp.begin(), tmp.end());
+
+		ret += "(" + boost::join(tmp, ",") + ")";
+	    }
+
+	    identities[vertex] = ret;
+
+	    return ret;
+	}
+
+
+	map<string, Devicegraph::Impl::vertex_descriptor>
+	unique_identities(const Devicegraph::Impl& impl)
+	{
+	    map<Devicegraph::Impl::vertex_descriptor, string> identities;
+
+	    map<string, Devicegraph::Impl::vertex_descriptor> ret;
+	    set<string> duplicates;
+
+	    for (Devicegraph::Impl::vertex_descriptor vertex : impl.vertices())
+	    {
+		string tmp = identity(impl, vertex, identities);
+		if (!ret.emplace(tmp, vertex).second)
+		    duplicates.insert(tmp);
+	    }
+
+	    for (const string& duplicate : duplicates)
+		ret.erase(duplicate);
+
+	    return ret;
+	}
+
+    }
+
+
+    void
+    Devicegraph::Impl::adopt_sids(const Devicegraph::Impl& rhs)
+    {
+	const map<string, vertex_descriptor> lhs_identities = unique_identities(*this);
+	const map<string, vertex_descriptor> rhs_identities = unique_identities(rhs);
+
+	for (const map<string, vertex_descriptor>::value_type& value : lhs_identities)
+	{
+	    map<string, vertex_descriptor>::const_iterator it = rhs_identities.find(value.first);
+	    if (it != rhs_identities.end())
+		graph[value.second]->get_impl().set_sid(rhs[it->second]->get_sid());
+	}
+
+	// All other sids are new and thus different from the sids of rhs.
+
+	vertex_index.clear();
+	for (vertex_descriptor vertex : vertices())
+	    vertex_index[graph[vertex]->get_sid()] = vertex;
+
+	edge_index.clear();
+	for (edge_descriptor edge : edges())
+	    index_edge(edge);
+    }
+
+
+    void
+    Devicegraph::Impl::update(Devicegraph* devicegraph, const Devicegraph::Impl& rhs)
+    {
+	// remove devices that are gone, removing a device also removes its
+	// holders, and replace changed devices in place so that they keep
+	// their vertex
+
+	const vector<vertex_descriptor> old_vertices(vertices().begin(), vertices().end());
+
+	for (vertex_descriptor vertex : old_vertices)
+	{
+	    vertex_index_t::const_iterator it = rhs.vertex_index.find(graph[vertex]->get_sid());
+	    if (it == rhs.vertex_index.end())
+	    {
+		remove_vertex(vertex);
+		continue;
+	    }
+
+	    const Device* rhs_device = rhs.graph[it->second].get();
+	    if (*graph[vertex] == *rhs_device)
+		continue;
+
+	    if (string(graph[vertex]->get_impl().get_classname()) != rhs_device->get_impl().get_classname())
+	    {
+		remove_vertex(vertex);
+		continue;
+	    }
+
+	    modified();
+
+	    index_keys_t keys;
+	    graph[vertex]->get_impl().get_index_keys(keys);
+
+	    for (const pair<IndexType, string>& key : keys)
+		remove_index_key(key.first, key.second, vertex);
+
+	    graph[vertex] = shared_ptr<Device>(rhs_device->clone());
+	    graph[vertex]->get_impl().set_devicegraph_and_vertex(devicegraph, vertex);
+
+	    keys.clear();
+	    graph[vertex]->get_impl().get_index_keys(keys);
+
+	    for (const pair<IndexType, string>& key : keys)
+		get_key_index(key.first).emplace(key.second, vertex);
+	}
+
+	const vector<edge_descriptor> old_edges(edges().begin(), edges().end());
+
+	for (edge_descriptor edge : old_edges)
+	{
+	    edge_index_t::const_iterator it = rhs.edge_index.find(make_pair(graph[source(edge)]->get_sid(),
+									     graph[target(edge)]->get_sid()));
+	    if (it == rhs.edge_index.end() || *graph[edge] != *rhs.graph[it->second])
+		remove_edge(edge);
+	}
+
+	// copy the new or changed devices and holders from rhs
+
+	for (vertex_descriptor rhs_vertex : rhs.vertices())
+	{
+	    if (vertex_index.find(rhs.graph[rhs_vertex]->get_sid()) != vertex_index.end())
+		continue;
+
+	    vertex_descriptor vertex = boost::add_vertex(shared_ptr<Device>(rhs.graph[rhs_vertex]->clone()), graph);
+	    graph[vertex]->get_impl().set_devicegraph_and_vertex(devicegraph, vertex);
+	    index_vertex(vertex);
+	}
+
+	for (edge_descriptor rhs_edge : rhs.edges())
+	{
+	    pair<sid_t, sid_t> sids = make_pair(rhs.graph[rhs.source(rhs_edge)]->get_sid(),
+						rhs.graph[rhs.target(rhs_edge)]->get_sid());
+	    if (edge_index.find(sids) != edge_index.end())
+		continue;
+
+	    edge_descriptor edge = boost::add_edge(find_vertex(sids.first), find_vertex(sids.second),
+						   shared_ptr<Holder>(rhs.graph[rhs_edge]->clone()), graph).first;
+	    graph[edge]->get_impl().set_devicegraph_and_edge(devicegraph, edge);
+	    index_edge(edge);
+	}
+
+	// new devices were added at the end, restore the order of rhs
+
+	copy_ordinals(rhs);
+    }
+
+
+    void
+    Devicegraph::Impl::copy_ordinals(const Devicegraph::Impl& rhs)
+    {
+	type_buckets.clear();
+	ordinals.clear();
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    size_t ordinal = rhs.get_ordinal(rhs.find_vertex(graph[vertex]->get_sid()));
+
+	    ordinals[vertex] = ordinal;
+	    type_buckets[graph[vertex]->get_impl().get_classname()][ordinal] = vertex;
+	}
+
+	next_ordinal = rhs.next_ordinal;
     }
 
 
@@ -651,53 +985,118 @@ namespace storage
     }
 
 
-    typedef std::function<Device* (Devicegraph* devicegraph, const xmlNode* node)> device_load_fnc;
-
-    const map<string, device_load_fnc> device_load_registry = {
-	{ "Disk", &Disk::load },
-	{ "Dasd", &Dasd::load },
-	{ "Multipath", &Multipath::load },
-	{ "DmRaid", &DmRaid::load },
-	{ "Md", &Md::load },
-	{ "MdContainer", &MdContainer::load },
-	{ "MdMember", &MdMember::load },
-	{ "Msdos", &Msdos::load },
-	{ "Gpt", &Gpt::load },
-	{ "DasdPt", &DasdPt::load },
-	{ "Partition", &Partition::load },
-	{ "LvmPv", &LvmPv::load },
-	{ "LvmVg", &LvmVg::load },
-	{ "LvmLv", &LvmLv::load },
-	{ "Encryption", &Encryption::load },
-	{ "Luks", &Luks::load },
-	{ "Bcache", &Bcache::load },
-	{ "BcacheCset", &BcacheCset::load },
-	{ "Ext2", &Ext2::load },
-	{ "Ext3", &Ext3::load },
-	{ "Ext4", &Ext4::load },
-	{ "Ntfs", &Ntfs::load },
-	{ "Vfat", &Vfat::load },
-	{ "Btrfs", &Btrfs::load },
-	{ "BtrfsSubvolume", &BtrfsSubvolume::load },
-	{ "Reiserfs", &Reiserfs::load },
-	{ "Xfs", &Xfs::load },
-	{ "Swap", &Swap::load },
-	{ "Iso9660", &Iso9660::load },
-	{ "Udf", &Udf::load },
-	{ "Nfs", &Nfs::load },
-	{ "MountPoint", &MountPoint::load }
-    };
-
-
-    typedef std::function<Holder* (Devicegraph* devicegraph, const xmlNode* node)> holder_load_fnc;
-
-    const map<string, holder_load_fnc> holder_load_registry = {
-	{ "User", &User::load },
-	{ "MdUser", &MdUser::load },
-	{ "FilesystemUser", &FilesystemUser::load },
-	{ "Subdevice", &Subdevice::load },
-	{ "MdSubdevice", &MdSubdevice::load }
-    };
+    namespace
+    {
+
+	/**
+	 * FNV-1a hash of a class name. Used to dispatch on class names in a
+	 * switch statement. A collision between two known class names is
+	 * detected by the compiler as duplicate case value.
+	 */
+	constexpr uint32_t
+	classname_hash(const char* classname, uint32_t hash = 2166136261u)
+	{
+	    return *classname ? classname_hash(classname + 1, (hash ^ (unsigned char)(*classname)) *
+					       16777619u) : hash;
+	}
+
+
+	/**
+	 * Calls the load function of a device or holder class matching the
+	 * arguments: the xml node or the binary reader (and for holders the
+	 * source and target device).
+	 */
+	template <typename Class>
+	struct Loader
+	{
+	    static Class* load(Devicegraph* devicegraph, const xmlNode* node)
+	    {
+		return Class::load(devicegraph, node);
+	    }
+
+	    static Class* load(Devicegraph* devicegraph, BinaryReader& reader)
+	    {
+		return Class::Impl::load(devicegraph, reader);
+	    }
+
+	    static Class* load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+			       const Device* target)
+	    {
+		return Class::Impl::load(devicegraph, reader, source, target);
+	    }
+	};
+
+
+#define ST_LOAD_CASE(Class) \
+	case classname_hash(#Class): \
+	    if (strcmp(classname, #Class) == 0) \
+		return Loader<Class>::load(devicegraph, args...); \
+	    break
+
+
+	template <typename... Args>
+	Device*
+	load_device(Devicegraph* devicegraph, const char* classname, Args&&... args)
+	{
+	    switch (classname_hash(classname))
+	    {
+	    ST_LOAD_CASE(Disk);
+	    ST_LOAD_CASE(Dasd);
+	    ST_LOAD_CASE(Multipath);
+	    ST_LOAD_CASE(DmRaid);
+	    ST_LOAD_CASE(Md);
+	    ST_LOAD_CASE(MdContainer);
+	    ST_LOAD_CASE(MdMember);
+	    ST_LOAD_CASE(Msdos);
+	    ST_LOAD_CASE(Gpt);
+	    ST_LOAD_CASE(DasdPt);
+	    ST_LOAD_CASE(Partition);
+	    ST_LOAD_CASE(LvmPv);
+	    ST_LOAD_CASE(LvmVg);
+	    ST_LOAD_CASE(LvmLv);
+	    ST_LOAD_CASE(Encryption);
+	    ST_LOAD_CASE(Luks);
+	    ST_LOAD_CASE(Bcache);
+	    ST_LOAD_CASE(BcacheCset);
+	    ST_LOAD_CASE(Ext2);
+	    ST_LOAD_CASE(Ext3);
+	    ST_LOAD_CASE(Ext4);
+	    ST_LOAD_CASE(Ntfs);
+	    ST_LOAD_CASE(Vfat);
+	    ST_LOAD_CASE(Btrfs);
+	    ST_LOAD_CASE(BtrfsSubvolume);
+	    ST_LOAD_CASE(Reiserfs);
+	    ST_LOAD_CASE(Xfs);
+	    ST_LOAD_CASE(Swap);
+	    ST_LOAD_CASE(Iso9660);
+	    ST_LOAD_CASE(Udf);
+	    ST_LOAD_CASE(Nfs);
+	    ST_LOAD_CASE(MountPoint);
+	    }
+
+	    ST_THROW(Exception(sformat("unknown device class name %s", classname)));
+	}
+
+
+	template <typename... Args>
+	Holder*
+	load_holder(Devicegraph* devicegraph, const char* classname, Args&&... args)
+	{
+	    switch (classname_hash(classname))
+	    {
+	    ST_LOAD_CASE(User);
+	    ST_LOAD_CASE(MdUser);
+	    ST_LOAD_CASE(FilesystemUser);
+	    ST_LOAD_CASE(Subdevice);
+	    ST_LOAD_CASE(MdSubdevice);
+	    }
+
+	    ST_THROW(Exception(sformat("unknown holder class name %s", classname)));
+	}
+
+#undef ST_LOAD_CASE
+
+    }
 
 
     void
@@ -708,44 +1107,65 @@ namespace storage
 
 	clear();
 
-	XmlFile xml(filename);
+	// The file is read with a streaming reader and only the subtree of the
+	// current device or holder is expanded, so memory usage does not grow
+	// with the size of the devicegraph. Like in save() the Devices element
+	// must come before the Holders element.
+
+	XmlReader reader(filename);
 
-	const xmlNode* root_node = xml.getRootElement();
-	if (!root_node)
-	    ST_THROW(Exception("root node not found"));
+	bool more = reader.read();
+	while (more && !reader.is_element())
+	    more = reader.read();
 
-	const xmlNode* devicegraph_node = getChildNode(root_node, "Devicegraph");
-	if (!devicegraph_node)
+	if (!more || strcmp(reader.name(), "Devicegraph") != 0)
 	    ST_THROW(Exception("Devicegraph node not found"));
 
-	const xmlNode* devices_node = getChildNode(devicegraph_node, "Devices");
-	if (devices_node)
+	enum { NONE, DEVICES, HOLDERS } section = NONE;
+
+	more = reader.read();
+	while (more)
 	{
-	    for (const xmlNode* device_node : getChildNodes(devices_node))
+	    if (!reader.is_element())
 	    {
-		const string& classname = (const char*) device_node->parent->name;
+		more = reader.read();
+		continue;
+	    }
 
-		map<string, device_load_fnc>::const_iterator it = device_load_registry.find(classname);
-		if (it == device_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown device class name %s", classname.c_str())));
+	    if (reader.depth() == 1)
+	    {
+		if (strcmp(reader.name(), "Devices") == 0)
+		    section = DEVICES;
+		else if (strcmp(reader.name(), "Holders") == 0)
+		    section = HOLDERS;
+		else
+		    section = NONE;
 
-		const Device* device = it->second(devicegraph, device_node);
-		Device::Impl::raise_global_sid(device->get_sid());
+		more = reader.read();
 	    }
-	}
-
-	const xmlNode* holders_node = getChildNode(devicegraph_node, "Holders");
-	if (holders_node)
-	{
-	    for (const xmlNode* holder_node : getChildNodes(holders_node))
+	    else if (reader.depth() == 2 && section != NONE)
 	    {
-		const string& classname = (const char*) holder_node->parent->name;
+		const xmlNode* node = reader.expand()->children;
+		if (node)
+		{
+		    const char* classname = (const char*) node->parent->name;
 
-		map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(classname);
-		if (it == holder_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown holder class name %s", classname.c_str())));
+		    if (section == DEVICES)
+		    {
+			const Device* device = load_device(devicegraph, classname, node);
+			Device::Impl::raise_global_sid(device->get_sid());
+		    }
+		    else
+		    {
+			load_holder(devicegraph, classname, node);
+		    }
+		}
 
-		it->second(devicegraph, holder_node);
+		more = reader.next();
+	    }
+	    else
+	    {
+		more = reader.next();
 	    }
 	}
     }
@@ -784,6 +1204,72 @@ namespace storage
     }
 
 
+    void
+    Devicegraph::Impl::load_binary(Devicegraph* devicegraph, const string& filename)
+    {
+	if (&devicegraph->get_impl() != this)
+	    ST_THROW(LogicException("wrong impl-ptr"));
+
+	clear();
+
+	BinaryReader reader(filename);
+
+	uint32_t num_devices = reader.get_u32();
+	for (uint32_t i = 0; i < num_devices; ++i)
+	{
+	    const string& classname = reader.get_string();
+
+	    const Device* device = load_device(devicegraph, classname.c_str(), reader);
+	    Device::Impl::raise_global_sid(device->get_sid());
+	}
+
+	uint32_t num_holders = reader.get_u32();
+	for (uint32_t i = 0; i < num_holders; ++i)
+	{
+	    const string& classname = reader.get_string();
+
+	    const Device* source = devicegraph->find_device(reader.get_u32());
+	    const Device* target = devicegraph->find_device(reader.get_u32());
+
+	    load_holder(devicegraph, classname.c_str(), reader, source, target);
+	}
+
+	if (!reader.at_end())
+	    reader.error("trailing data");
+    }
+
+
+    void
+    Devicegraph::Impl::save_binary(const string& filename) const
+    {
+	BinaryWriter writer;
+
+	writer.put_u32(num_devices());
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    const Device* device = graph[vertex].get();
+
+	    writer.put_string(device->get_impl().get_classname());
+	    device->get_impl().save(writer);
+	}
+
+	writer.put_u32(num_holders());
+
+	for (edge_descriptor edge : edges())
+	{
+	    const Holder* holder = graph[edge].get();
+
+	    writer.put_string(holder->get_impl().get_classname());
+	    writer.put_u32(holder->get_source_sid());
+	    writer.put_u32(holder->get_target_sid());
+	    holder->get_impl().save(writer);
+	}
+
+	writer.save(filename);
+    }
+
+
     void
     Devicegraph::Impl::print(std::ostream& out) const
     {
@@ -26,7 +26,12 @@
 
 
 #include <set>
+#include <map>
+#include <unordered_map>
+#include <queue>
+#include <algorithm>
 #include <boost/noncopyable.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
 #include "storage/Devices/Device.h"
@@ -75,6 +80,16 @@ namespace storage
 
 	typedef graph_t::vertices_size_type vertices_size_type;
 
+	/**
+	 * Secondary indexes to find devices by keys other than the sid. The
+	 * keys of a device are reported by Device::Impl::get_index_keys().
+	 */
+	enum class IndexType { NAME, UUID, VG_NAME };
+
+	typedef vector<pair<IndexType, string>> index_keys_t;
+
+	typedef std::unordered_multimap<string, vertex_descriptor> key_index_t;
+
 	Impl(const Storage* storage) : storage(storage) {}
 
 	bool operator==(const Impl& rhs) const;
@@ -114,6 +129,25 @@ namespace storage
 	vertex_descriptor find_vertex(sid_t sid) const;
 	edge_descriptor find_edge(sid_t source_sid, sid_t target_sid) const;
 
+	/**
+	 * Returns the candidate vertices for key in the index. The caller must
+	 * still check the type and key of the devices.
+	 */
+	boost::iterator_range<key_index_t::const_iterator> find_vertices(IndexType index_type,
+									 const string& key) const;
+
+	/**
+	 * Returns the ordinal of the vertex. The order of ordinals is the
+	 * order of get_devices_of_type().
+	 */
+	size_t get_ordinal(vertex_descriptor vertex) const { return ordinals.at(vertex); }
+
+	/**
+	 * Updates the index after a key of the device at vertex changed.
+	 */
+	void update_index_key(IndexType index_type, const string& old_key, const string& new_key,
+			      vertex_descriptor vertex);
+
 	vertex_descriptor source(edge_descriptor edge) const { return boost::source(edge, graph); }
 	vertex_descriptor target(edge_descriptor edge) const { return boost::target(edge, graph); }
 
@@ -136,6 +170,9 @@ namespace storage
 	void load(Devicegraph* devicegraph, const string& filename);
 	void save(const string& filename) const;
 
+	void load_binary(Devicegraph* devicegraph, const string& filename);
+	void save_binary(const string& filename) const;
+
 	void print(std::ostream& out) const;
 
 	void write_graphviz(const string& filename, GraphvizFlags graphviz_flags) const;
@@ -171,12 +208,8 @@ namespace storage
 	{
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
-	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device)
-		    ret.push_back(device);
-	    }
+	    for (vertex_descriptor vertex : vertices_of_type<Type>())
+		ret.push_back(static_cast<Type*>(graph[vertex].get()));
 
 	    return ret;
 	}
@@ -200,10 +233,10 @@ namespace storage
 	{
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
+	    for (vertex_descriptor vertex : vertices_of_type<Type>())
 	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device && pred(device))
+		Type* device = static_cast<Type*>(graph[vertex].get());
+		if (pred(device))
 		    ret.push_back(device);
 	    }
 
@@ -317,14 +350,154 @@ namespace storage
 
 	void swap(Devicegraph::Impl& x);
 
+	/**
+	 * Gives the devices that also exist in rhs the sid they have in
+	 * rhs. Devices are identified by their classname and displayname
+	 * and, except for block devices, LVM VGs, bcache csets and NFS, by
+	 * their parents. Devices not unique in both devicegraphs keep their
+	 * sid. Used by the incremental reprobe so that unchanged devices keep
+	 * their sids.
+	 */
+	void adopt_sids(const Devicegraph::Impl& rhs);
+
+	/**
+	 * Updates the devicegraph in place so that it equals rhs. Devices
+	 * and holders that exist in both devicegraphs with the same sid and
+	 * are equal are kept, so pointers to them stay valid. Changed
+	 * devices are replaced in place, all others are removed or copied
+	 * from rhs. Afterwards the devices have the order of rhs. The
+	 * devicegraph must be the one owning this Impl. Used by the
+	 * incremental reprobe.
+	 */
+	void update(Devicegraph* devicegraph, const Devicegraph::Impl& rhs);
+
+	/**
+	 * Takes the ordinals of the devices from rhs, so that
+	 * get_devices_of_type() returns the devices in the order of
+	 * rhs. Both devicegraphs must have devices with the same sids.
+	 */
+	void copy_ordinals(const Devicegraph::Impl& rhs);
+
 	const Storage* get_storage() const { return storage; }
 
+	/**
+	 * Adds the vertex and edge to the sid indexes. Only needed if the
+	 * graph was modified directly, e.g. by boost::copy_graph.
+	 */
+	void index_vertex(vertex_descriptor vertex);
+	void index_edge(edge_descriptor edge);
+
+	/**
+	 * Counter increased by every modification of the graph and by
+	 * changes of devices that can invalidate data derived from the
+	 * devicegraph, e.g. the slot index of partition tables. Devices
+	 * report such changes with modified().
+	 */
+	unsigned long long get_generation() const { return generation; }
+	void modified() { ++generation; }
+
 	graph_t graph;		// TODO private?
 
     private:
 
 	const Storage* storage;
 
+	unsigned long long generation = 0;
+
+	// Indexes for fast lookup of vertices and edges by sids. Must be kept
+	// in sync with the graph.
+
+	typedef std::unordered_map<sid_t, vertex_descriptor> vertex_index_t;
+	typedef std::unordered_map<pair<sid_t, sid_t>, edge_descriptor,
+				   boost::hash<pair<sid_t, sid_t>>> edge_index_t;
+
+	vertex_index_t vertex_index;
+	edge_index_t edge_index;
+
+	// The vertices bucketed by the classname of the device. Within a
+	// bucket the vertices are sorted by their ordinal. Ordinals are
+	// given in insertion order, so the order of vertices(), unless
+	// copied from another devicegraph with copy_ordinals().
+
+	typedef std::map<size_t, vertex_descriptor> bucket_t;
+
+	std::map<string, bucket_t> type_buckets;
+	std::unordered_map<vertex_descriptor, size_t> ordinals;
+	size_t next_ordinal = 0;
+
+	/**
+	 * Returns the vertices of all devices of Type in the order of
+	 * vertices(). Instead of a dynamic_cast for every vertex only one
+	 * device of every bucket has to be checked.
+	 */
+	template<typename Type>
+	vector<vertex_descriptor>
+	vertices_of_type() const
+	{
+	    vector<const bucket_t*> matches;
+
+	    for (const std::map<string, bucket_t>::value_type& bucket : type_buckets)
+	    {
+		const Device* device = graph[bucket.second.begin()->second].get();
+		if (dynamic_cast<const Type*>(device))
+		    matches.push_back(&bucket.second);
+	    }
+
+	    vector<vertex_descriptor> ret;
+
+	    if (matches.size() == 1)
+	    {
+		ret.reserve(matches.front()->size());
+		for (const bucket_t::value_type& value : *matches.front())
+		    ret.push_back(value.second);
+	    }
+	    else if (matches.size() > 1)
+	    {
+		// The buckets are already sorted by ordinal so a k-way merge
+		// is enough.
+
+		typedef pair<bucket_t::const_iterator, bucket_t::const_iterator> range_t;
+
+		auto greater = [](const range_t& lhs, const range_t& rhs) {
+		    return lhs.first->first > rhs.first->first;
+		};
+
+		std::priority_queue<range_t, vector<range_t>, decltype(greater)> queue(greater);
+
+		size_t size = 0;
+
+		for (const bucket_t* match : matches)
+		{
+		    queue.emplace(match->begin(), match->end());
+		    size += match->size();
+		}
+
+		ret.reserve(size);
+
+		while (!queue.empty())
+		{
+		    range_t range = queue.top();
+		    queue.pop();
+
+		    ret.push_back(range.first->second);
+
+		    if (++range.first != range.second)
+			queue.push(range);
+		}
+	    }
+
+	    return ret;
+	}
+
+	key_index_t name_index;
+	key_index_t uuid_index;
+	key_index_t vg_name_index;
+
+	key_index_t& get_key_index(IndexType index_type);
+	const key_index_t& get_key_index(IndexType index_type) const;
+
+	void remove_index_key(IndexType index_type, const string& key, vertex_descriptor vertex);
+
     };
 
 }
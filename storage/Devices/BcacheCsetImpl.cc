@@ -23,6 +23,7 @@
 #include <regex>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/SystemInfo/SystemInfo.h"
@@ -51,6 +52,22 @@ namespace storage
     }
 
 
+    BcacheCset::Impl::Impl(BinaryReader& reader)
+	: Device::Impl(reader), uuid()
+    {
+	uuid = reader.get_string();
+    }
+
+
+    BcacheCset*
+    BcacheCset::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	BcacheCset* ret = new BcacheCset(new BcacheCset::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     BcacheCset::Impl::save(xmlNode* node) const
     {
@@ -60,6 +77,15 @@ namespace storage
     }
 
 
+    void
+    BcacheCset::Impl::save(BinaryWriter& writer) const
+    {
+	Device::Impl::save(writer);
+
+	writer.put_string(uuid);
+    }
+
+
     void
     BcacheCset::Impl::check() const
     {
@@ -77,6 +103,24 @@ namespace storage
     }
 
 
+    void
+    BcacheCset::Impl::set_uuid(const string& uuid)
+    {
+	update_index_key(Devicegraph::Impl::IndexType::UUID, Impl::uuid, uuid);
+
+	Impl::uuid = uuid;
+    }
+
+
+    void
+    BcacheCset::Impl::get_index_keys(Devicegraph::Impl::index_keys_t& keys) const
+    {
+	Device::Impl::get_index_keys(keys);
+
+	keys.emplace_back(Devicegraph::Impl::IndexType::UUID, uuid);
+    }
+
+
     bool
     BcacheCset::Impl::is_valid_uuid(const string& uuid)
     {
@@ -50,6 +50,9 @@ namespace storage
 	    : Device::Impl(), uuid() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static BcacheCset* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<BcacheCset>::classname; }
 
@@ -67,13 +70,16 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
 	virtual uint64_t used_features() const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual void get_index_keys(Devicegraph::Impl::index_keys_t& keys) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
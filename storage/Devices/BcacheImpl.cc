@@ -49,6 +49,21 @@ namespace storage
     }
 
 
+    Bcache::Impl::Impl(BinaryReader& reader)
+	: BlkDevice::Impl(reader)
+    {
+    }
+
+
+    Bcache*
+    Bcache::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Bcache* ret = new Bcache(new Bcache::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Bcache::Impl::save(xmlNode* node) const
     {
@@ -56,6 +71,13 @@ namespace storage
     }
 
 
+    void
+    Bcache::Impl::save(BinaryWriter& writer) const
+    {
+	BlkDevice::Impl::save(writer);
+    }
+
+
     bool
     Bcache::Impl::is_valid_name(const string& name)
     {
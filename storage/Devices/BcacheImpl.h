@@ -47,6 +47,9 @@ namespace storage
 	    : BlkDevice::Impl(name) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Bcache* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return "Bcache"; }
 
@@ -59,6 +62,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual uint64_t used_features() const override;
 
@@ -21,14 +21,18 @@
  */
 
 
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <iostream>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/FileUtils.h"
 #include "storage/Devices/BlkDeviceImpl.h"
 #include "storage/Devices/LuksImpl.h"
 #include "storage/Devices/LvmPv.h"
@@ -47,6 +51,7 @@
 #include "storage/Filesystems/Udf.h"
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/FreeInfo.h"
+#include "storage/FindBy.h"
 #include "storage/Prober.h"
 
 
@@ -93,6 +98,26 @@ namespace storage
     }
 
 
+    BlkDevice::Impl::Impl(BinaryReader& reader)
+	: Device::Impl(reader), name(), active(true), region(0, 0, 512), udev_paths(), udev_ids(),
+	  dm_table_name()
+    {
+	name = reader.get_string();
+
+	sysfs_name = reader.get_string();
+	sysfs_path = reader.get_string();
+
+	active = reader.get_bool();
+
+	region = reader.get_region();
+
+	udev_paths = reader.get_strings();
+	udev_ids = reader.get_strings();
+
+	dm_table_name = reader.get_string();
+    }
+
+
     void
     BlkDevice::Impl::probe_pass_1a(Prober& prober)
     {
@@ -143,6 +168,27 @@ namespace storage
     }
 
 
+    void
+    BlkDevice::Impl::save(BinaryWriter& writer) const
+    {
+	Device::Impl::save(writer);
+
+	writer.put_string(name);
+
+	writer.put_string(sysfs_name);
+	writer.put_string(sysfs_path);
+
+	writer.put_bool(active);
+
+	writer.put_region(region);
+
+	writer.put_strings(udev_paths);
+	writer.put_strings(udev_ids);
+
+	writer.put_string(dm_table_name);
+    }
+
+
     void
     BlkDevice::Impl::check() const
     {
@@ -159,15 +205,28 @@ namespace storage
     void
     BlkDevice::Impl::set_name(const string& name)
     {
+	update_index_key(Devicegraph::Impl::IndexType::NAME, Impl::name, name);
+
 	Impl::name = name;
     }
 
 
+    void
+    BlkDevice::Impl::get_index_keys(Devicegraph::Impl::index_keys_t& keys) const
+    {
+	Device::Impl::get_index_keys(keys);
+
+	keys.emplace_back(Devicegraph::Impl::IndexType::NAME, name);
+    }
+
+
     void
     BlkDevice::Impl::set_region(const Region& region)
     {
 	Impl::region = region;
 
+	modified();
+
 	for (Device* child : get_non_impl()->get_children())
 	    child->get_impl().parent_has_new_region(get_non_impl());
     }
@@ -209,36 +268,64 @@ namespace storage
     }
 
 
-    bool
-    BlkDevice::Impl::exists_by_name(const Devicegraph* devicegraph, const string& name,
-				    SystemInfo& system_info)
+    namespace
     {
-	if (!devicegraph->get_impl().is_probed())
-	    ST_THROW(Exception("function called on wrong devicegraph"));
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	/**
+	 * Finds the block device with the name. If no block device has that
+	 * name a second search via the major and minor number is done. With
+	 * the udev database all names of the device are known so only the
+	 * name index of the devicegraph is used. Otherwise the major and
+	 * minor number of every block device must be looked up.
+	 */
+	template <typename Type, typename DevicegraphType>
+	Type*
+	find_by_name_or_majorminor(DevicegraphType* devicegraph, const string& name,
+				   SystemInfo& system_info, bool only_active)
 	{
-	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
+	    if (!devicegraph->get_impl().is_probed())
+		ST_THROW(Exception("function called on wrong devicegraph"));
+
+	    Type* blk_device = find_by_key<Type>(devicegraph, Devicegraph::Impl::IndexType::NAME, name);
 	    if (blk_device)
+		return blk_device;
+
+	    dev_t majorminor = system_info.getCmdUdevadmInfo(name).get_majorminor();
+
+	    const CmdUdevadmExportDb* cmdudevadmexportdb = system_info.getCmdUdevadmExportDb();
+	    if (cmdudevadmexportdb)
 	    {
-		if (blk_device->get_name() == name)
-		    return true;
+		for (const string& file : cmdudevadmexportdb->find_by_majorminor(majorminor))
+		{
+		    blk_device = find_by_key<Type>(devicegraph, Devicegraph::Impl::IndexType::NAME, file);
+		    if (blk_device && (!only_active || blk_device->get_impl().is_active()))
+			return blk_device;
+		}
+
+		return nullptr;
 	    }
-	}
 
-	dev_t majorminor = system_info.getCmdUdevadmInfo(name).get_majorminor();
-
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device && blk_device->get_impl().active)
+	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
 	    {
-		if (system_info.getCmdUdevadmInfo(blk_device->get_name()).get_majorminor() == majorminor)
-		    return true;
+		blk_device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
+		if (blk_device && (!only_active || blk_device->get_impl().is_active()))
+		{
+		    if (system_info.getCmdUdevadmInfo(blk_device->get_name()).get_majorminor() == majorminor)
+			return blk_device;
+		}
 	    }
+
+	    return nullptr;
 	}
 
-	return false;
+    }
+
+
+    bool
+    BlkDevice::Impl::exists_by_name(const Devicegraph* devicegraph, const string& name,
+				    SystemInfo& system_info)
+    {
+	return find_by_name_or_majorminor<const BlkDevice>(devicegraph, name, system_info, true);
     }
 
 
@@ -246,32 +333,11 @@ namespace storage
     BlkDevice::Impl::find_by_name(Devicegraph* devicegraph, const string& name,
 				  SystemInfo& system_info)
     {
-	if (!devicegraph->get_impl().is_probed())
-	    ST_THROW(Exception("function called on wrong devicegraph"));
-
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    BlkDevice* blk_device = dynamic_cast<BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device)
-	    {
-		if (blk_device->get_name() == name)
-		    return blk_device;
-	    }
-	}
+	BlkDevice* blk_device = find_by_name_or_majorminor<BlkDevice>(devicegraph, name, system_info, true);
+	if (!blk_device)
+	    ST_THROW(DeviceNotFoundByName(name));
 
-	dev_t majorminor = system_info.getCmdUdevadmInfo(name).get_majorminor();
-
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    BlkDevice* blk_device = dynamic_cast<BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device && blk_device->get_impl().active)
-	    {
-		if (system_info.getCmdUdevadmInfo(blk_device->get_name()).get_majorminor() == majorminor)
-		    return blk_device;
-	    }
-	}
-
-	ST_THROW(DeviceNotFoundByName(name));
+	return blk_device;
     }
 
 
@@ -279,32 +345,11 @@ namespace storage
     BlkDevice::Impl::find_by_name(const Devicegraph* devicegraph, const string& name,
 				  SystemInfo& system_info)
     {
-	if (!devicegraph->get_impl().is_probed())
-	    ST_THROW(Exception("function called on wrong devicegraph"));
+	const BlkDevice* blk_device = find_by_name_or_majorminor<const BlkDevice>(devicegraph, name, system_info, false);
+	if (!blk_device)
+	    ST_THROW(DeviceNotFoundByName(name));
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device)
-	    {
-		if (blk_device->get_name() == name)
-		    return blk_device;
-	    }
-	}
-
-	dev_t majorminor = system_info.getCmdUdevadmInfo(name).get_majorminor();
-
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device)
-	    {
-		if (system_info.getCmdUdevadmInfo(blk_device->get_name()).get_majorminor() == majorminor)
-		    return blk_device;
-	    }
-	}
-
-	ST_THROW(DeviceNotFoundByName(name));
+	return blk_device;
     }
 
 
@@ -544,25 +589,40 @@ namespace storage
     void
     BlkDevice::Impl::wait_for_device() const
     {
-	SystemCmd(UDEVADMBIN_SETTLE);
+	wait_for_devices({ to_blk_device(get_non_impl()) });
+    }
+
+
+    void
+    BlkDevice::Impl::wait_for_devices(const vector<const BlkDevice*>& blk_devices)
+    {
+	// Instead of polling for every device the device nodes are watched
+	// with inotify. So waiting only takes as long as the devices need to
+	// appear.
+
+	vector<string> names;
+	for (const BlkDevice* blk_device : blk_devices)
+	    names.push_back(blk_device->get_name());
 
-	bool exist = access(name.c_str(), R_OK) == 0;
-	y2mil("name:" << name << " exist:" << exist);
+	if (!wait_for_files(names, 10000))
+	    ST_THROW(Exception("wait_for_device failed"));
+
+	// A stale device node may exist before udev has processed the
+	// change. Udev writes the database entry of a device once it has
+	// processed the device, so wait for the entries of the devices
+	// instead of all pending events. Only if these do not appear, e.g.
+	// without udev, udevadm settle is run.
 
-	if (!exist)
+	vector<string> entries;
+	for (const string& name : names)
 	{
-	    for (int count = 0; count < 500; ++count)
-	    {
-		usleep(10000);
-		exist = access(name.c_str(), R_OK) == 0;
-		if (exist)
-		    break;
-	    }
-	    y2mil("name:" << name << " exist:" << exist);
+	    struct stat buf;
+	    if (stat(name.c_str(), &buf) == 0 && S_ISBLK(buf.st_mode))
+		entries.push_back(sformat(UDEVDATADIR "/b%u:%u", major(buf.st_rdev), minor(buf.st_rdev)));
 	}
 
-	if (!exist)
-	    ST_THROW(Exception("wait_for_device failed"));
+	if (entries.size() != names.size() || !checkDir(UDEVDATADIR) || !wait_for_files(entries, 10000))
+	    SystemCmd(UDEVADMBIN_SETTLE);
     }
 
 
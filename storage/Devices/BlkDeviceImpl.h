@@ -60,6 +60,8 @@ namespace storage
 	const string& get_name() const { return name; }
 	void set_name(const string& name);
 
+	virtual void get_index_keys(Devicegraph::Impl::index_keys_t& keys) const override;
+
 	const string& get_sysfs_name() const { return sysfs_name; }
 	void set_sysfs_name(const string& sysfs_name) { Impl::sysfs_name = sysfs_name; }
 
@@ -136,7 +138,19 @@ namespace storage
 	virtual void process_udev_paths(vector<string>& udev_paths) const { udev_paths.clear(); }
 	virtual void process_udev_ids(vector<string>& udev_ids) const { udev_ids.clear(); }
 
+	/**
+	 * Waits until the device node exists and udev has processed the
+	 * device, see wait_for_devices(). Throws an exception if the device
+	 * does not appear in time.
+	 */
 	void wait_for_device() const;
+
+	/**
+	 * Same as wait_for_device() for several devices at once. Only if
+	 * udev does not report the devices as processed in time 'udevadm
+	 * settle' is run, once for all devices.
+	 */
+	static void wait_for_devices(const vector<const BlkDevice*>& blk_devices);
 	void wipe_device() const;
 
 	static bool is_valid_name(const string& name);
@@ -149,8 +163,10 @@ namespace storage
 	Impl(const string& name, const Region& region);
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
     private:
 
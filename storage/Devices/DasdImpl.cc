@@ -31,6 +31,7 @@
 #include "storage/Utils/StorageTypes.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/UsedFeatures.h"
 #include "storage/Prober.h"
@@ -85,6 +86,26 @@ namespace storage
     }
 
 
+    Dasd::Impl::Impl(BinaryReader& reader)
+	: Partitionable::Impl(reader), rotational(false), type(DasdType::UNKNOWN),
+	  format(DasdFormat::NONE)
+    {
+	rotational = reader.get_bool();
+
+	type = toValueWithFallback(reader.get_string(), DasdType::UNKNOWN);
+	format = toValueWithFallback(reader.get_string(), DasdFormat::NONE);
+    }
+
+
+    Dasd*
+    Dasd::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Dasd* ret = new Dasd(new Dasd::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Dasd::Impl::probe_dasds(Prober& prober)
     {
@@ -143,6 +164,18 @@ namespace storage
     }
 
 
+    void
+    Dasd::Impl::save(BinaryWriter& writer) const
+    {
+	Partitionable::Impl::save(writer);
+
+	writer.put_bool(rotational);
+
+	writer.put_string(toString(type));
+	writer.put_string(toString(format));
+    }
+
+
     bool
     Dasd::Impl::equal(const Device::Impl& rhs_base) const
     {
@@ -51,12 +51,16 @@ namespace storage
 	Impl(const string& name, const Region& region);
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Dasd* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<Dasd>::classname; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	bool is_rotational() const { return rotational; }
 	void set_rotational(bool rotational) { Impl::rotational = rotational; }
@@ -51,6 +51,21 @@ namespace storage
     }
 
 
+    DasdPt::Impl::Impl(BinaryReader& reader)
+	: PartitionTable::Impl(reader)
+    {
+    }
+
+
+    DasdPt*
+    DasdPt::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	DasdPt* ret = new DasdPt(new DasdPt::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     DasdPt::Impl::probe_pass_1c(Prober& prober)
     {
@@ -65,6 +80,13 @@ namespace storage
     }
 
 
+    void
+    DasdPt::Impl::save(BinaryWriter& writer) const
+    {
+	PartitionTable::Impl::save(writer);
+    }
+
+
     void
     DasdPt::Impl::check() const
     {
@@ -46,6 +46,9 @@ namespace storage
 	    : PartitionTable::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static DasdPt* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<DasdPt>::classname; }
 
@@ -58,6 +61,7 @@ namespace storage
 	virtual void check() const override;
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual Partition* create_partition(const string& name, const Region& region, PartitionType type) override;
 
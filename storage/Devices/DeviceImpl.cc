@@ -25,6 +25,7 @@
 #include "storage/Devicegraph.h"
 #include "storage/Action.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/FreeInfo.h"
 #include "storage/Storage.h"
@@ -56,6 +57,13 @@ namespace storage
     }
 
 
+    Device::Impl::Impl(BinaryReader& reader)
+	: sid(0), devicegraph(nullptr), vertex(), userdata()
+    {
+	sid = reader.get_u32();
+    }
+
+
     bool
     Device::Impl::operator==(const Impl& rhs) const
     {
@@ -125,6 +133,13 @@ namespace storage
     }
 
 
+    void
+    Device::Impl::save(BinaryWriter& writer) const
+    {
+	writer.put_u32(sid);
+    }
+
+
     void
     Device::Impl::check() const
     {
@@ -144,6 +159,30 @@ namespace storage
     }
 
 
+    void
+    Device::Impl::update_index_key(Devicegraph::Impl::IndexType index_type, const string& old_key,
+				   const string& new_key)
+    {
+	// A cloned device still has the back references of the original
+	// device until it is added to a devicegraph.
+
+	if (!devicegraph || &devicegraph->get_impl()[vertex]->get_impl() != this)
+	    return;
+
+	devicegraph->get_impl().update_index_key(index_type, old_key, new_key, vertex);
+    }
+
+
+    void
+    Device::Impl::modified()
+    {
+	if (!devicegraph)
+	    return;
+
+	devicegraph->get_impl().modified();
+    }
+
+
     Devicegraph*
     Device::Impl::get_devicegraph()
     {
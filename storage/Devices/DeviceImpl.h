@@ -45,6 +45,8 @@ namespace storage
 
 
     class Prober;
+    class BinaryReader;
+    class BinaryWriter;
 
 
     template <typename Type> struct DeviceTraits {};
@@ -92,6 +94,7 @@ namespace storage
 	virtual string get_displayname() const = 0;
 
 	virtual void save(xmlNode* node) const = 0;
+	virtual void save(BinaryWriter& writer) const = 0;
 
 	virtual void check() const;
 
@@ -132,6 +135,12 @@ namespace storage
 
 	virtual void parent_has_new_region(const Device* parent);
 
+	/**
+	 * Adds the keys used in the secondary indexes of the devicegraph,
+	 * e.g. the name of block devices.
+	 */
+	virtual void get_index_keys(Devicegraph::Impl::index_keys_t& keys) const {}
+
 	virtual uint64_t used_features() const { return 0; }
 
 	virtual bool has_dependency_manager() const { return false; }
@@ -364,6 +373,21 @@ namespace storage
 	Impl();
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	/**
+	 * Updates the secondary index of the devicegraph after a key of the
+	 * device changed. Does nothing if the device is not (yet) part of a
+	 * devicegraph.
+	 */
+	void update_index_key(Devicegraph::Impl::IndexType index_type, const string& old_key,
+			      const string& new_key);
+
+	/**
+	 * Reports a change of the device that can invalidate data derived
+	 * from the devicegraph, see Devicegraph::Impl::get_generation().
+	 */
+	void modified();
 
     private:
 
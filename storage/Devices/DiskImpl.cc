@@ -36,6 +36,7 @@
 #include "storage/Utils/StorageTypes.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/UsedFeatures.h"
 #include "storage/Prober.h"
 
@@ -66,6 +67,24 @@ namespace storage
     }
 
 
+    Disk::Impl::Impl(BinaryReader& reader)
+	: Partitionable::Impl(reader), rotational(false), transport(Transport::UNKNOWN)
+    {
+	rotational = reader.get_bool();
+
+	transport = toValueWithFallback(reader.get_string(), Transport::UNKNOWN);
+    }
+
+
+    Disk*
+    Disk::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Disk* ret = new Disk(new Disk::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Disk::Impl::probe_disks(Prober& prober)
     {
@@ -134,6 +153,17 @@ namespace storage
     }
 
 
+    void
+    Disk::Impl::save(BinaryWriter& writer) const
+    {
+	Partitionable::Impl::save(writer);
+
+	writer.put_bool(rotational);
+
+	writer.put_string(toString(transport));
+    }
+
+
     void
     Disk::Impl::add_create_actions(Actiongraph::Impl& actiongraph) const
     {
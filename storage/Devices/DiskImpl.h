@@ -53,12 +53,16 @@ namespace storage
 	      rotational(false), transport(Transport::UNKNOWN) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Disk* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<Disk>::classname; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	bool is_rotational() const { return rotational; }
 	void set_rotational(bool rotational) { Impl::rotational = rotational; }
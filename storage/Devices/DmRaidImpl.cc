@@ -32,6 +32,7 @@
 #include "storage/Utils/StorageTypes.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/UsedFeatures.h"
 #include "storage/Holders/User.h"
@@ -77,6 +78,22 @@ namespace storage
     }
 
 
+    DmRaid::Impl::Impl(BinaryReader& reader)
+	: Partitionable::Impl(reader), rotational(false)
+    {
+	rotational = reader.get_bool();
+    }
+
+
+    DmRaid*
+    DmRaid::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	DmRaid* ret = new DmRaid(new DmRaid::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     DmRaid::Impl::check() const
     {
@@ -197,6 +214,15 @@ namespace storage
     }
 
 
+    void
+    DmRaid::Impl::save(BinaryWriter& writer) const
+    {
+	Partitionable::Impl::save(writer);
+
+	writer.put_bool(rotational);
+    }
+
+
     void
     DmRaid::Impl::add_create_actions(Actiongraph::Impl& actiongraph) const
     {
@@ -48,6 +48,9 @@ namespace storage
 	Impl(const string& name);
 	Impl(const string& name, const Region& region);
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static DmRaid* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<DmRaid>::classname; }
 
@@ -58,6 +61,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
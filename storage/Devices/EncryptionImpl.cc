@@ -21,6 +21,7 @@
 
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/Devices/EncryptionImpl.h"
@@ -65,6 +66,27 @@ namespace storage
     }
 
 
+    Encryption::Impl::Impl(BinaryReader& reader)
+	: BlkDevice::Impl(reader), password(), in_etc_crypttab(true)
+    {
+	if (get_dm_table_name().empty())
+	    reader.error("no dm-table-name");
+
+	password = reader.get_string();
+
+	in_etc_crypttab = reader.get_bool();
+    }
+
+
+    Encryption*
+    Encryption::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Encryption* ret = new Encryption(new Encryption::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Encryption::Impl::save(xmlNode* node) const
     {
@@ -77,6 +99,20 @@ namespace storage
     }
 
 
+    void
+    Encryption::Impl::save(BinaryWriter& writer) const
+    {
+	BlkDevice::Impl::save(writer);
+
+	if (get_storage()->get_environment().get_impl().is_debug_credentials())
+	    writer.put_string(password);
+	else
+	    writer.put_string("");
+
+	writer.put_bool(in_etc_crypttab);
+    }
+
+
     const BlkDevice*
     Encryption::Impl::get_blk_device() const
     {
@@ -48,6 +48,9 @@ namespace storage
 
 	Impl(const string& dm_table_name);
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Encryption* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return "Encryption"; }
 
@@ -67,6 +70,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void probe_pass_1b(Prober& prober) override;
 
@@ -122,6 +126,8 @@ namespace storage
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data) const override;
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const override;
 
@@ -152,6 +158,8 @@ namespace storage
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data) const override;
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	};
 
     }
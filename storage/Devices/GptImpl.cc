@@ -30,6 +30,7 @@
 #include "storage/Action.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/StorageDefines.h"
@@ -53,6 +54,23 @@ namespace storage
     }
 
 
+    Gpt::Impl::Impl(BinaryReader& reader)
+	: PartitionTable::Impl(reader), enlarge(false), pmbr_boot(false)
+    {
+	enlarge = reader.get_bool();
+	pmbr_boot = reader.get_bool();
+    }
+
+
+    Gpt*
+    Gpt::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Gpt* ret = new Gpt(new Gpt::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Gpt::Impl::probe_pass_1c(Prober& prober)
     {
@@ -77,6 +95,16 @@ namespace storage
     }
 
 
+    void
+    Gpt::Impl::save(BinaryWriter& writer) const
+    {
+	PartitionTable::Impl::save(writer);
+
+	writer.put_bool(enlarge);
+	writer.put_bool(pmbr_boot);
+    }
+
+
     Region
     Gpt::Impl::get_usable_region() const
     {
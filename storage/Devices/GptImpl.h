@@ -46,6 +46,9 @@ namespace storage
 	    : PartitionTable::Impl(), enlarge(false), pmbr_boot(false) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Gpt* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<Gpt>::classname; }
 
@@ -56,6 +59,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void probe_pass_1c(Prober& prober) override;
 
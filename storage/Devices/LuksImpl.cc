@@ -23,6 +23,7 @@
 #include <iostream>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/Devices/LuksImpl.h"
@@ -51,6 +52,22 @@ namespace storage
     }
 
 
+    Luks::Impl::Impl(BinaryReader& reader)
+	: Encryption::Impl(reader), uuid()
+    {
+	uuid = reader.get_string();
+    }
+
+
+    Luks*
+    Luks::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Luks* ret = new Luks(new Luks::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Luks::Impl::save(xmlNode* node) const
     {
@@ -60,6 +77,15 @@ namespace storage
     }
 
 
+    void
+    Luks::Impl::save(BinaryWriter& writer) const
+    {
+	Encryption::Impl::save(writer);
+
+	writer.put_string(uuid);
+    }
+
+
     void
     Luks::Impl::check() const
     {
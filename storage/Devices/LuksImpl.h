@@ -51,6 +51,9 @@ namespace storage
 	    : Encryption::Impl(dm_name), uuid() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Luks* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return "Luks"; }
 
@@ -77,6 +80,7 @@ namespace storage
 	virtual EncryptionType get_type() const override { return EncryptionType::LUKS; }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
@@ -26,6 +26,7 @@
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/Devices/LvmLvImpl.h"
@@ -85,6 +86,35 @@ namespace storage
     }
 
 
+    LvmLv::Impl::Impl(BinaryReader& reader)
+	: BlkDevice::Impl(reader), lv_name(), lv_type(LvType::NORMAL), uuid(), stripes(0),
+	  stripe_size(0), chunk_size(0)
+    {
+	if (get_dm_table_name().empty())
+	    reader.error("no dm-table-name");
+
+	lv_name = reader.get_string();
+
+	lv_type = toValueWithFallback(reader.get_string(), LvType::NORMAL);
+
+	uuid = reader.get_string();
+
+	stripes = reader.get_u32();
+	stripe_size = reader.get_u64();
+
+	chunk_size = reader.get_u64();
+    }
+
+
+    LvmLv*
+    LvmLv::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	LvmLv* ret = new LvmLv(new LvmLv::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     LvmLv::Impl::save(xmlNode* node) const
     {
@@ -103,6 +133,24 @@ namespace storage
     }
 
 
+    void
+    LvmLv::Impl::save(BinaryWriter& writer) const
+    {
+	BlkDevice::Impl::save(writer);
+
+	writer.put_string(lv_name);
+
+	writer.put_string(toString(lv_type));
+
+	writer.put_string(uuid);
+
+	writer.put_u32(stripes);
+	writer.put_u64(stripe_size);
+
+	writer.put_u64(chunk_size);
+    }
+
+
     void
     LvmLv::Impl::check() const
     {
@@ -245,6 +293,24 @@ namespace storage
     }
 
 
+    void
+    LvmLv::Impl::set_uuid(const string& uuid)
+    {
+	update_index_key(Devicegraph::Impl::IndexType::UUID, Impl::uuid, uuid);
+
+	Impl::uuid = uuid;
+    }
+
+
+    void
+    LvmLv::Impl::get_index_keys(Devicegraph::Impl::index_keys_t& keys) const
+    {
+	BlkDevice::Impl::get_index_keys(keys);
+
+	keys.emplace_back(Devicegraph::Impl::IndexType::UUID, uuid);
+    }
+
+
     void
     LvmLv::Impl::set_lv_name(const string& lv_name)
     {
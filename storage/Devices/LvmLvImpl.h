@@ -49,6 +49,9 @@ namespace storage
 
 	Impl(const string& vg_name, const string& lv_name, LvType lv_type);
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static LvmLv* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<LvmLv>::classname; }
 
@@ -64,6 +67,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
@@ -79,7 +83,9 @@ namespace storage
 	LvType get_lv_type() const { return lv_type; }
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual void get_index_keys(Devicegraph::Impl::index_keys_t& keys) const override;
 
 	unsigned long long number_of_extents() const { return get_region().get_length(); }
 
@@ -23,6 +23,7 @@
 #include <iostream>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Prober.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/StorageDefines.h"
@@ -54,6 +55,22 @@ namespace storage
     }
 
 
+    LvmPv::Impl::Impl(BinaryReader& reader)
+	: Device::Impl(reader), uuid()
+    {
+	uuid = reader.get_string();
+    }
+
+
+    LvmPv*
+    LvmPv::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	LvmPv* ret = new LvmPv(new LvmPv::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     LvmPv::Impl::save(xmlNode* node) const
     {
@@ -63,6 +80,15 @@ namespace storage
     }
 
 
+    void
+    LvmPv::Impl::save(BinaryWriter& writer) const
+    {
+	Device::Impl::save(writer);
+
+	writer.put_string(uuid);
+    }
+
+
     void
     LvmPv::Impl::check() const
     {
@@ -73,6 +99,24 @@ namespace storage
     }
 
 
+    void
+    LvmPv::Impl::set_uuid(const string& uuid)
+    {
+	update_index_key(Devicegraph::Impl::IndexType::UUID, Impl::uuid, uuid);
+
+	Impl::uuid = uuid;
+    }
+
+
+    void
+    LvmPv::Impl::get_index_keys(Devicegraph::Impl::index_keys_t& keys) const
+    {
+	Device::Impl::get_index_keys(keys);
+
+	keys.emplace_back(Devicegraph::Impl::IndexType::UUID, uuid);
+    }
+
+
     bool
     LvmPv::Impl::has_blk_device() const
     {
@@ -45,6 +45,9 @@ namespace storage
 	    : Device::Impl(), uuid() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static LvmPv* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<LvmPv>::classname; }
 
@@ -53,11 +56,14 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual void get_index_keys(Devicegraph::Impl::index_keys_t& keys) const override;
 
 	bool has_blk_device() const;
 
@@ -28,6 +28,7 @@
 #include "storage/Holders/Subdevice.h"
 #include "storage/Devicegraph.h"
 #include "storage/Action.h"
+#include "storage/FindBy.h"
 
 
 namespace storage
@@ -194,28 +195,24 @@ namespace storage
     LvmVg*
     LvmVg::find_by_vg_name(Devicegraph* devicegraph, const string& vg_name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    LvmVg* lvm_vg = dynamic_cast<LvmVg*>(devicegraph->get_impl()[vertex]);
-	    if (lvm_vg && lvm_vg->get_vg_name() == vg_name)
-		return lvm_vg;
-	}
+	LvmVg* lvm_vg = find_by_key<LvmVg>(devicegraph, Devicegraph::Impl::IndexType::VG_NAME,
+					   vg_name);
+	if (!lvm_vg)
+	    ST_THROW(LvmVgNotFoundByVgName(vg_name));
 
-	ST_THROW(LvmVgNotFoundByVgName(vg_name));
+	return lvm_vg;
     }
 
 
     const LvmVg*
     LvmVg::find_by_vg_name(const Devicegraph* devicegraph, const string& vg_name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    const LvmVg* lvm_vg = dynamic_cast<const LvmVg*>(devicegraph->get_impl()[vertex]);
-	    if (lvm_vg && lvm_vg->get_vg_name() == vg_name)
-		return lvm_vg;
-	}
+	const LvmVg* lvm_vg = find_by_key<const LvmVg>(devicegraph,
+						       Devicegraph::Impl::IndexType::VG_NAME, vg_name);
+	if (!lvm_vg)
+	    ST_THROW(LvmVgNotFoundByVgName(vg_name));
 
-	ST_THROW(LvmVgNotFoundByVgName(vg_name));
+	return lvm_vg;
     }
 
 
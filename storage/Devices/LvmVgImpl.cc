@@ -23,6 +23,7 @@
 #include <iostream>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/Math.h"
 #include "storage/Utils/StorageDefines.h"
@@ -60,6 +61,26 @@ namespace storage
     }
 
 
+    LvmVg::Impl::Impl(BinaryReader& reader)
+	: Device::Impl(reader), vg_name(), uuid(), region(0, 0, default_extent_size), reserved_extents(0)
+    {
+	vg_name = reader.get_string();
+	uuid = reader.get_string();
+
+	region = reader.get_region();
+	reserved_extents = reader.get_u64();
+    }
+
+
+    LvmVg*
+    LvmVg::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	LvmVg* ret = new LvmVg(new LvmVg::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     LvmVg::Impl::save(xmlNode* node) const
     {
@@ -73,6 +94,19 @@ namespace storage
     }
 
 
+    void
+    LvmVg::Impl::save(BinaryWriter& writer) const
+    {
+	Device::Impl::save(writer);
+
+	writer.put_string(vg_name);
+	writer.put_string(uuid);
+
+	writer.put_region(region);
+	writer.put_u64(reserved_extents);
+    }
+
+
     void
     LvmVg::Impl::check() const
     {
@@ -181,12 +215,33 @@ namespace storage
     void
     LvmVg::Impl::set_vg_name(const string& vg_name)
     {
+	update_index_key(Devicegraph::Impl::IndexType::VG_NAME, Impl::vg_name, vg_name);
+
 	Impl::vg_name = vg_name;
 
 	// TODO call set_name() for all lvm_lvs
     }
 
 
+    void
+    LvmVg::Impl::set_uuid(const string& uuid)
+    {
+	update_index_key(Devicegraph::Impl::IndexType::UUID, Impl::uuid, uuid);
+
+	Impl::uuid = uuid;
+    }
+
+
+    void
+    LvmVg::Impl::get_index_keys(Devicegraph::Impl::index_keys_t& keys) const
+    {
+	Device::Impl::get_index_keys(keys);
+
+	keys.emplace_back(Devicegraph::Impl::IndexType::VG_NAME, vg_name);
+	keys.emplace_back(Devicegraph::Impl::IndexType::UUID, uuid);
+    }
+
+
     void
     LvmVg::Impl::calculate_region()
     {
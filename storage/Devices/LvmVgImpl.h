@@ -50,6 +50,9 @@ namespace storage
 	      reserved_extents(0) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static LvmVg* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<LvmVg>::classname; }
 
@@ -63,6 +66,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
@@ -85,7 +89,9 @@ namespace storage
 	void set_vg_name(const string& vg_name);
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual void get_index_keys(Devicegraph::Impl::index_keys_t& keys) const override;
 
 	LvmPv* add_lvm_pv(BlkDevice* blk_device);
 	void remove_lvm_pv(BlkDevice* blk_device);
@@ -47,6 +47,21 @@ namespace storage
     }
 
 
+    MdContainer::Impl::Impl(BinaryReader& reader)
+	: Md::Impl(reader)
+    {
+    }
+
+
+    MdContainer*
+    MdContainer::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	MdContainer* ret = new MdContainer(new MdContainer::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     MdContainer::Impl::check() const
     {
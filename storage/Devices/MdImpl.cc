@@ -43,6 +43,7 @@
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/Utils/Algorithm.h"
 #include "storage/UsedFeatures.h"
@@ -129,6 +130,32 @@ namespace storage
     }
 
 
+    Md::Impl::Impl(BinaryReader& reader)
+	: Partitionable::Impl(reader), md_level(MdLevel::UNKNOWN), md_parity(MdParity::DEFAULT),
+	  chunk_size(0), uuid(), metadata(), in_etc_mdadm(true)
+    {
+	md_level = toValueWithFallback(reader.get_string(), MdLevel::RAID0);
+	md_parity = toValueWithFallback(reader.get_string(), MdParity::DEFAULT);
+
+	chunk_size = reader.get_u64();
+
+	uuid = reader.get_string();
+
+	metadata = reader.get_string();
+
+	in_etc_mdadm = reader.get_bool();
+    }
+
+
+    Md*
+    Md::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Md* ret = new Md(new Md::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     string
     Md::Impl::find_free_numeric_name(const Devicegraph* devicegraph)
     {
@@ -426,6 +453,24 @@ namespace storage
     }
 
 
+    void
+    Md::Impl::save(BinaryWriter& writer) const
+    {
+	Partitionable::Impl::save(writer);
+
+	writer.put_string(toString(md_level));
+	writer.put_string(toString(md_parity));
+
+	writer.put_u64(chunk_size);
+
+	writer.put_string(uuid);
+
+	writer.put_string(metadata);
+
+	writer.put_bool(in_etc_mdadm);
+    }
+
+
     MdUser*
     Md::Impl::add_device(BlkDevice* blk_device)
     {
@@ -55,12 +55,16 @@ namespace storage
 
 	Impl(const string& name);
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Md* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<Md>::classname; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
@@ -192,6 +196,8 @@ namespace storage
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data) const override;
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const override;
 
@@ -208,6 +214,8 @@ namespace storage
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data) const override;
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	};
 
     }
@@ -52,6 +52,21 @@ namespace storage
     }
 
 
+    MdMember::Impl::Impl(BinaryReader& reader)
+	: Md::Impl(reader)
+    {
+    }
+
+
+    MdMember*
+    MdMember::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	MdMember* ret = new MdMember(new MdMember::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     MdMember::Impl::check() const
     {
@@ -43,6 +43,9 @@ namespace storage
 
 	Impl(const string& name);
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static MdMember* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<MdMember>::classname; }
 
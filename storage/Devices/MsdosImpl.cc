@@ -34,6 +34,7 @@
 #include "storage/Utils/HumanString.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 
 
 namespace storage
@@ -52,6 +53,22 @@ namespace storage
     }
 
 
+    Msdos::Impl::Impl(BinaryReader& reader)
+	: PartitionTable::Impl(reader), minimal_mbr_gap(default_minimal_mbr_gap)
+    {
+	minimal_mbr_gap = reader.get_u64();
+    }
+
+
+    Msdos*
+    Msdos::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Msdos* ret = new Msdos(new Msdos::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Msdos::Impl::save(xmlNode* node) const
     {
@@ -62,6 +79,15 @@ namespace storage
     }
 
 
+    void
+    Msdos::Impl::save(BinaryWriter& writer) const
+    {
+	PartitionTable::Impl::save(writer);
+
+	writer.put_u64(minimal_mbr_gap);
+    }
+
+
     void
     Msdos::Impl::delete_partition(Partition* partition)
     {
@@ -57,6 +57,9 @@ namespace storage
 	    : PartitionTable::Impl(), minimal_mbr_gap(default_minimal_mbr_gap) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Msdos* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<Msdos>::classname; }
 
@@ -69,6 +72,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
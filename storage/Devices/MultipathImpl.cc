@@ -32,6 +32,7 @@
 #include "storage/Utils/StorageTypes.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/UsedFeatures.h"
 #include "storage/Holders/User.h"
@@ -80,6 +81,25 @@ namespace storage
     }
 
 
+    Multipath::Impl::Impl(BinaryReader& reader)
+	: Partitionable::Impl(reader), vendor(), model(), rotational(false)
+    {
+	vendor = reader.get_string();
+	model = reader.get_string();
+
+	rotational = reader.get_bool();
+    }
+
+
+    Multipath*
+    Multipath::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Multipath* ret = new Multipath(new Multipath::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Multipath::Impl::check() const
     {
@@ -228,6 +248,18 @@ namespace storage
     }
 
 
+    void
+    Multipath::Impl::save(BinaryWriter& writer) const
+    {
+	Partitionable::Impl::save(writer);
+
+	writer.put_string(vendor);
+	writer.put_string(model);
+
+	writer.put_bool(rotational);
+    }
+
+
     void
     Multipath::Impl::add_create_actions(Actiongraph::Impl& actiongraph) const
     {
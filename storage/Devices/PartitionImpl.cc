@@ -40,6 +40,7 @@
 #include "storage/Storage.h"
 #include "storage/FreeInfo.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Prober.h"
 
 
@@ -79,6 +80,26 @@ namespace storage
     }
 
 
+    Partition::Impl::Impl(BinaryReader& reader)
+	: BlkDevice::Impl(reader), type(PartitionType::PRIMARY), id(ID_LINUX), boot(false),
+	  legacy_boot(false)
+    {
+	type = toValueWithFallback(reader.get_string(), PartitionType::PRIMARY);
+	id = reader.get_u32();
+	boot = reader.get_bool();
+	legacy_boot = reader.get_bool();
+    }
+
+
+    Partition*
+    Partition::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Partition* ret = new Partition(new Partition::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Partition::Impl::probe_pass_1a(Prober& prober)
     {
@@ -109,6 +130,18 @@ namespace storage
     }
 
 
+    void
+    Partition::Impl::save(BinaryWriter& writer) const
+    {
+	BlkDevice::Impl::save(writer);
+
+	writer.put_string(toString(type));
+	writer.put_u32(id);
+	writer.put_bool(boot);
+	writer.put_bool(legacy_boot);
+    }
+
+
     void
     Partition::Impl::check() const
     {
@@ -152,6 +185,8 @@ namespace storage
 
 	update_sysfs_name_and_path();
 	update_udev_paths_and_ids();
+
+	modified();
     }
 
 
@@ -162,7 +197,15 @@ namespace storage
 	if (region.get_block_size() != partitionable_region.get_block_size())
 	    ST_THROW(DifferentBlockSizes(region.get_block_size(), partitionable_region.get_block_size()));
 
+	const Region old_region = get_region();
+
+	const PartitionTable* partition_table = get_partition_table();
+	bool slot_index_valid = partition_table->get_impl().has_valid_slot_index();
+
 	BlkDevice::Impl::set_region(region);
+
+	if (slot_index_valid)
+	    partition_table->get_impl().slot_index_partition_resized(to_partition(get_non_impl()), old_region);
     }
 
 
@@ -328,6 +371,8 @@ namespace storage
 				       toString(partition_table->get_type()).c_str())));
 
 	Impl::type = type;
+
+	modified();
     }
 
 
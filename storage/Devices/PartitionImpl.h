@@ -53,6 +53,9 @@ namespace storage
 	Impl(const string& name, const Region& region, PartitionType type);
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Partition* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<Partition>::classname; }
 
@@ -61,6 +64,7 @@ namespace storage
 	virtual void probe_pass_1a(Prober& prober) override;
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual bool has_dependency_manager() const override { return true; }
 
@@ -47,6 +47,19 @@ namespace storage
     }
 
 
+    PartitionRequest::PartitionRequest()
+	: min_size(0), max_size(0), weight(1), type(PartitionType::PRIMARY)
+    {
+    }
+
+
+    PartitionRequest::PartitionRequest(unsigned long long min_size, unsigned long long max_size,
+				       unsigned int weight, PartitionType type)
+	: min_size(min_size), max_size(max_size), weight(weight), type(type)
+    {
+    }
+
+
     bool
     PartitionSlot::is_possible(PartitionType partition_type) const
     {
@@ -100,6 +113,13 @@ namespace storage
     }
 
 
+    vector<Partition*>
+    PartitionTable::create_partitions(const vector<PartitionRequest>& requests, AlignType align_type)
+    {
+	return get_impl().create_partitions(requests, align_type);
+    }
+
+
     void
     PartitionTable::delete_partition(Partition* partition)
     {
@@ -205,6 +225,13 @@ namespace storage
     }
 
 
+    PartitionSlot
+    PartitionTable::get_largest_unused_partition_slot(AlignPolicy align_policy, AlignType align_type) const
+    {
+	return get_impl().get_largest_unused_partition_slot(align_policy, align_type);
+    }
+
+
     Region
     PartitionTable::align(const Region& region, AlignPolicy align_policy, AlignType align_type) const
     {
@@ -73,6 +73,35 @@ namespace storage
     };
 
 
+    /**
+     * A request for a partition for PartitionTable::create_partitions().
+     * Sizes are in bytes.
+     */
+    class PartitionRequest
+    {
+    public:
+
+	PartitionRequest();
+	PartitionRequest(unsigned long long min_size, unsigned long long max_size,
+			 unsigned int weight = 1, PartitionType type = PartitionType::PRIMARY);
+
+	unsigned long long min_size;
+	unsigned long long max_size;
+
+	/**
+	 * Weight for distributing the space beyond the minimal sizes among
+	 * the partitions placed in the same unused region. Partitions with
+	 * weight 0 only get their minimal size.
+	 */
+	unsigned int weight;
+
+	/**
+	 * Either PRIMARY or LOGICAL.
+	 */
+	PartitionType type;
+    };
+
+
     // abstract class
 
     class PartitionTable : public Device
@@ -88,6 +117,22 @@ namespace storage
 	 */
 	Partition* create_partition(const std::string& name, const Region& region, PartitionType type);
 
+	/**
+	 * Creates partitions for all requests in one go. The partitions are
+	 * placed in the unused regions of the partition table in the order
+	 * of the requests (first fit with the minimal sizes). Afterwards the
+	 * remaining space of every unused region is distributed among its
+	 * partitions according to the weights up to the maximal sizes. All
+	 * partitions are aligned.
+	 *
+	 * Either all partitions are created or none. The partitions are
+	 * returned in the order of the requests.
+	 *
+	 * @throw Exception
+	 */
+	std::vector<Partition*> create_partitions(const std::vector<PartitionRequest>& requests,
+						  AlignType align_type = AlignType::OPTIMAL);
+
 	/**
 	 * Delete a partition in the partition table. Also deletes all
 	 * descendants of the partition.
@@ -137,6 +182,17 @@ namespace storage
 	std::vector<PartitionSlot> get_unused_partition_slots(AlignPolicy align_policy = AlignPolicy::KEEP_END,
 							      AlignType align_type = AlignType::OPTIMAL) const;
 
+	/**
+	 * Returns the unused partition slot with the largest aligned
+	 * region. If several slots have the same size the one with the
+	 * lowest start is returned, slots for primary partitions before
+	 * slots for logical partitions.
+	 *
+	 * @throw Exception
+	 */
+	PartitionSlot get_largest_unused_partition_slot(AlignPolicy align_policy = AlignPolicy::KEEP_END,
+							AlignType align_type = AlignType::OPTIMAL) const;
+
 	/**
 	 * region is sector-based.
 	 */
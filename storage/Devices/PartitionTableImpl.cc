@@ -32,7 +32,9 @@
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/AlignmentImpl.h"
+#include "storage/Utils/RegionIndex.h"
 #include "storage/Utils/Algorithm.h"
 #include "storage/Prober.h"
 #include "storage/Utils/StorageDefines.h"
@@ -52,12 +54,62 @@ namespace storage
     const char* DeviceTraits<PartitionTable>::classname = "PartitionTable";
 
 
+    struct PartitionTable::Impl::SlotIndex
+    {
+	SlotIndex(const PartitionTable::Impl& partition_table);
+
+	bool add(const Partition* partition);
+	bool remove(PartitionType type, const Region& region, unsigned int number);
+	bool resize(PartitionType type, const Region& old_region, const Region& new_region);
+
+	unsigned long long generation;
+
+	Region usable_region;
+
+	// The primary and extended partitions inside the usable region and the
+	// logical partitions inside the extended partition.
+	unique_ptr<RegionIndex> primary;
+	unique_ptr<RegionIndex> logical;
+
+	set<unsigned int> numbers;
+
+	unsigned int num_primary = 0;
+	unsigned int num_logical = 0;
+
+	unsigned int first_missing_number() const;
+    };
+
+
+    PartitionTable::Impl::Impl()
+	: Device::Impl(), read_only(false)
+    {
+    }
+
+
+    PartitionTable::Impl::Impl(const Impl& impl)
+	: Device::Impl(impl), read_only(impl.read_only)
+    {
+    }
+
+
     PartitionTable::Impl::Impl(const xmlNode* node)
 	: Device::Impl(node), read_only(false)
     {
     }
 
 
+    PartitionTable::Impl::Impl(BinaryReader& reader)
+	: Device::Impl(reader), read_only(false)
+    {
+	read_only = reader.get_bool();
+    }
+
+
+    PartitionTable::Impl::~Impl()
+    {
+    }
+
+
     void
     PartitionTable::Impl::probe_pass_1c(Prober& prober)
     {
@@ -89,6 +141,15 @@ namespace storage
     }
 
 
+    void
+    PartitionTable::Impl::save(BinaryWriter& writer) const
+    {
+	Device::Impl::save(writer);
+
+	writer.put_bool(read_only);
+    }
+
+
     void
     PartitionTable::Impl::check() const
     {
@@ -110,6 +171,8 @@ namespace storage
 
 	const Device* parent = type == PartitionType::LOGICAL ? get_extended() : get_non_impl();
 
+	bool slot_index_valid = has_valid_slot_index();
+
 	Partition* partition = Partition::create(get_devicegraph(), name, region, type);
 	Subdevice::create(get_devicegraph(), parent, partition);
 
@@ -118,6 +181,9 @@ namespace storage
 	if (boost::starts_with(name, DEVMAPPERDIR "/"))
 	    partition->set_dm_table_name(name.substr(strlen(DEVMAPPERDIR "/")));
 
+	if (slot_index_valid)
+	    keep_slot_index(slot_index->add(partition));
+
 	return partition;
     }
 
@@ -135,12 +201,246 @@ namespace storage
     }
 
 
+    namespace
+    {
+
+	/**
+	 * An unused region where create_partitions() places partitions.
+	 */
+	struct Bin
+	{
+	    Bin(const Region::Impl& region, bool logical)
+		: region(region), logical(logical), used(0) {}
+
+	    Region::Impl region;
+	    bool logical;
+
+	    vector<size_t> requests;
+	    unsigned long long used;
+
+	    // Logical partitions after the first one need space for the EBR
+	    // which costs one grain.
+	    unsigned long long cost(unsigned long long size, unsigned long long grain) const
+	    {
+		return size + (logical && !requests.empty() ? grain : 0);
+	    }
+	};
+
+    }
+
+
+    vector<Region::Impl>
+    PartitionTable::Impl::place_partitions(const vector<PartitionRequest>& requests,
+					   AlignType align_type) const
+    {
+	const SlotIndex& index = get_slot_index();
+	const Alignment alignment = get_alignment(align_type);
+
+	const unsigned int block_size = get_partitionable()->get_region().get_block_size();
+	const unsigned long long grain = max(alignment.get_impl().calculate_grain() / block_size, 1UL);
+
+	// Check the number of partitions.
+
+	unsigned int num_primary_requests = count_if(requests.begin(), requests.end(),
+	    [](const PartitionRequest& request) { return request.type == PartitionType::PRIMARY; });
+	unsigned int num_logical_requests = requests.size() - num_primary_requests;
+
+	if (index.num_primary + (index.logical ? 1 : 0) + num_primary_requests > max_primary())
+	    ST_THROW(Exception("too many primary partitions requested"));
+
+	if (num_logical_requests > 0 &&
+	    (!index.logical || index.num_logical + num_logical_requests > max_logical() - max_primary()))
+	    ST_THROW(Exception("too many logical partitions requested"));
+
+	// Collect the aligned unused regions.
+
+	vector<Bin> bins;
+
+	auto add_bins = [&](const RegionIndex& region_index, bool logical) {
+	    region_index.for_each_unused([&](Region::Impl region) {
+		if (align_unused_region(region, logical, alignment.get_impl(), AlignPolicy::ALIGN_END))
+		    bins.emplace_back(region, logical);
+		return true;
+	    });
+	};
+
+	add_bins(*index.primary, false);
+
+	if (index.logical)
+	    add_bins(*index.logical, true);
+
+	// Compute the minimal and maximal sizes in blocks as multiple of the
+	// grain.
+
+	vector<unsigned long long> sizes;
+	vector<unsigned long long> max_sizes;
+
+	for (const PartitionRequest& request : requests)
+	{
+	    if (request.type != PartitionType::PRIMARY && request.type != PartitionType::LOGICAL)
+		ST_THROW(Exception("invalid partition type in request"));
+
+	    if (request.min_size > request.max_size)
+		ST_THROW(Exception("minimal size larger than maximal size in request"));
+
+	    unsigned long long min_blocks = (request.min_size + block_size - 1) / block_size;
+	    min_blocks = max((min_blocks + grain - 1) / grain * grain, grain);
+
+	    unsigned long long max_blocks = request.max_size / block_size / grain * grain;
+
+	    sizes.push_back(min_blocks);
+	    max_sizes.push_back(max(max_blocks, min_blocks));
+	}
+
+	// Place the partitions with their minimal sizes (first fit).
+
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+	    bool logical = requests[i].type == PartitionType::LOGICAL;
+
+	    vector<Bin>::iterator it = find_if(bins.begin(), bins.end(), [&](const Bin& bin) {
+		return bin.logical == logical && bin.used + bin.cost(sizes[i], grain) <= bin.region.get_length();
+	    });
+
+	    if (it == bins.end())
+		ST_THROW(Exception(sformat("partition request %zu does not fit", i)));
+
+	    it->used += it->cost(sizes[i], grain);
+	    it->requests.push_back(i);
+	}
+
+	// Distribute the remaining space of every bin according to the
+	// weights. Every round either distributes all of the space (except
+	// for rounding) or caps at least one partition at its maximal size.
+
+	for (Bin& bin : bins)
+	{
+	    while (bin.region.get_length() - bin.used >= grain)
+	    {
+		unsigned long long extra = (bin.region.get_length() - bin.used) / grain;
+
+		unsigned long long total_weight = 0;
+		for (size_t i : bin.requests)
+		    if (sizes[i] < max_sizes[i])
+			total_weight += requests[i].weight;
+
+		if (total_weight == 0)
+		    break;
+
+		unsigned long long distributed = 0;
+
+		for (size_t i : bin.requests)
+		{
+		    if (sizes[i] == max_sizes[i] || requests[i].weight == 0)
+			continue;
+
+		    unsigned long long share = extra * requests[i].weight / total_weight;
+
+		    // Hand out the rest due to rounding one grain at a time.
+		    if (share == 0 && distributed < extra)
+			share = 1;
+
+		    share = min(share * grain, max_sizes[i] - sizes[i]);
+
+		    sizes[i] += share;
+		    distributed += share / grain;
+
+		    if (distributed >= extra)
+			break;
+		}
+
+		bin.used += distributed * grain;
+
+		if (distributed == 0)
+		    break;
+	    }
+	}
+
+	// Compute the regions.
+
+	vector<Region::Impl> regions(requests.size());
+
+	for (const Bin& bin : bins)
+	{
+	    unsigned long long start = bin.region.get_start();
+
+	    for (size_t n = 0; n < bin.requests.size(); ++n)
+	    {
+		size_t i = bin.requests[n];
+
+		if (bin.logical && n > 0)
+		    start += grain;
+
+		regions[i] = Region::Impl(start, sizes[i], block_size);
+
+		start += sizes[i];
+	    }
+	}
+
+	return regions;
+    }
+
+
+    vector<Partition*>
+    PartitionTable::Impl::create_partitions(const vector<PartitionRequest>& requests, AlignType align_type)
+    {
+	const vector<Region::Impl> regions = place_partitions(requests, align_type);
+
+	vector<Partition*> partitions;
+
+	try
+	{
+	    for (size_t i = 0; i < requests.size(); ++i)
+	    {
+		bool logical = requests[i].type == PartitionType::LOGICAL;
+
+		const SlotIndex& index = get_slot_index();
+
+		PartitionSlot slot = make_slot(index, logical);
+
+		if (!logical && get_type() == PtType::DASD)
+		{
+		    slot.number = index.primary->num_used_before(regions[i].get_start()) + 1;
+		    slot.name = get_partitionable()->get_impl().partition_name(slot.number);
+		}
+
+		if (!slot.is_possible(requests[i].type))
+		    ST_THROW(Exception("partition not possible"));
+
+		partitions.push_back(create_partition(slot.name, Region(regions[i]), requests[i].type));
+	    }
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+
+	    // Keep the partition table unchanged.
+
+	    for (vector<Partition*>::reverse_iterator it = partitions.rbegin(); it != partitions.rend(); ++it)
+		delete_partition(*it);
+
+	    ST_RETHROW(exception);
+	}
+
+	return partitions;
+    }
+
+
     void
     PartitionTable::Impl::delete_partition(Partition* partition)
     {
+	bool slot_index_valid = has_valid_slot_index();
+
+	PartitionType type = partition->get_type();
+	Region region = partition->get_region();
+	unsigned int number = partition->get_number();
+
 	partition->remove_descendants();
 
 	get_devicegraph()->remove_device(partition);
+
+	if (slot_index_valid)
+	    keep_slot_index(slot_index->remove(type, region, number));
     }
 
 
@@ -245,110 +545,271 @@ namespace storage
     }
 
 
-    vector<PartitionSlot>
-    PartitionTable::Impl::get_unused_partition_slots(AlignPolicy align_policy,
-						     AlignType align_type) const
+    PartitionTable::Impl::SlotIndex::SlotIndex(const PartitionTable::Impl& partition_table)
+	: usable_region(partition_table.get_usable_region())
     {
-	const Partitionable* partitionable = get_partitionable();
-	const Alignment alignment = get_alignment(align_type);
+	vector<Region> primary_regions;
+	vector<Region> logical_regions;
+	const Partition* extended = nullptr;
 
-	bool is_primary_possible = num_primary() + (has_extended() ? 1 : 0) < max_primary();
-	bool is_extended_possible = is_primary_possible && extended_possible() && !has_extended();
-	bool is_logical_possible = has_extended() && num_logical() < (max_logical() - max_primary());
+	for (const Partition* partition : partition_table.get_partitions())
+	{
+	    numbers.insert(partition->get_number());
 
-	vector<PartitionSlot> slots;
+	    switch (partition->get_type())
+	    {
+		case PartitionType::PRIMARY:
+		    ++num_primary;
+		    primary_regions.push_back(partition->get_region());
+		    break;
+
+		case PartitionType::EXTENDED:
+		    extended = partition;
+		    primary_regions.push_back(partition->get_region());
+		    break;
+
+		case PartitionType::LOGICAL:
+		    ++num_logical;
+		    logical_regions.push_back(partition->get_region());
+		    break;
+	    }
+	}
 
-	vector<const Partition*> partitions = get_partitions();
+	primary.reset(new RegionIndex(usable_region, primary_regions));
+
+	if (extended)
+	    logical.reset(new RegionIndex(extended->get_region(), logical_regions));
+
+	generation = partition_table.get_devicegraph()->get_impl().get_generation();
+    }
+
+
+    bool
+    PartitionTable::Impl::SlotIndex::add(const Partition* partition)
+    {
+	switch (partition->get_type())
+	{
+	    case PartitionType::PRIMARY:
+		if (!primary->add_used(partition->get_region()))
+		    return false;
+		++num_primary;
+		break;
+
+	    case PartitionType::LOGICAL:
+		if (!logical || !logical->add_used(partition->get_region()))
+		    return false;
+		++num_logical;
+		break;
+
+	    case PartitionType::EXTENDED:
+		return false;
+	}
+
+	numbers.insert(partition->get_number());
+
+	return true;
+    }
 
-	if (true)
+
+    bool
+    PartitionTable::Impl::SlotIndex::remove(PartitionType type, const Region& region, unsigned int number)
+    {
+	switch (type)
 	{
-	    PartitionSlot slot;
+	    case PartitionType::PRIMARY:
+		if (!primary->remove_used(region))
+		    return false;
+		--num_primary;
+		break;
+
+	    case PartitionType::LOGICAL:
+		if (!logical || !logical->remove_used(region))
+		    return false;
+		--num_logical;
+		break;
+
+	    case PartitionType::EXTENDED:
+		return false;
+	}
+
+	numbers.erase(number);
+
+	return true;
+    }
+
+
+    bool
+    PartitionTable::Impl::SlotIndex::resize(PartitionType type, const Region& old_region,
+					    const Region& new_region)
+    {
+	RegionIndex* region_index = type == PartitionType::PRIMARY ? primary.get() :
+	    type == PartitionType::LOGICAL ? logical.get() : nullptr;
+
+	return region_index && region_index->remove_used(old_region) &&
+	    region_index->add_used(new_region);
+    }
+
+
+    unsigned int
+    PartitionTable::Impl::SlotIndex::first_missing_number() const
+    {
+	unsigned int number = 1;
+
+	for (unsigned int tmp : numbers)
+	{
+	    if (tmp != number)
+		break;
+
+	    ++number;
+	}
+
+	return number;
+    }
+
+
+    bool
+    PartitionTable::Impl::has_valid_slot_index() const
+    {
+	return slot_index && slot_index->generation == get_devicegraph()->get_impl().get_generation() &&
+	    slot_index->usable_region == get_usable_region();
+    }
+
+
+    const PartitionTable::Impl::SlotIndex&
+    PartitionTable::Impl::get_slot_index() const
+    {
+	if (!has_valid_slot_index())
+	    slot_index.reset(new SlotIndex(*this));
+
+	return *slot_index;
+    }
+
+
+    void
+    PartitionTable::Impl::keep_slot_index(bool updated) const
+    {
+	if (updated)
+	    slot_index->generation = get_devicegraph()->get_impl().get_generation();
+	else
+	    slot_index.reset();
+    }
+
+
+    void
+    PartitionTable::Impl::slot_index_partition_resized(const Partition* partition,
+						       const Region& old_region) const
+    {
+	keep_slot_index(slot_index->resize(partition->get_type(), old_region, partition->get_region()));
+    }
+
+
+    PartitionSlot
+    PartitionTable::Impl::make_slot(const SlotIndex& index, bool logical) const
+    {
+	const Partitionable* partitionable = get_partitionable();
+
+	bool has_extended = index.logical != nullptr;
+
+	PartitionSlot slot;
+
+	if (!logical)
+	{
+	    bool is_primary_possible = index.num_primary + (has_extended ? 1 : 0) < max_primary();
 
 	    if (get_type() != PtType::DASD)
 	    {
-		slot.number = first_missing_number(partitions, 1);
-
+		slot.number = index.first_missing_number();
 		slot.name = partitionable->get_impl().partition_name(slot.number);
 	    }
 
 	    slot.primary_slot = true;
 	    slot.primary_possible = is_primary_possible;
 	    slot.extended_slot = extended_possible();
-	    slot.extended_possible = is_extended_possible;
+	    slot.extended_possible = is_primary_possible && extended_possible() && !has_extended;
 	    slot.logical_slot = false;
 	    slot.logical_possible = false;
+	}
+	else
+	{
+	    slot.number = max_primary() + index.num_logical + 1;
+	    slot.name = partitionable->get_impl().partition_name(slot.number);
 
-	    vector<Region> used_regions;
-	    for (const Partition* partition : partitions)
-	    {
-		if (partition->get_type() != PartitionType::LOGICAL)
-		    used_regions.push_back(partition->get_region());
-	    }
+	    slot.primary_slot = false;
+	    slot.primary_possible = false;
+	    slot.extended_slot = false;
+	    slot.extended_possible = false;
+	    slot.logical_slot = true;
+	    slot.logical_possible = has_extended && index.num_logical < (max_logical() - max_primary());
+	}
 
-	    Region usable_region = get_usable_region();
-	    for (const Region& unused_region : usable_region.unused_regions(used_regions))
-	    {
-		slot.region = unused_region;
+	return slot;
+    }
 
-		if (alignment.get_impl().align_region_in_place(slot.region, align_policy))
-		{
-		    // For DASDs the slot number is the number of partitions/used regions
-		    // before the slot.
 
-		    if (get_type() == PtType::DASD)
-		    {
-			slot.number = count_if(used_regions.begin(), used_regions.end(),
-					       [&slot](const Region& used_region) {
-						   return used_region < slot.region;
-					       }) + 1;
+    bool
+    PartitionTable::Impl::align_unused_region(Region::Impl& region, bool logical,
+					      const Alignment::Impl& alignment,
+					      AlignPolicy align_policy) const
+    {
+	if (logical)
+	{
+	    // Keep space for EBRs.
 
-			slot.name = partitionable->get_impl().partition_name(slot.number);
-		    }
+	    if (region.get_length() <= Msdos::Impl::num_ebrs)
+		return false;
 
-		    slots.push_back(slot);
-		}
-	    }
+	    region.adjust_start(+Msdos::Impl::num_ebrs);
+	    region.adjust_length(-Msdos::Impl::num_ebrs);
 	}
 
-	if (has_extended())
-	{
-	    PartitionSlot slot;
+	return alignment.align_region_in_place(region, align_policy);
+    }
 
-	    slot.number = max_primary() + num_logical() + 1;
-	    slot.name = partitionable->get_impl().partition_name(slot.number);
 
-	    slot.primary_slot = false;
-	    slot.primary_possible = false;
-	    slot.extended_slot = false;
-	    slot.extended_possible = false;
-	    slot.logical_slot = true;
-	    slot.logical_possible = is_logical_possible;
+    vector<PartitionSlot>
+    PartitionTable::Impl::get_unused_partition_slots(AlignPolicy align_policy,
+						     AlignType align_type) const
+    {
+	const SlotIndex& index = get_slot_index();
+	const Alignment alignment = get_alignment(align_type);
 
-	    vector<Region> used_regions;
-	    for (const Partition* partition : partitions)
-	    {
-		if (partition->get_type() == PartitionType::LOGICAL)
-		    used_regions.push_back(partition->get_region());
-	    }
+	vector<PartitionSlot> slots;
 
-	    const Region& extended_region = get_extended()->get_region();
-	    for (const Region& unused_region : extended_region.unused_regions(used_regions))
+	PartitionSlot slot = make_slot(index, false);
+
+	index.primary->for_each_unused([&](Region::Impl region) {
+	    if (align_unused_region(region, false, alignment.get_impl(), align_policy))
 	    {
-		// Keep space for EBRs.
+		slot.region.get_impl() = region;
 
-		if (unused_region.get_length() <= Msdos::Impl::num_ebrs)
-		    continue;
+		// For DASDs the slot number is the number of partitions/used regions
+		// before the slot.
 
-		Region adjusted_region = unused_region;
-		adjusted_region.adjust_start(+Msdos::Impl::num_ebrs);
-		adjusted_region.adjust_length(-Msdos::Impl::num_ebrs);
+		if (get_type() == PtType::DASD)
+		{
+		    slot.number = index.primary->num_used_before(region.get_start()) + 1;
+		    slot.name = get_partitionable()->get_impl().partition_name(slot.number);
+		}
+
+		slots.push_back(slot);
+	    }
+
+	    return true;
+	});
+
+	if (index.logical)
+	{
+	    slot = make_slot(index, true);
 
-		slot.region = adjusted_region;
-		if (alignment.get_impl().align_region_in_place(slot.region, align_policy))
+	    index.logical->for_each_unused([&](Region::Impl region) {
+		if (align_unused_region(region, true, alignment.get_impl(), align_policy))
 		{
+		    slot.region.get_impl() = region;
 		    slots.push_back(slot);
 		}
-	    }
+
+		return true;
+	    });
 	}
 
 	y2deb("slots:" << slots);
@@ -357,6 +818,63 @@ namespace storage
     }
 
 
+    PartitionSlot
+    PartitionTable::Impl::get_largest_unused_partition_slot(AlignPolicy align_policy,
+							    AlignType align_type) const
+    {
+	const SlotIndex& index = get_slot_index();
+	const Alignment alignment = get_alignment(align_type);
+
+	const RegionIndex* best_index = nullptr;
+	Region::Impl best_region;
+
+	// Aligning never enlarges a region so the search can stop as soon as
+	// an unused region is not larger than the best aligned region.
+
+	auto search = [&](const RegionIndex* region_index) {
+	    bool logical = region_index == index.logical.get();
+
+	    region_index->for_each_unused_by_length([&](Region::Impl region) {
+		if (best_index && region.get_length() <= best_region.get_length())
+		    return false;
+
+		if (align_unused_region(region, logical, alignment.get_impl(), align_policy) &&
+		    (!best_index || region.get_length() > best_region.get_length()))
+		{
+		    best_index = region_index;
+		    best_region = region;
+		}
+
+		return true;
+	    });
+	};
+
+	search(index.primary.get());
+
+	if (index.logical)
+	    search(index.logical.get());
+
+	if (!best_index)
+	    ST_THROW(Exception("no unused partition slot"));
+
+	PartitionSlot slot = make_slot(index, best_index == index.logical.get());
+	slot.region.get_impl() = best_region;
+
+	// For DASDs the slot number is the number of partitions/used regions
+	// before the slot.
+
+	if (slot.primary_slot && get_type() == PtType::DASD)
+	{
+	    slot.number = index.primary->num_used_before(best_region.get_start()) + 1;
+	    slot.name = get_partitionable()->get_impl().partition_name(slot.number);
+	}
+
+	y2deb("largest slot:" << slot);
+
+	return slot;
+    }
+
+
     Region
     PartitionTable::Impl::align(const Region& region, AlignPolicy align_policy,
 				AlignType align_type) const
@@ -25,6 +25,8 @@
 #define STORAGE_PARTITION_TABLE_IMPL_H
 
 
+#include <memory>
+
 #include "storage/Devices/PartitionTable.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Utils/Enum.h"
@@ -57,6 +59,8 @@ namespace storage
 
 	virtual Partition* create_partition(const string& name, const Region& region, PartitionType type);
 
+	vector<Partition*> create_partitions(const vector<PartitionRequest>& requests, AlignType align_type);
+
 	virtual void delete_partition(Partition* partition);
 
 	void delete_partition(const string& name);
@@ -130,6 +134,18 @@ namespace storage
 	vector<PartitionSlot> get_unused_partition_slots(AlignPolicy align_policy,
 							 AlignType align_type) const;
 
+	PartitionSlot get_largest_unused_partition_slot(AlignPolicy align_policy,
+							AlignType align_type) const;
+
+	/**
+	 * Updates the slot index after the region of a partition changed, see
+	 * get_slot_index(). Must only be called if has_valid_slot_index()
+	 * was true before the change.
+	 */
+	void slot_index_partition_resized(const Partition* partition, const Region& old_region) const;
+
+	bool has_valid_slot_index() const;
+
 	Region align(const Region& region, AlignPolicy align_policy, AlignType align_type) const;
 
 	static void run_dependency_manager(Actiongraph::Impl& actiongraph);
@@ -138,17 +154,64 @@ namespace storage
 
     protected:
 
-	Impl()
-	    : Device::Impl(), read_only(false) {}
+	Impl();
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	// The slot index is not copied.
+	Impl(const Impl& impl);
+
+	virtual ~Impl();
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
     private:
 
 	bool read_only;
 
+	/**
+	 * Index of the partitions and the unused regions of the partition
+	 * table. Built on demand and kept up-to-date when partitions are
+	 * created, deleted or resized. Any other modification of the
+	 * devicegraph invalidates the index, see
+	 * Devicegraph::Impl::get_generation().
+	 */
+	struct SlotIndex;
+
+	mutable std::unique_ptr<SlotIndex> slot_index;
+
+	const SlotIndex& get_slot_index() const;
+
+	/**
+	 * Keeps the slot index after a successful update, otherwise drops it.
+	 */
+	void keep_slot_index(bool updated) const;
+
+	/**
+	 * Returns a slot with the number and flags for primary or logical
+	 * slots. The region is not set.
+	 */
+	PartitionSlot make_slot(const SlotIndex& index, bool logical) const;
+
+	/**
+	 * Aligns an unused region in place for a slot. The region of logical
+	 * slots is adjusted for the EBR. Returns false if no aligned region
+	 * exists.
+	 */
+	bool align_unused_region(Region::Impl& region, bool logical, const Alignment::Impl& alignment,
+				 AlignPolicy align_policy) const;
+
+	/**
+	 * Computes the regions for create_partitions() without modifying
+	 * the devicegraph.
+	 *
+	 * @throw Exception
+	 */
+	vector<Region::Impl> place_partitions(const vector<PartitionRequest>& requests,
+					      AlignType align_type) const;
+
     };
 
 }
@@ -32,6 +32,7 @@
 #include "storage/Devicegraph.h"
 #include "storage/Action.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/Enum.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/StorageDefines.h"
@@ -60,6 +61,14 @@ namespace storage
     }
 
 
+    Partitionable::Impl::Impl(BinaryReader& reader)
+	: BlkDevice::Impl(reader), topology(), range(0)
+    {
+	topology = reader.get_topology();
+	range = reader.get_u32();
+    }
+
+
     void
     Partitionable::Impl::save(xmlNode* node) const
     {
@@ -70,6 +79,16 @@ namespace storage
     }
 
 
+    void
+    Partitionable::Impl::save(BinaryWriter& writer) const
+    {
+	BlkDevice::Impl::save(writer);
+
+	writer.put_topology(topology);
+	writer.put_u32(range);
+    }
+
+
     void
     Partitionable::Impl::probe_pass_1a(Prober& prober)
     {
@@ -83,8 +83,10 @@ namespace storage
 	    : BlkDevice::Impl(name, region), topology(), range(range) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
     private:
 
@@ -37,8 +37,9 @@ namespace storage
 	STANDARD_WRITE_DEVICEGRAPH,	// probe system during init, write devicegraph
 	STANDARD_WRITE_MOCKUP,		// probe system during init, write mockup
 	NONE,				// no probing - for testsuite
-	READ_DEVICEGRAPH,		// fake probe - for testsuite
-	READ_MOCKUP			// fake probe - for testsuite
+	READ_DEVICEGRAPH,		// fake probe - for testsuite, xml or binary devicegraph
+	READ_MOCKUP,			// fake probe - for testsuite
+	STANDARD_WRITE_DEVICEGRAPH_BINARY // probe system during init, write binary devicegraph
     };
 
     //! Is the target a disk, chroot, or image?
@@ -71,7 +71,7 @@ namespace storage
 
     const vector<string> EnumTraits<ProbeMode>::names({
 	"STANDARD", "STANDARD_WRITE_DEVICEGRAPH", "STANDARD_WRITE_MOCKUP", "NONE",
-	"READ_DEVICEGRAPH", "READ_MOCKUP"
+	"READ_DEVICEGRAPH", "READ_MOCKUP", "STANDARD_WRITE_DEVICEGRAPH_BINARY"
     });
 
 
@@ -53,7 +53,7 @@ namespace storage
     bool
     EtcMdadm::has_entry(const string& uuid) const
     {
-	return find_array(uuid) != mdadm.get_lines().end();
+	return find_array(uuid) != mdadm.get_line_buffer().size();
     }
 
 
@@ -87,15 +87,15 @@ namespace storage
 	    return false;
 	}
 
-	vector<string>& lines = mdadm.get_lines();
-	vector<string>::iterator it = find_array(uuid);
-	if (it == lines.end())
+	size_t i = find_array(uuid);
+	if (i == mdadm.get_line_buffer().size())
 	{
 	    y2war("line not found");
 	    return false;
 	}
 
-	lines.erase(it);
+	vector<string>& lines = mdadm.get_lines();
+	lines.erase(lines.begin() + i);
 
 	mdadm.save();
 
@@ -106,36 +106,39 @@ namespace storage
     void
     EtcMdadm::set_device_line(const string& line)
     {
+	size_t i = find_line("DEVICE");
+
 	vector<string>& lines = mdadm.get_lines();
-	vector<string>::iterator it = find_if(lines, string_starts_with("DEVICE"));
-	if (it == lines.end())
+	if (i == lines.size())
 	    lines.insert(lines.begin(), line);
 	else
-	    *it = line;
+	    lines[i] = line;
     }
 
 
     void
     EtcMdadm::set_auto_line(const string& line)
     {
+	size_t i = find_line("AUTO");
+
 	vector<string>& lines = mdadm.get_lines();
-	vector<string>::iterator it = find_if(lines, string_starts_with("AUTO"));
-	if (it == lines.end())
+	if (i == lines.size())
 	    lines.insert(lines.begin(), line);
 	else
-	    *it = line;
+	    lines[i] = line;
     }
 
 
     void
     EtcMdadm::set_array_line(const string& line, const string& uuid)
     {
+	size_t i = find_array(uuid);
+
 	vector<string>& lines = mdadm.get_lines();
-	vector<string>::iterator it = find_array(uuid);
-	if (it == lines.end())
+	if (i == lines.size())
 	    lines.push_back(line);
 	else
-	    *it = line;
+	    lines[i] = line;
     }
 
 
@@ -162,52 +165,47 @@ namespace storage
     }
 
 
-    vector<string>::iterator
-    EtcMdadm::find_array(const string& uuid)
+    size_t
+    EtcMdadm::find_line(const string& prefix) const
     {
-	vector<string>& lines = mdadm.get_lines();
-	for (vector<string>::iterator it = lines.begin(); it != lines.end(); ++it)
+	const LineBuffer& lines = mdadm.get_line_buffer();
+	for (size_t i = 0; i < lines.size(); ++i)
 	{
-	    if (boost::starts_with(*it, "ARRAY"))
-	    {
-		string tmp = get_uuid(*it);
-		if (!tmp.empty() && tmp == uuid)
-		    return it;
-	    }
+	    if (lines[i].starts_with(prefix))
+		return i;
 	}
 
-	return lines.end();
+	return lines.size();
     }
 
 
-    vector<string>::const_iterator
+    size_t
     EtcMdadm::find_array(const string& uuid) const
     {
-	const vector<string>& lines = mdadm.get_lines();
-	for (vector<string>::const_iterator it = lines.begin(); it != lines.end(); ++it)
+	const LineBuffer& lines = mdadm.get_line_buffer();
+	for (size_t i = 0; i < lines.size(); ++i)
 	{
-	    if (boost::starts_with(*it, "ARRAY"))
+	    if (lines[i].starts_with("ARRAY"))
 	    {
-		string tmp = get_uuid(*it);
+		string tmp = get_uuid(lines[i]);
 		if (!tmp.empty() && tmp == uuid)
-		    return it;
+		    return i;
 	    }
 	}
 
-	return lines.end();
+	return lines.size();
     }
 
 
     string
-    EtcMdadm::get_uuid(const string& line) const
+    EtcMdadm::get_uuid(boost::string_ref line) const
     {
-	string::size_type pos1 = line.find("UUID=");
-	if (pos1 == string::npos)
+	boost::string_ref::size_type pos = line.find("UUID=");
+	if (pos == boost::string_ref::npos)
 	    return "";
 
-	pos1 += 5;
-	string::size_type pos2 = line.find_first_not_of("0123456789abcdefABCDEF:", pos1);
-	return line.substr(pos1, pos2 - pos1);
+	line.remove_prefix(pos + 5);
+	return line.substr(0, line.find_first_not_of("0123456789abcdefABCDEF:")).to_string();
     }
 
 
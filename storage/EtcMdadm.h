@@ -80,10 +80,19 @@ namespace storage
 
 	string array_line(const Entry& entry) const;
 
-	vector<string>::iterator find_array(const string& uuid);
-	vector<string>::const_iterator find_array(const string& uuid) const;
+	/**
+	 * Return the index of the line starting with prefix or the number of
+	 * lines if there is none.
+	 */
+	size_t find_line(const string& prefix) const;
+
+	/**
+	 * Return the index of the ARRAY line with the uuid or the number of
+	 * lines if there is none.
+	 */
+	size_t find_array(const string& uuid) const;
 
-	string get_uuid(const string& line) const;
+	string get_uuid(boost::string_ref line) const;
 
 	bool has_iscsi(const Storage* storage) const;
 
@@ -26,6 +26,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/Enum.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/StorageDefines.h"
@@ -72,6 +73,34 @@ namespace storage
     }
 
 
+    BlkFilesystem::Impl::Impl(BinaryReader& reader)
+	: Filesystem::Impl(reader), label(), uuid(), mkfs_options(), tune_options(), resize_info(),
+	  content_info()
+    {
+	label = reader.get_string();
+	uuid = reader.get_string();
+
+	mkfs_options = reader.get_string();
+	tune_options = reader.get_string();
+
+	if (reader.get_bool())
+	{
+	    bool resize_ok = reader.get_bool();
+	    unsigned long long min_size = reader.get_u64();
+	    unsigned long long max_size = reader.get_u64();
+	    resize_info.set_value(ResizeInfo(resize_ok, min_size, max_size));
+	}
+
+	if (reader.get_bool())
+	{
+	    bool is_windows = reader.get_bool();
+	    bool is_efi = reader.get_bool();
+	    unsigned num_homes = reader.get_u32();
+	    content_info.set_value(ContentInfo(is_windows, is_efi, num_homes));
+	}
+    }
+
+
     void
     BlkFilesystem::Impl::set_label(const string& label)
     {
@@ -137,6 +166,35 @@ namespace storage
     }
 
 
+    void
+    BlkFilesystem::Impl::save(BinaryWriter& writer) const
+    {
+	Filesystem::Impl::save(writer);
+
+	writer.put_string(label);
+	writer.put_string(uuid);
+
+	writer.put_string(mkfs_options);
+	writer.put_string(tune_options);
+
+	writer.put_bool(resize_info.has_value());
+	if (resize_info.has_value())
+	{
+	    writer.put_bool(resize_info.get_value().resize_ok);
+	    writer.put_u64(resize_info.get_value().min_size);
+	    writer.put_u64(resize_info.get_value().max_size);
+	}
+
+	writer.put_bool(content_info.has_value());
+	if (content_info.has_value())
+	{
+	    writer.put_bool(content_info.get_value().is_windows);
+	    writer.put_bool(content_info.get_value().is_efi);
+	    writer.put_u32(content_info.get_value().num_homes);
+	}
+    }
+
+
     void
     BlkFilesystem::Impl::probe_pass_2(Prober& prober)
     {
@@ -130,8 +130,10 @@ namespace storage
 	    {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
 	virtual void probe_uuid();
 
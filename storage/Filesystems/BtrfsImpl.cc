@@ -65,6 +65,23 @@ namespace storage
     }
 
 
+    Btrfs::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+        , configure_snapper(false)
+        , snapper_config(nullptr)
+    {
+    }
+
+
+    Btrfs*
+    Btrfs::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Btrfs* ret = new Btrfs(new Btrfs::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     Btrfs::Impl::~Impl()
     {
         if (snapper_config)
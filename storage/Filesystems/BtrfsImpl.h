@@ -84,6 +84,9 @@ namespace storage
         virtual ~Impl();
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Btrfs* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual void check() const override;
 
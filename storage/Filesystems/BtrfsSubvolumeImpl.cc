@@ -23,12 +23,14 @@
 #include <iostream>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Filesystems/BtrfsSubvolumeImpl.h"
 #include "storage/Filesystems/BtrfsImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Devicegraph.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/BtrfsUtils.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/EtcFstab.h"
@@ -65,6 +67,26 @@ namespace storage
     }
 
 
+    BtrfsSubvolume::Impl::Impl(BinaryReader& reader)
+	: Mountable::Impl(reader), id(unknown_id), path(), default_btrfs_subvolume(false), nocow(false)
+    {
+	id = reader.get_i64();
+	path = reader.get_string();
+
+	default_btrfs_subvolume = reader.get_bool();
+	nocow = reader.get_bool();
+    }
+
+
+    BtrfsSubvolume*
+    BtrfsSubvolume::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	BtrfsSubvolume* ret = new BtrfsSubvolume(new BtrfsSubvolume::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     BtrfsSubvolume::Impl::save(xmlNode* node) const
     {
@@ -78,6 +100,19 @@ namespace storage
     }
 
 
+    void
+    BtrfsSubvolume::Impl::save(BinaryWriter& writer) const
+    {
+	Mountable::Impl::save(writer);
+
+	writer.put_i64(id);
+	writer.put_string(path);
+
+	writer.put_bool(default_btrfs_subvolume);
+	writer.put_bool(nocow);
+    }
+
+
     string
     BtrfsSubvolume::Impl::get_displayname() const
     {
@@ -407,7 +442,10 @@ namespace storage
 	// e.g. when creating <fs-tree>/a/b it is enough when subvol=a is
 	// mounted somewhere.
 
-	// TODO Just do one mount if several subvolumes get created.
+	// With a sequential commit consecutive actions on subvolumes share
+	// the mount, see Actiongraph::Impl::commit_sequential(). If possible
+	// the subvolume is created with an ioctl to avoid running btrfs for
+	// each subvolume.
 
 	EnsureMounted ensure_mounted(top_level, false);
 
@@ -417,14 +455,23 @@ namespace storage
 	if (access(full_dirname.c_str(), R_OK) != 0)
 	    createPath(full_dirname);
 
-	string cmd_line = BTRFSBIN " subvolume create " + quote(full_path);
-	cout << cmd_line << endl;
+	if (btrfs_use_ioctls())
+	{
+	    btrfs_create_subvolume(full_path);
+
+	    id = btrfs_subvolume_id(full_path);
+	}
+	else
+	{
+	    string cmd_line = BTRFSBIN " subvolume create " + quote(full_path);
+	    cout << cmd_line << endl;
 
-	SystemCmd cmd(cmd_line);
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("create BtrfsSubvolume failed"));
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() != 0)
+		ST_THROW(Exception("create BtrfsSubvolume failed"));
 
-	probe_id(ensure_mounted.get_any_mount_point());
+	    probe_id(ensure_mounted.get_any_mount_point());
+	}
     }
 
 
@@ -543,13 +590,20 @@ namespace storage
 
 	EnsureMounted ensure_mounted(top_level, false);
 
-	string cmd_line = CHATTRBIN " " + string(nocow ? "+" : "-") + "C " +
-	    quote(ensure_mounted.get_any_mount_point() + "/" + path);
-	cout << cmd_line << endl;
+	if (btrfs_use_ioctls())
+	{
+	    btrfs_set_nocow(ensure_mounted.get_any_mount_point() + "/" + path, nocow);
+	}
+	else
+	{
+	    string cmd_line = CHATTRBIN " " + string(nocow ? "+" : "-") + "C " +
+		quote(ensure_mounted.get_any_mount_point() + "/" + path);
+	    cout << cmd_line << endl;
 
-	SystemCmd cmd(cmd_line);
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("set nocow failed"));
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() != 0)
+		ST_THROW(Exception("set nocow failed"));
+	}
     }
 
 
@@ -579,13 +633,20 @@ namespace storage
 
 	EnsureMounted ensure_mounted(top_level, false);
 
-	string cmd_line = BTRFSBIN " subvolume set-default " + to_string(id) + " " +
-	    quote(ensure_mounted.get_any_mount_point());
-	cout << cmd_line << endl;
+	if (btrfs_use_ioctls())
+	{
+	    btrfs_set_default_subvolume(ensure_mounted.get_any_mount_point(), id);
+	}
+	else
+	{
+	    string cmd_line = BTRFSBIN " subvolume set-default " + to_string(id) + " " +
+		quote(ensure_mounted.get_any_mount_point());
+	    cout << cmd_line << endl;
 
-	SystemCmd cmd(cmd_line);
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("set default btrfs subvolume failed"));
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() != 0)
+		ST_THROW(Exception("set default btrfs subvolume failed"));
+	}
     }
 
 
@@ -615,13 +676,20 @@ namespace storage
 
 	EnsureMounted ensure_mounted(top_level, false);
 
-	string cmd_line = BTRFSBIN " subvolume delete " +
-	    quote(ensure_mounted.get_any_mount_point() + "/" + path);
-	cout << cmd_line << endl;
+	if (btrfs_use_ioctls())
+	{
+	    btrfs_delete_subvolume(ensure_mounted.get_any_mount_point() + "/" + path);
+	}
+	else
+	{
+	    string cmd_line = BTRFSBIN " subvolume delete " +
+		quote(ensure_mounted.get_any_mount_point() + "/" + path);
+	    cout << cmd_line << endl;
 
-	SystemCmd cmd(cmd_line);
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("delete BtrfsSubvolume failed"));
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() != 0)
+		ST_THROW(Exception("delete BtrfsSubvolume failed"));
+	}
     }
 
 
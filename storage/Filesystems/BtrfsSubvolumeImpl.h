@@ -51,6 +51,9 @@ namespace storage
 	    : Mountable::Impl(), id(unknown_id), path(path), default_btrfs_subvolume(false), nocow(false) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static BtrfsSubvolume* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<BtrfsSubvolume>::classname; }
 
@@ -132,6 +135,7 @@ namespace storage
     protected:
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
 	void probe_id(const string& mount_point);
 
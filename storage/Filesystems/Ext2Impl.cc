@@ -42,6 +42,21 @@ namespace storage
     }
 
 
+    Ext2::Impl::Impl(BinaryReader& reader)
+	: Ext::Impl(reader)
+    {
+    }
+
+
+    Ext2*
+    Ext2::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Ext2* ret = new Ext2(new Ext2::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     uint64_t
     Ext2::Impl::used_features() const
     {
@@ -47,6 +47,9 @@ namespace storage
 	    : Ext::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Ext2* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual FsType get_type() const override { return FsType::EXT2; }
 
@@ -42,6 +42,21 @@ namespace storage
     }
 
 
+    Ext3::Impl::Impl(BinaryReader& reader)
+	: Ext::Impl(reader)
+    {
+    }
+
+
+    Ext3*
+    Ext3::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Ext3* ret = new Ext3(new Ext3::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     uint64_t
     Ext3::Impl::used_features() const
     {
@@ -47,6 +47,9 @@ namespace storage
 	    : Ext::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Ext3* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual unsigned long long min_size() const override { return 10 * MiB; }
 	virtual unsigned long long max_size() const override { return 4 * TiB; }
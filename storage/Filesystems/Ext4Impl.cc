@@ -42,6 +42,21 @@ namespace storage
     }
 
 
+    Ext4::Impl::Impl(BinaryReader& reader)
+	: Ext::Impl(reader)
+    {
+    }
+
+
+    Ext4*
+    Ext4::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Ext4* ret = new Ext4(new Ext4::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     uint64_t
     Ext4::Impl::used_features() const
     {
@@ -47,6 +47,9 @@ namespace storage
 	    : Ext::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Ext4* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual unsigned long long min_size() const override { return 32 * MiB; }
 	virtual unsigned long long max_size() const override { return 16 * TiB; }
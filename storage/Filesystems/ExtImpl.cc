@@ -48,6 +48,12 @@ namespace storage
     }
 
 
+    Ext::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
     void
     Ext::Impl::probe_pass_2(Prober& prober)
     {
@@ -59,6 +59,7 @@ namespace storage
 	    : BlkFilesystem::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<Ext>::classname; }
 
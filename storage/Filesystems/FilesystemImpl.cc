@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/Enum.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/StorageDefines.h"
@@ -55,6 +56,18 @@ namespace storage
     }
 
 
+    Filesystem::Impl::Impl(BinaryReader& reader)
+	: Mountable::Impl(reader)
+    {
+	if (reader.get_bool())
+	{
+	    unsigned long long size = reader.get_u64();
+	    unsigned long long used = reader.get_u64();
+	    space_info.set_value(SpaceInfo(size, used));
+	}
+    }
+
+
     void
     Filesystem::Impl::save(xmlNode* node) const
     {
@@ -68,6 +81,20 @@ namespace storage
     }
 
 
+    void
+    Filesystem::Impl::save(BinaryWriter& writer) const
+    {
+	Mountable::Impl::save(writer);
+
+	writer.put_bool(space_info.has_value());
+	if (space_info.has_value())
+	{
+	    writer.put_u64(space_info.get_value().size);
+	    writer.put_u64(space_info.get_value().used);
+	}
+    }
+
+
     bool
     Filesystem::Impl::equal(const Device::Impl& rhs_base) const
     {
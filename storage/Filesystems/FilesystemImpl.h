@@ -70,8 +70,10 @@ namespace storage
 	Impl() : Mountable::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
     private:
 
@@ -38,4 +38,19 @@ namespace storage
     {
     }
 
+
+    Iso9660::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
+    Iso9660*
+    Iso9660::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Iso9660* ret = new Iso9660(new Iso9660::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
 }
@@ -60,6 +60,9 @@ namespace storage
 	    : BlkFilesystem::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Iso9660* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual FsType get_type() const override { return FsType::ISO9660; }
 
@@ -24,6 +24,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Filesystems/BtrfsImpl.h"
 #include "storage/Devicegraph.h"
@@ -75,6 +76,34 @@ namespace storage
     }
 
 
+    MountPoint::Impl::Impl(BinaryReader& reader)
+	: Device::Impl(reader), path(), mount_by(MountByType::DEVICE), freq(0), passno(0),
+	  active(true), in_etc_fstab(true)
+    {
+	path = reader.get_string();
+
+	mount_by = toValueWithFallback(reader.get_string(), MountByType::DEVICE);
+
+	const string& tmp = reader.get_string();
+	if (!tmp.empty())
+	    mount_options.parse(tmp);
+
+	in_etc_fstab = reader.get_bool();
+
+	freq = reader.get_i64();
+	passno = reader.get_i64();
+    }
+
+
+    MountPoint*
+    MountPoint::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	MountPoint* ret = new MountPoint(new MountPoint::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     MountPoint::Impl::save(xmlNode* node) const
     {
@@ -94,6 +123,24 @@ namespace storage
     }
 
 
+    void
+    MountPoint::Impl::save(BinaryWriter& writer) const
+    {
+	Device::Impl::save(writer);
+
+	writer.put_string(path);
+
+	writer.put_string(toString(mount_by));
+
+	writer.put_string(mount_options.format());
+
+	writer.put_bool(in_etc_fstab);
+
+	writer.put_i64(freq);
+	writer.put_i64(passno);
+    }
+
+
     void
     MountPoint::Impl::check() const
     {
@@ -45,6 +45,9 @@ namespace storage
 	Impl(const string& path);
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static MountPoint* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual const char* get_classname() const override { return DeviceTraits<MountPoint>::classname; }
 
@@ -127,6 +130,7 @@ namespace storage
     protected:
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
 	virtual void check() const override;
 
@@ -190,6 +194,8 @@ namespace storage
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data) const override;
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	    const string& get_path(Actiongraph::Impl& actiongraph) const;
 
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
@@ -207,6 +213,8 @@ namespace storage
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data) const override;
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	};
 
 
@@ -219,6 +227,8 @@ namespace storage
 	    virtual Text text(const CommitData& commit_data) const override;
 	    virtual void commit(CommitData& commit_data) const override;
 
+	    virtual bool modifies_etc_files() const override { return true; }
+
 	};
 
     }
@@ -69,6 +69,12 @@ namespace storage
     }
 
 
+    Mountable::Impl::Impl(BinaryReader& reader)
+	: Device::Impl(reader)
+    {
+    }
+
+
     void
     Mountable::Impl::save(xmlNode* node) const
     {
@@ -76,6 +82,13 @@ namespace storage
     }
 
 
+    void
+    Mountable::Impl::save(BinaryWriter& writer) const
+    {
+	Device::Impl::save(writer);
+    }
+
+
     MountPoint*
     Mountable::Impl::create_mount_point(const string& path)
     {
@@ -403,13 +416,11 @@ namespace storage
 	if (is_blk_filesystem(mountable))
 	{
 	    const BlkFilesystem* blk_filesystem = to_blk_filesystem(mountable);
-	    for (const BlkDevice* blk_device : blk_filesystem->get_blk_devices())
-		blk_device->get_impl().wait_for_device();
+	    BlkDevice::Impl::wait_for_devices(blk_filesystem->get_blk_devices());
 	}
 
-        tmp_mount.reset(new TmpMount(storage->get_impl().get_tmp_dir().get_fullname(),
-				     "tmp-mount-XXXXXX", mountable->get_impl().get_mount_name(),
-				     read_only, mountable->get_impl().get_mount_options()));
+	tmp_mount = storage->get_impl().get_tmp_mount(mountable->get_impl().get_mount_name(), read_only,
+						      mountable->get_impl().get_mount_options());
     }
 
 
@@ -123,8 +123,10 @@ namespace storage
 	    {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
     };
 
@@ -137,7 +139,8 @@ namespace storage
 	/**
 	 * Ensures that the blk mountable is mounted somewhere.
 	 *
-	 * The mode is not enforced.
+	 * The mode is not enforced. Temporary mounts are shared, see
+	 * Storage::Impl::get_tmp_mount().
 	 */
 	EnsureMounted(const Mountable* mountable, bool read_only = true);
 
@@ -152,7 +155,7 @@ namespace storage
 
 	const Mountable* mountable;
 
-	unique_ptr<TmpMount> tmp_mount;
+	std::shared_ptr<TmpMount> tmp_mount;
 
     };
 
@@ -24,6 +24,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Filesystems/NfsImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Devicegraph.h"
@@ -58,6 +59,23 @@ namespace storage
     }
 
 
+    Nfs::Impl::Impl(BinaryReader& reader)
+	: Filesystem::Impl(reader), server(), path()
+    {
+	server = reader.get_string();
+	path = reader.get_string();
+    }
+
+
+    Nfs*
+    Nfs::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Nfs* ret = new Nfs(new Nfs::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Nfs::Impl::save(xmlNode* node) const
     {
@@ -68,6 +86,16 @@ namespace storage
     }
 
 
+    void
+    Nfs::Impl::save(BinaryWriter& writer) const
+    {
+	Filesystem::Impl::save(writer);
+
+	writer.put_string(server);
+	writer.put_string(path);
+    }
+
+
     bool
     Nfs::Impl::is_valid_name(const string& name)
     {
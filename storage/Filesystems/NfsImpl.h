@@ -45,6 +45,9 @@ namespace storage
 	    : Filesystem::Impl(), server(server), path(path) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Nfs* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual FsType get_type() const override { return FsType::NFS; }
 
@@ -82,6 +85,7 @@ namespace storage
     protected:
 
 	void save(xmlNode* node) const override;
+	void save(BinaryWriter& writer) const override;
 
     private:
 
@@ -50,6 +50,21 @@ namespace storage
     }
 
 
+    Ntfs::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
+    Ntfs*
+    Ntfs::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Ntfs* ret = new Ntfs(new Ntfs::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     ResizeInfo
     Ntfs::Impl::detect_resize_info_on_disk() const
     {
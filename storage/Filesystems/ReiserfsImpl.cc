@@ -46,6 +46,21 @@ namespace storage
     }
 
 
+    Reiserfs::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
+    Reiserfs*
+    Reiserfs::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Reiserfs* ret = new Reiserfs(new Reiserfs::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     uint64_t
     Reiserfs::Impl::used_features() const
     {
@@ -60,6 +60,9 @@ namespace storage
 	    : BlkFilesystem::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Reiserfs* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual FsType get_type() const override { return FsType::REISERFS; }
 
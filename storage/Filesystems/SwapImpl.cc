@@ -50,6 +50,21 @@ namespace storage
     }
 
 
+    Swap::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
+    Swap*
+    Swap::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Swap* ret = new Swap(new Swap::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     ResizeInfo
     Swap::Impl::detect_resize_info() const
     {
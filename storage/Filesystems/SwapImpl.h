@@ -61,6 +61,9 @@ namespace storage
 	    : BlkFilesystem::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Swap* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual FsType get_type() const override { return FsType::SWAP; }
 
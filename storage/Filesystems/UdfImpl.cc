@@ -38,4 +38,19 @@ namespace storage
     {
     }
 
+
+    Udf::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
+    Udf*
+    Udf::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Udf* ret = new Udf(new Udf::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
 }
@@ -47,6 +47,21 @@ namespace storage
     }
 
 
+    Vfat::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
+    Vfat*
+    Vfat::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Vfat* ret = new Vfat(new Vfat::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     ContentInfo
     Vfat::Impl::detect_content_info_on_disk() const
     {
@@ -52,6 +52,21 @@ namespace storage
     }
 
 
+    Xfs::Impl::Impl(BinaryReader& reader)
+	: BlkFilesystem::Impl(reader)
+    {
+    }
+
+
+    Xfs*
+    Xfs::Impl::load(Devicegraph* devicegraph, BinaryReader& reader)
+    {
+	Xfs* ret = new Xfs(new Xfs::Impl(reader));
+	ret->Device::load(devicegraph);
+	return ret;
+    }
+
+
     void
     Xfs::Impl::probe_pass_2(Prober& prober)
     {
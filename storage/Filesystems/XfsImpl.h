@@ -63,6 +63,9 @@ namespace storage
 	    : BlkFilesystem::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Xfs* load(Devicegraph* devicegraph, BinaryReader& reader);
 
 	virtual void probe_pass_2(Prober& prober) override;
 
@@ -35,18 +35,48 @@ namespace storage
     using std::string;
 
 
-    template<typename Type>
+    /**
+     * Finds the device of Type with the key in the index of the
+     * devicegraph. Returns nullptr if no device is found. If several
+     * devices have the key, e.g. during a rename, the one with the lowest
+     * ordinal is returned, like a search in the order of the vertices.
+     */
+    template<typename Type, typename DevicegraphType>
     Type*
-    find_by_name(Devicegraph* devicegraph, const string& name)
+    find_by_key(DevicegraphType* devicegraph, Devicegraph::Impl::IndexType index_type,
+		const string& key)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	Type* ret = nullptr;
+	size_t ret_ordinal = 0;
+
+	for (const Devicegraph::Impl::key_index_t::value_type& value :
+		 devicegraph->get_impl().find_vertices(index_type, key))
 	{
-	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
-		return device;
+	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[value.second]);
+	    if (!device)
+		continue;
+
+	    size_t ordinal = devicegraph->get_impl().get_ordinal(value.second);
+	    if (!ret || ordinal < ret_ordinal)
+	    {
+		ret = device;
+		ret_ordinal = ordinal;
+	    }
 	}
 
-	ST_THROW(DeviceNotFoundByName(name));
+	return ret;
+    }
+
+
+    template<typename Type>
+    Type*
+    find_by_name(Devicegraph* devicegraph, const string& name)
+    {
+	Type* device = find_by_key<Type>(devicegraph, Devicegraph::Impl::IndexType::NAME, name);
+	if (!device)
+	    ST_THROW(DeviceNotFoundByName(name));
+
+	return device;
     }
 
 
@@ -54,14 +84,11 @@ namespace storage
     const Type*
     find_by_name(const Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
-		return device;
-	}
+	const Type* device = find_by_key<const Type>(devicegraph, Devicegraph::Impl::IndexType::NAME, name);
+	if (!device)
+	    ST_THROW(DeviceNotFoundByName(name));
 
-	ST_THROW(DeviceNotFoundByName(name));
+	return device;
     }
 
 
@@ -69,14 +96,11 @@ namespace storage
     Type*
     find_by_uuid(Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
-		return device;
-	}
+	Type* device = find_by_key<Type>(devicegraph, Devicegraph::Impl::IndexType::UUID, uuid);
+	if (!device)
+	    ST_THROW(DeviceNotFoundByUuid(uuid));
 
-	ST_THROW(DeviceNotFoundByUuid(uuid));
+	return device;
     }
 
 
@@ -84,14 +108,11 @@ namespace storage
     const Type*
     find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
-		return device;
-	}
+	const Type* device = find_by_key<const Type>(devicegraph, Devicegraph::Impl::IndexType::UUID, uuid);
+	if (!device)
+	    ST_THROW(DeviceNotFoundByUuid(uuid));
 
-	ST_THROW(DeviceNotFoundByUuid(uuid));
+	return device;
     }
 
 }
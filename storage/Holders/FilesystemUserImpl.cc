@@ -22,6 +22,7 @@
 
 #include "storage/Holders/FilesystemUserImpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 
 
@@ -38,6 +39,23 @@ namespace storage
     }
 
 
+    FilesystemUser::Impl::Impl(BinaryReader& reader)
+	: User::Impl(reader), journal(false)
+    {
+	journal = reader.get_bool();
+    }
+
+
+    FilesystemUser*
+    FilesystemUser::Impl::load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+			       const Device* target)
+    {
+	FilesystemUser* ret = new FilesystemUser(new FilesystemUser::Impl(reader));
+	ret->Holder::create(devicegraph, source, target);
+	return ret;
+    }
+
+
     void
     FilesystemUser::Impl::save(xmlNode* node) const
     {
@@ -47,6 +65,15 @@ namespace storage
     }
 
 
+    void
+    FilesystemUser::Impl::save(BinaryWriter& writer) const
+    {
+	User::Impl::save(writer);
+
+	writer.put_bool(journal);
+    }
+
+
     bool
     FilesystemUser::Impl::equal(const Holder::Impl& rhs_base) const
     {
@@ -41,6 +41,12 @@ namespace storage
     }
 
 
+    Holder::Impl::Impl(BinaryReader& reader)
+	: devicegraph(nullptr)
+    {
+    }
+
+
     bool
     Holder::Impl::operator==(const Impl& rhs) const
     {
@@ -129,6 +135,14 @@ namespace storage
     }
 
 
+    void
+    Holder::Impl::save(BinaryWriter& writer) const
+    {
+	// The source and target sid are written by
+	// Devicegraph::Impl::save_binary().
+    }
+
+
     bool
     Holder::Impl::equal(const Impl& rhs) const
     {
@@ -36,6 +36,10 @@
 namespace storage
 {
 
+    class BinaryReader;
+    class BinaryWriter;
+
+
     template <typename Type> struct HolderTraits {};
 
 
@@ -55,6 +59,7 @@ namespace storage
 	virtual const char* get_classname() const = 0;
 
 	virtual void save(xmlNode* node) const = 0;
+	virtual void save(BinaryWriter& writer) const = 0;
 
 	void set_devicegraph_and_edge(Devicegraph* devicegraph,
 				      Devicegraph::Impl::edge_descriptor edge);
@@ -86,6 +91,7 @@ namespace storage
 	Impl();
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
 
     private:
 
@@ -22,6 +22,7 @@
 
 #include "storage/Holders/MdSubdeviceImpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Devices/MdImpl.h"
 
@@ -39,6 +40,23 @@ namespace storage
     }
 
 
+    MdSubdevice::Impl::Impl(BinaryReader& reader)
+	: Subdevice::Impl(reader), member()
+    {
+	member = reader.get_string();
+    }
+
+
+    MdSubdevice*
+    MdSubdevice::Impl::load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+			    const Device* target)
+    {
+	MdSubdevice* ret = new MdSubdevice(new MdSubdevice::Impl(reader));
+	ret->Holder::create(devicegraph, source, target);
+	return ret;
+    }
+
+
     void
     MdSubdevice::Impl::save(xmlNode* node) const
     {
@@ -48,6 +66,15 @@ namespace storage
     }
 
 
+    void
+    MdSubdevice::Impl::save(BinaryWriter& writer) const
+    {
+	Subdevice::Impl::save(writer);
+
+	writer.put_string(member);
+    }
+
+
     bool
     MdSubdevice::Impl::equal(const Holder::Impl& rhs_base) const
     {
@@ -42,10 +42,15 @@ namespace storage
 	    : Subdevice::Impl(), member() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static MdSubdevice* load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+				 const Device* target);
 
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual const char* get_classname() const override { return HolderTraits<MdSubdevice>::classname; }
 
@@ -22,6 +22,7 @@
 
 #include "storage/Holders/MdUserImpl.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Devices/MdImpl.h"
 
@@ -42,6 +43,26 @@ namespace storage
     }
 
 
+    MdUser::Impl::Impl(BinaryReader& reader)
+	: User::Impl(reader), spare(false), faulty(false), sort_key(0)
+    {
+	spare = reader.get_bool();
+	faulty = reader.get_bool();
+
+	sort_key = reader.get_u32();
+    }
+
+
+    MdUser*
+    MdUser::Impl::load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+		       const Device* target)
+    {
+	MdUser* ret = new MdUser(new MdUser::Impl(reader));
+	ret->Holder::create(devicegraph, source, target);
+	return ret;
+    }
+
+
     void
     MdUser::Impl::save(xmlNode* node) const
     {
@@ -54,6 +75,18 @@ namespace storage
     }
 
 
+    void
+    MdUser::Impl::save(BinaryWriter& writer) const
+    {
+	User::Impl::save(writer);
+
+	writer.put_bool(spare);
+	writer.put_bool(faulty);
+
+	writer.put_u32(sort_key);
+    }
+
+
     bool
     MdUser::Impl::equal(const Holder::Impl& rhs_base) const
     {
@@ -42,10 +42,15 @@ namespace storage
 	    : User::Impl(), spare(false), faulty(false), sort_key(0) {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static MdUser* load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+			    const Device* target);
 
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual const char* get_classname() const override { return HolderTraits<MdUser>::classname; }
 
@@ -36,6 +36,22 @@ namespace storage
     }
 
 
+    Subdevice::Impl::Impl(BinaryReader& reader)
+	: Holder::Impl(reader)
+    {
+    }
+
+
+    Subdevice*
+    Subdevice::Impl::load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+			  const Device* target)
+    {
+	Subdevice* ret = new Subdevice(new Subdevice::Impl(reader));
+	ret->Holder::create(devicegraph, source, target);
+	return ret;
+    }
+
+
     void
     Subdevice::Impl::save(xmlNode* node) const
     {
@@ -43,6 +59,13 @@ namespace storage
     }
 
 
+    void
+    Subdevice::Impl::save(BinaryWriter& writer) const
+    {
+	Holder::Impl::save(writer);
+    }
+
+
     bool
     Subdevice::Impl::equal(const Holder::Impl& rhs_base) const
     {
@@ -43,10 +43,15 @@ namespace storage
 	    : Holder::Impl() {}
 
 	Impl(const xmlNode* node);
+	Impl(BinaryReader& reader);
+
+	static Subdevice* load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+			       const Device* target);
 
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void save(xmlNode* node) const override;
+	virtual void save(BinaryWriter& writer) const override;
 
 	virtual const char* get_classname() const override { return HolderTraits<Subdevice>::classname; }
 
@@ -36,6 +36,22 @@ namespace storage
     }
 
 
+    User::Impl::Impl(BinaryReader& reader)
+	: Holder::Impl(reader)
+    {
+    }
+
+
+    User*
+    User::Impl::load(Devicegraph* devicegraph, BinaryReader& reader, const Device* source,
+		     const Device* target)
+    {
+	User* ret = new User(new User::Impl(reader));
+	ret->Holder::create(devicegraph, source, target);
+	return ret;
+    }
+
+
     void
     User::Impl::save(xmlNode* node) const
     {
@@ -43,6 +59,13 @@ namespace storage
     }
 
 
+    void
+    User::Impl::save(BinaryWriter& writer) const
+    {
+	Holder::Impl::save(writer);
+    }
+
+
     bool
     User::Impl::equal(const Holder::Impl& rhs_base) const
     {
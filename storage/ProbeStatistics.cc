@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <json-c/json.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#include "storage/ProbeStatistics.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    const unsigned int max_slowest = 5;
+
+
+    void
+    CommandStatistics::add(const string& command, double seconds)
+    {
+	++count;
+	CommandStatistics::seconds += seconds;
+
+	vector<TimeEntry>::iterator it = find_if(slowest.begin(), slowest.end(),
+	    [seconds](const TimeEntry& time_entry) { return time_entry.seconds < seconds; });
+
+	if (it != slowest.end() || slowest.size() < max_slowest)
+	{
+	    slowest.insert(it, TimeEntry(command, seconds));
+	    if (slowest.size() > max_slowest)
+		slowest.pop_back();
+	}
+    }
+
+
+    void
+    ProbeStatistics::add_device_class(const string& name, double seconds)
+    {
+	vector<TimeEntry>::iterator it = find_if(device_classes.begin(), device_classes.end(),
+	    [&name](const TimeEntry& time_entry) { return time_entry.name == name; });
+
+	if (it != device_classes.end())
+	    it->seconds += seconds;
+	else
+	    device_classes.emplace_back(name, seconds);
+    }
+
+
+    void
+    ProbeStatistics::add_command(const string& command, double seconds)
+    {
+	string binary = command.substr(0, command.find(' '));
+
+	vector<CommandStatistics>::iterator it = find_if(commands.begin(), commands.end(),
+	    [&binary](const CommandStatistics& command_statistics) {
+		return command_statistics.binary == binary;
+	    });
+
+	if (it == commands.end())
+	    it = commands.insert(commands.end(), CommandStatistics(binary));
+
+	it->add(command, seconds);
+    }
+
+
+    namespace
+    {
+
+	json_object*
+	to_json_array(const vector<TimeEntry>& time_entries)
+	{
+	    json_object* array = json_object_new_array();
+
+	    for (const TimeEntry& time_entry : time_entries)
+	    {
+		json_object* object = json_object_new_object();
+		json_object_object_add(object, "name", json_object_new_string(time_entry.name.c_str()));
+		json_object_object_add(object, "seconds", json_object_new_double(time_entry.seconds));
+		json_object_array_add(array, object);
+	    }
+
+	    return array;
+	}
+
+    }
+
+
+    string
+    ProbeStatistics::to_json() const
+    {
+	std::unique_ptr<json_object, std::function<void(json_object*)>> root(
+	    json_object_new_object(), [](json_object* p) { json_object_put(p); }
+	);
+
+	json_object_object_add(root.get(), "seconds", json_object_new_double(seconds));
+	json_object_object_add(root.get(), "passes", to_json_array(passes));
+	json_object_object_add(root.get(), "device-classes", to_json_array(device_classes));
+
+	json_object* array = json_object_new_array();
+
+	for (const CommandStatistics& command_statistics : commands)
+	{
+	    json_object* object = json_object_new_object();
+	    json_object_object_add(object, "binary", json_object_new_string(command_statistics.binary.c_str()));
+	    json_object_object_add(object, "count", json_object_new_int(command_statistics.count));
+	    json_object_object_add(object, "seconds", json_object_new_double(command_statistics.seconds));
+	    json_object_object_add(object, "slowest", to_json_array(command_statistics.slowest));
+	    json_object_array_add(array, object);
+	}
+
+	json_object_object_add(root.get(), "commands", array);
+
+	return json_object_to_json_string_ext(root.get(), JSON_C_TO_STRING_PRETTY);
+    }
+
+
+    std::ostream&
+    operator<<(std::ostream& out, const ProbeStatistics& probe_statistics)
+    {
+	out << "seconds:" << probe_statistics.seconds;
+
+	for (const TimeEntry& time_entry : probe_statistics.passes)
+	    out << " pass " << time_entry.name << ":" << time_entry.seconds;
+
+	for (const TimeEntry& time_entry : probe_statistics.device_classes)
+	    out << " " << time_entry.name << ":" << time_entry.seconds;
+
+	for (const CommandStatistics& command_statistics : probe_statistics.commands)
+	    out << " " << command_statistics.binary << ":" << command_statistics.count << "/"
+		<< command_statistics.seconds;
+
+	return out;
+    }
+
+}
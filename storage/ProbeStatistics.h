@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_PROBE_STATISTICS_H
+#define STORAGE_PROBE_STATISTICS_H
+
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+
+namespace storage
+{
+
+    /**
+     * Wall time spent for something, e.g. a pass of the probing or a
+     * command.
+     */
+    class TimeEntry
+    {
+    public:
+
+	TimeEntry() : name(), seconds(0.0) {}
+	TimeEntry(const std::string& name, double seconds) : name(name), seconds(seconds) {}
+
+	std::string name;
+	double seconds;
+
+    };
+
+
+    /**
+     * Statistics of the commands run with the same binary.
+     */
+    class CommandStatistics
+    {
+    public:
+
+	CommandStatistics() : binary(), count(0), seconds(0.0) {}
+	CommandStatistics(const std::string& binary) : binary(binary), count(0), seconds(0.0) {}
+
+	/**
+	 * Record one run of a command with the binary.
+	 */
+	void add(const std::string& command, double seconds);
+
+	std::string binary;
+
+	unsigned int count;
+
+	/**
+	 * Total wall time of all runs.
+	 */
+	double seconds;
+
+	/**
+	 * The up to five slowest runs with the complete command line,
+	 * slowest first.
+	 */
+	std::vector<TimeEntry> slowest;
+
+    };
+
+
+    /**
+     * Statistics of the last probe, see Storage::get_probe_statistics().
+     */
+    class ProbeStatistics
+    {
+    public:
+
+	ProbeStatistics() : seconds(0.0) {}
+
+	/**
+	 * Total wall time of the probe.
+	 */
+	double seconds;
+
+	/**
+	 * Wall time of the passes of the probe, e.g. "1a" or "2", in the
+	 * order they were run.
+	 */
+	std::vector<TimeEntry> passes;
+
+	/**
+	 * Wall time of the probe functions per pass and device class,
+	 * e.g. "1a Disk" or "2 Ext4", accumulated over all devices of the
+	 * class.
+	 */
+	std::vector<TimeEntry> device_classes;
+
+	/**
+	 * Statistics of the commands run during the probe per binary.
+	 */
+	std::vector<CommandStatistics> commands;
+
+	/**
+	 * Adds seconds to the entry with the name in device_classes. The
+	 * entry is created if needed.
+	 */
+	void add_device_class(const std::string& name, double seconds);
+
+	/**
+	 * Records one run of a command. The binary is the first word of the
+	 * command.
+	 */
+	void add_command(const std::string& command, double seconds);
+
+	/**
+	 * Returns the statistics as JSON, e.g. for monitoring.
+	 */
+	std::string to_json() const;
+
+	friend std::ostream& operator<<(std::ostream& out, const ProbeStatistics& probe_statistics);
+
+    };
+
+}
+
+
+#endif
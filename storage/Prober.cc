@@ -41,6 +41,8 @@
 #include "storage/Filesystems/BlkFilesystemImpl.h"
 #include "storage/Filesystems/NfsImpl.h"
 #include "storage/SystemInfo/SystemInfo.h"
+#include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/Stopwatch.h"
 
 
 namespace storage
@@ -82,86 +84,150 @@ namespace storage
 	 * Pass 1e: Probe some remaining attributes.
 	 *
 	 * Pass 2:  Probe filesystems and mount points.
+	 *
+	 * Before pass 1a the commands run for every disk, DASD and MD are
+	 * started concurrently, see SystemInfo::prefetch().
+	 *
+	 * The wall time of the passes, the probe functions per device class
+	 * and the commands is recorded in probe_statistics.
 	 */
 
+	Stopwatch stopwatch;
+
+	// Restore SystemCmd::probe_statistics also if probing throws.
+
+	struct Recording
+	{
+	    Recording(ProbeStatistics* probe_statistics) { SystemCmd::probe_statistics = probe_statistics; }
+	    ~Recording() { SystemCmd::probe_statistics = nullptr; }
+	};
+
+	{
+	    Recording recording(&probe_statistics);
+
+	    probe();
+	}
+
+	probe_statistics.seconds = stopwatch.read();
+
+	y2mil("probe statistics " << probe_statistics);
+    }
+
+
+    void
+    Prober::probe()
+    {
+	Stopwatch stopwatch;
+
+	system_info.prefetch();
+
+	probe_statistics.passes.emplace_back("prefetch", stopwatch.read());
+
 	// Pass 1a
 
-	Disk::Impl::probe_disks(*this);
+	stopwatch = Stopwatch();
 
-	Dasd::Impl::probe_dasds(*this);
+	measure("1a Disk", [this]() { Disk::Impl::probe_disks(*this); });
 
-	Multipath::Impl::probe_multipaths(*this);
+	measure("1a Dasd", [this]() { Dasd::Impl::probe_dasds(*this); });
 
-	DmRaid::Impl::probe_dm_raids(*this);
+	measure("1a Multipath", [this]() { Multipath::Impl::probe_multipaths(*this); });
+
+	measure("1a DmRaid", [this]() { DmRaid::Impl::probe_dm_raids(*this); });
 
 	if (system_info.getBlkid().any_md())
 	{
 	    // TODO check whether md tools are installed
 
-	    Md::Impl::probe_mds(*this);
+	    measure("1a Md", [this]() { Md::Impl::probe_mds(*this); });
 	}
 
 	if (system_info.getBlkid().any_lvm())
 	{
 	    // TODO check whether lvm tools are installed
 
-	    LvmVg::Impl::probe_lvm_vgs(*this);
-	    LvmPv::Impl::probe_lvm_pvs(*this);
-	    LvmLv::Impl::probe_lvm_lvs(*this);
+	    measure("1a LvmVg", [this]() { LvmVg::Impl::probe_lvm_vgs(*this); });
+	    measure("1a LvmPv", [this]() { LvmPv::Impl::probe_lvm_pvs(*this); });
+	    measure("1a LvmLv", [this]() { LvmLv::Impl::probe_lvm_lvs(*this); });
 
-	    for (LvmVg* lvm_vg : LvmVg::get_all(probed))
-		lvm_vg->get_impl().calculate_reserved_extents(*this);
+	    measure("1a LvmVg", [this]() {
+		for (LvmVg* lvm_vg : LvmVg::get_all(probed))
+		    lvm_vg->get_impl().calculate_reserved_extents(*this);
+	    });
 	}
 
 	if (system_info.getBlkid().any_luks())
 	{
 	    // TODO check whether cryptsetup tools are installed
 
-	    Luks::Impl::probe_lukses(*this);
+	    measure("1a Luks", [this]() { Luks::Impl::probe_lukses(*this); });
 	}
 
 	if (system_info.getBlkid().any_bcache())
 	{
 	    // TODO check whether bcache-tools are installed
 
-	    Bcache::Impl::probe_bcaches(*this);
-	    BcacheCset::Impl::probe_bcache_csets(*this);
+	    measure("1a Bcache", [this]() { Bcache::Impl::probe_bcaches(*this); });
+	    measure("1a BcacheCset", [this]() { BcacheCset::Impl::probe_bcache_csets(*this); });
 	}
 
+	probe_statistics.passes.emplace_back("1a", stopwatch.read());
+
 	// Pass 1b
 
+	stopwatch = Stopwatch();
+
 	for (Devicegraph::Impl::vertex_descriptor vertex : probed->get_impl().vertices())
 	{
 	    Device* device = probed->get_impl()[vertex];
-	    device->get_impl().probe_pass_1b(*this);
+	    measure(string("1b ") + device->get_impl().get_classname(),
+		    [this, device]() { device->get_impl().probe_pass_1b(*this); });
 	}
 
+	probe_statistics.passes.emplace_back("1b", stopwatch.read());
+
 	// Pass 1c
 
+	stopwatch = Stopwatch();
+
 	for (Devicegraph::Impl::vertex_descriptor vertex : probed->get_impl().vertices())
 	{
 	    Device* device = probed->get_impl()[vertex];
 	    if (is_partitionable(device))
 	    {
 		Partitionable* partitionable = to_partitionable(device);
-		partitionable->get_impl().probe_pass_1c(*this);
+		measure(string("1c ") + device->get_impl().get_classname(),
+			[this, partitionable]() { partitionable->get_impl().probe_pass_1c(*this); });
 	    }
 	}
 
+	probe_statistics.passes.emplace_back("1c", stopwatch.read());
+
 	// Pass 1d
 
+	stopwatch = Stopwatch();
+
 	flush_pending_holders();
 
+	probe_statistics.passes.emplace_back("1d", stopwatch.read());
+
 	// Pass 1e
 
+	stopwatch = Stopwatch();
+
 	for (Devicegraph::Impl::vertex_descriptor vertex : probed->get_impl().vertices())
 	{
 	    Device* device = probed->get_impl()[vertex];
-	    device->get_impl().probe_pass_1e(*this);
+	    measure(string("1e ") + device->get_impl().get_classname(),
+		    [this, device]() { device->get_impl().probe_pass_1e(*this); });
 	}
 
+	probe_statistics.passes.emplace_back("1e", stopwatch.read());
+
 	// Pass 2
 
+	stopwatch = Stopwatch();
+
 	for (BlkDevice* blk_device : BlkDevice::get_all(probed))
 	{
 	    if (blk_device->has_children())
@@ -186,12 +252,26 @@ namespace storage
 		    }
 
 		    BlkFilesystem* blk_filesystem = blk_device->create_blk_filesystem(it->second.fs_type);
-		    blk_filesystem->get_impl().probe_pass_2(*this);
+		    measure(string("2 ") + blk_filesystem->get_impl().get_classname(),
+			    [this, blk_filesystem]() { blk_filesystem->get_impl().probe_pass_2(*this); });
 		}
 	    }
 	}
 
-	Nfs::Impl::probe_nfses(*this);
+	measure("2 Nfs", [this]() { Nfs::Impl::probe_nfses(*this); });
+
+	probe_statistics.passes.emplace_back("2", stopwatch.read());
+    }
+
+
+    void
+    Prober::measure(const string& name, std::function<void()> func)
+    {
+	Stopwatch stopwatch;
+
+	func();
+
+	probe_statistics.add_device_class(name, stopwatch.read());
     }
 
 
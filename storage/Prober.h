@@ -28,6 +28,8 @@
 #include <vector>
 #include <functional>
 
+#include "storage/ProbeStatistics.h"
+
 
 namespace storage
 {
@@ -65,6 +67,12 @@ namespace storage
 	 */
 	void add_holder(const string& name, Device* b, add_holder_func_t add_holder_func);
 
+	/**
+	 * Wall time of the passes and device classes and the commands run
+	 * during the probe.
+	 */
+	const ProbeStatistics& get_probe_statistics() const { return probe_statistics; }
+
     private:
 
 	Devicegraph* probed;
@@ -83,6 +91,15 @@ namespace storage
 
 	vector<pending_holder_t> pending_holders;
 
+	ProbeStatistics probe_statistics;
+
+	/**
+	 * Calls func and adds the wall time to the device class name.
+	 */
+	void measure(const string& name, std::function<void()> func);
+
+	void probe();
+
 	/**
 	 * Flushes the pendings holders. If a BlkDevice is still not found an
 	 * exception is thrown.
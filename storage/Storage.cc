@@ -211,10 +211,31 @@ namespace storage
     }
 
 
+    void
+    Storage::reprobe(const vector<string>& device_names)
+    {
+	get_impl().reprobe(device_names);
+    }
+
+
+    const ProbeStatistics&
+    Storage::get_probe_statistics() const
+    {
+	return get_impl().get_probe_statistics();
+    }
+
+
     void
     Storage::commit(const CommitCallbacks* commit_callbacks)
     {
-	get_impl().commit(commit_callbacks);
+	get_impl().commit(CommitOptions(), commit_callbacks);
+    }
+
+
+    void
+    Storage::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks)
+    {
+	get_impl().commit(commit_options, commit_callbacks);
     }
 
 }
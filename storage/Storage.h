@@ -73,6 +73,7 @@ namespace storage
     class Arch;
     class Devicegraph;
     class Actiongraph;
+    class ProbeStatistics;
 
 
     /**
@@ -111,6 +112,30 @@ namespace storage
     };
 
 
+    /**
+     * Options for Storage::commit().
+     */
+    class CommitOptions
+    {
+    public:
+
+	CommitOptions(unsigned int parallel_actions = 1)
+	    : parallel_actions(parallel_actions) {}
+
+	/**
+	 * Maximal number of actions committed at the same time. An action
+	 * is started as soon as all actions it depends on are finished.
+	 * Actions modifying /etc/fstab, /etc/crypttab or /etc/mdadm.conf
+	 * are still committed one after another. The logger and the
+	 * commit callbacks are still only called from the thread calling
+	 * Storage::commit(), log lines of the other threads are passed to
+	 * the logger with some delay.
+	 */
+	unsigned int parallel_actions;
+
+    };
+
+
     class CommitCallbacks
     {
     public:
@@ -259,6 +284,32 @@ namespace storage
 	 */
 	void probe();
 
+	/**
+	 * Statistics of the last probe, e.g. the wall time of the passes of
+	 * the probe and of the commands run. Empty if the last probe read
+	 * the devicegraph from a file or if probe() was not called.
+	 */
+	const ProbeStatistics& get_probe_statistics() const;
+
+	/**
+	 * Probe the system again after the block devices with the kernel
+	 * names device_names changed, e.g. as reported by udev. Devices not
+	 * connected to the changed devices are not queried again but
+	 * assumed unchanged. Devices keep their sid if they still exist.
+	 * The probed devicegraph is updated in place, unchanged devices
+	 * are kept. The staging devicegraph is replaced by a copy of the
+	 * probed devicegraph.
+	 *
+	 * The result is the same as for probe() as long as all changed
+	 * devices are reported. Changes not reported by udev, e.g. created
+	 * btrfs subvolumes, need a full probe.
+	 *
+	 * Falls back to probe() if the last probe did not query the system.
+	 *
+	 * @throw Exception
+	 */
+	void reprobe(const std::vector<std::string>& device_names);
+
 	/**
 	 * The actiongraph must be valid.
 	 *
@@ -266,6 +317,13 @@ namespace storage
 	 */
 	void commit(const CommitCallbacks* commit_callbacks = nullptr);
 
+	/**
+	 * The actiongraph must be valid.
+	 *
+	 * @throw Exception
+	 */
+	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks = nullptr);
+
     public:
 
 	class Impl;
@@ -21,9 +21,16 @@
  */
 
 
+#include <string.h>
+#include <boost/algorithm/string.hpp>
+
 #include "config.h"
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/Mockup.h"
+#include "storage/Utils/BinaryFile.h"
+#include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/StorageTmpl.h"
 #include "storage/StorageImpl.h"
 #include "storage/Devices/DiskImpl.h"
 #include "storage/Devices/DasdImpl.h"
@@ -156,6 +163,9 @@ namespace storage
 
 	Devicegraph* probed = create_devicegraph("probed");
 
+	probe_statistics = ProbeStatistics();
+	system_info.reset();
+
 	switch (environment.get_probe_mode())
 	{
 	    case ProbeMode::STANDARD: {
@@ -167,6 +177,11 @@ namespace storage
 		probed->save(environment.get_devicegraph_filename());
 	    } break;
 
+	    case ProbeMode::STANDARD_WRITE_DEVICEGRAPH_BINARY: {
+		probe_helper(probed);
+		probed->save_binary(environment.get_devicegraph_filename());
+	    } break;
+
 	    case ProbeMode::STANDARD_WRITE_MOCKUP: {
 		Mockup::set_mode(Mockup::Mode::RECORD);
 		probe_helper(probed);
@@ -177,7 +192,11 @@ namespace storage
 	    } break;
 
 	    case ProbeMode::READ_DEVICEGRAPH: {
-		probed->load(environment.get_devicegraph_filename());
+		const string& filename = environment.get_devicegraph_filename();
+		if (is_binary_file(filename))
+		    probed->load_binary(filename);
+		else
+		    probed->load(filename);
 	    } break;
 
 	    case ProbeMode::READ_MOCKUP: {
@@ -197,14 +216,144 @@ namespace storage
     }
 
 
+    namespace
+    {
+
+	/**
+	 * Returns the names of the block devices that must be probed again
+	 * if the devices with the kernel names changed. These are the devices
+	 * themselves, all their descendants and all ancestors of those, e.g.
+	 * the disk of a partition or all devices of a btrfs.
+	 */
+	set<string>
+	affected_blk_devices(const Devicegraph* probed, const vector<string>& device_names)
+	{
+	    set<string> ret;
+
+	    // block devices by name and by sysfs name
+
+	    multimap<string, const BlkDevice*> blk_devices;
+
+	    for (const BlkDevice* blk_device : BlkDevice::get_all(probed))
+	    {
+		blk_devices.emplace(blk_device->get_name(), blk_device);
+		if (!blk_device->get_sysfs_name().empty())
+		    blk_devices.emplace(DEVDIR "/" + blk_device->get_sysfs_name(), blk_device);
+	    }
+
+	    for (const string& device_name : device_names)
+	    {
+		string name = boost::starts_with(device_name, DEVDIR "/") ? device_name :
+		    DEVDIR "/" + device_name;
+
+		ret.insert(name);
+
+		auto range = blk_devices.equal_range(name);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+		    for (const Device* descendant : it->second->get_descendants(true))
+		    {
+			for (const Device* ancestor : descendant->get_ancestors(true))
+			{
+			    if (is_blk_device(ancestor))
+				ret.insert(to_blk_device(ancestor)->get_name());
+			}
+		    }
+		}
+	    }
+
+	    return ret;
+	}
+
+    }
+
+
+    void
+    Storage::Impl::reprobe(const vector<string>& device_names)
+    {
+	// Without the results of a previous probe, e.g. if the devicegraph
+	// was read from a file, only a full probe is possible.
+
+	if (!system_info)
+	{
+	    probe();
+	    return;
+	}
+
+	y2mil("reprobe begin " << device_names);
+
+	const set<string> affected = affected_blk_devices(get_probed(), device_names);
+
+	y2mil("affected " << affected);
+
+	Devicegraph* reprobed = create_devicegraph("reprobed");
+
+	try
+	{
+	    probe_helper(reprobed, &affected);
+
+	    reprobed->get_impl().adopt_sids(get_probed()->get_impl());
+
+	    switch (environment.get_probe_mode())
+	    {
+		case ProbeMode::STANDARD_WRITE_DEVICEGRAPH: {
+		    reprobed->save(environment.get_devicegraph_filename());
+		} break;
+
+		case ProbeMode::STANDARD_WRITE_DEVICEGRAPH_BINARY: {
+		    reprobed->save_binary(environment.get_devicegraph_filename());
+		} break;
+
+		case ProbeMode::STANDARD_WRITE_MOCKUP: {
+		    Mockup::save(environment.get_mockup_filename());
+		} break;
+
+		default: {
+		} break;
+	    }
+	}
+	catch (...)
+	{
+	    remove_devicegraph("reprobed");
+	    throw;
+	}
+
+	// The probed devicegraph is updated in place, so unchanged devices
+	// stay as they are. Staging is copied again from probed.
+
+	remove_devicegraph("staging");
+
+	Devicegraph* probed = &devicegraphs.find("probed")->second;
+	probed->get_impl().update(probed, reprobed->get_impl());
+	remove_devicegraph("reprobed");
+
+	y2mil("reprobe end");
+
+	y2mil("probed devicegraph begin");
+	y2mil(*get_probed());
+	y2mil("probed devicegraph end");
+
+	copy_devicegraph("probed", "staging");
+    }
+
+
     void
-    Storage::Impl::probe_helper(Devicegraph* probed)
+    Storage::Impl::probe_helper(Devicegraph* probed, const set<string>* affected)
     {
-	SystemInfo system_info;
+	std::unique_ptr<SystemInfo> tmp(new SystemInfo());
 
-	arch = system_info.getArch();
+	if (system_info && affected)
+	    tmp->reuse(*system_info, *affected);
 
-	Prober prober(probed, system_info);
+	arch = tmp->getArch();
+
+	MountSession mount_session(*this);
+
+	Prober prober(probed, *tmp);
+
+	probe_statistics = prober.get_probe_statistics();
+
+	system_info = std::move(tmp);
     }
 
 
@@ -399,12 +548,93 @@ namespace storage
     }
 
 
+    std::shared_ptr<TmpMount>
+    Storage::Impl::get_tmp_mount(const string& name, bool read_only, const vector<string>& options) const
+    {
+	const string key = name + " " + boost::join(options, ",");
+
+	vector<string> keys = { "rw " + key };
+	if (read_only)
+	    keys.push_back("ro " + key);
+
+	for (const string& tmp : keys)
+	{
+	    map<string, std::weak_ptr<TmpMount>>::iterator it = tmp_mounts.find(tmp);
+	    if (it == tmp_mounts.end())
+		continue;
+
+	    std::shared_ptr<TmpMount> tmp_mount = it->second.lock();
+	    if (tmp_mount)
+	    {
+		y2mil("reusing temporary mount " << tmp_mount->get_fullname() << " of " << name);
+		return tmp_mount;
+	    }
+
+	    tmp_mounts.erase(it);
+	}
+
+	remove_expired_tmp_mounts();
+
+	// During the parallel commit other threads may run while the mount
+	// command runs. They must not mount the filesystem again, so the
+	// lock is kept until the mount is registered.
+
+	SystemCmd::KeepLockWhileWaiting keep_lock_while_waiting;
+
+	std::shared_ptr<TmpMount> tmp_mount = std::make_shared<TmpMount>(tmp_dir.get_fullname(),
+	    "tmp-mount-XXXXXX", name, read_only, options);
+
+	tmp_mounts[(read_only ? "ro " : "rw ") + key] = tmp_mount;
+
+	if (mount_sessions > 0)
+	    kept_tmp_mounts.push_back(tmp_mount);
+
+	return tmp_mount;
+    }
+
+
+    Storage::Impl::MountSession::MountSession(const Impl& impl)
+	: impl(impl)
+    {
+	++impl.mount_sessions;
+    }
+
+
+    Storage::Impl::MountSession::~MountSession()
+    {
+	if (--impl.mount_sessions == 0)
+	    impl.release_tmp_mounts();
+    }
+
+
+    void
+    Storage::Impl::release_tmp_mounts() const
+    {
+	kept_tmp_mounts.clear();
+
+	remove_expired_tmp_mounts();
+    }
+
+
+    void
+    Storage::Impl::remove_expired_tmp_mounts() const
+    {
+	for (map<string, std::weak_ptr<TmpMount>>::iterator it = tmp_mounts.begin(); it != tmp_mounts.end();)
+	{
+	    if (it->second.expired())
+		it = tmp_mounts.erase(it);
+	    else
+		++it;
+	}
+    }
+
+
     void
-    Storage::Impl::commit(const CommitCallbacks* commit_callbacks)
+    Storage::Impl::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks)
     {
 	ST_CHECK_PTR(actiongraph.get());
 
-	actiongraph->get_impl().commit(commit_callbacks);
+	actiongraph->get_impl().commit(commit_options, commit_callbacks);
 
 	// TODO somehow update probed
     }
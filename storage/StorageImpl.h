@@ -26,11 +26,14 @@
 
 
 #include <map>
+#include <set>
+#include <memory>
 
 #include "storage/Utils/FileUtils.h"
 #include "storage/Storage.h"
 #include "storage/Environment.h"
 #include "storage/SystemInfo/Arch.h"
+#include "storage/ProbeStatistics.h"
 
 
 namespace storage
@@ -39,6 +42,9 @@ namespace storage
     using std::map;
 
 
+    class SystemInfo;
+
+
     class Storage::Impl
     {
     public:
@@ -89,13 +95,55 @@ namespace storage
 
 	void probe();
 
-	void commit(const CommitCallbacks* commit_callbacks);
+	void reprobe(const vector<string>& device_names);
+
+	const ProbeStatistics& get_probe_statistics() const { return probe_statistics; }
+
+	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks);
 
 	const TmpDir& get_tmp_dir() const { return tmp_dir; }
 
+	/**
+	 * Returns a temporary mount of the device (or NFS share) name. The
+	 * mount is shared by all users and unmounted when the last user is
+	 * gone unless a mount session is active. A read-only request may
+	 * get a read-write mount.
+	 */
+	std::shared_ptr<TmpMount> get_tmp_mount(const string& name, bool read_only,
+						const vector<string>& options) const;
+
+	/**
+	 * While a mount session exists temporary mounts are kept until the
+	 * session ends or release_tmp_mounts() is called. So a filesystem
+	 * is mounted at most once, e.g. during probing.
+	 */
+	class MountSession : private boost::noncopyable
+	{
+	public:
+
+	    MountSession(const Impl& impl);
+	    ~MountSession();
+
+	private:
+
+	    const Impl& impl;
+
+	};
+
+	/**
+	 * Drops the temporary mounts kept by the mount sessions. Mounts
+	 * still in use are unmounted once the last user is gone.
+	 */
+	void release_tmp_mounts() const;
+
     private:
 
-	void probe_helper(Devicegraph* probed);
+	void probe_helper(Devicegraph* probed, const std::set<string>* affected = nullptr);
+
+	/**
+	 * Removes the entries of temporary mounts no longer in use.
+	 */
+	void remove_expired_tmp_mounts() const;
 
 	const Storage& storage;
 
@@ -111,8 +159,24 @@ namespace storage
 
 	std::unique_ptr<const Actiongraph> actiongraph;
 
+	ProbeStatistics probe_statistics;
+
+	/**
+	 * The results of the commands run during the last probe. Kept for
+	 * the incremental reprobe.
+	 */
+	std::unique_ptr<SystemInfo> system_info;
+
 	TmpDir tmp_dir;
 
+	// Must be destructed before tmp_dir.
+
+	mutable map<string, std::weak_ptr<TmpMount>> tmp_mounts;
+
+	mutable vector<std::shared_ptr<TmpMount>> kept_tmp_mounts;
+
+	mutable unsigned int mount_sessions = 0;
+
     };
 
 }
@@ -153,6 +153,20 @@ namespace storage
 	    return it;
 
 	dev_t majorminor = system_info.getCmdUdevadmInfo(device).get_majorminor();
+
+	const CmdUdevadmExportDb* cmdudevadmexportdb = system_info.getCmdUdevadmExportDb();
+	if (cmdudevadmexportdb)
+	{
+	    for (const string& file : cmdudevadmexportdb->find_by_majorminor(majorminor))
+	    {
+		it = data.find(file);
+		if (it != end())
+		    return it;
+	    }
+
+	    return end();
+	}
+
 	return find_if(begin(), end(), [&system_info, &majorminor](const value_type& tmp) {
 	    return system_info.getCmdUdevadmInfo(tmp.first).get_majorminor() == majorminor;
 	});
@@ -28,6 +28,7 @@
 #include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/BtrfsUtils.h"
 #include "storage/SystemInfo/CmdBtrfs.h"
 
 
@@ -141,6 +142,32 @@ namespace storage
 
     CmdBtrfsSubvolumeList::CmdBtrfsSubvolumeList(const key_t& key, const string& mountpoint)
     {
+	if (btrfs_use_ioctls())
+	{
+	    try
+	    {
+		for (const BtrfsSubvolumeEntry& subvolume : btrfs_list_subvolumes(mountpoint))
+		{
+		    Entry entry;
+		    entry.id = subvolume.id;
+		    entry.parent_id = subvolume.parent_id;
+		    entry.path = subvolume.path;
+		    data.push_back(entry);
+		}
+
+		y2mil(*this);
+
+		return;
+	    }
+	    catch (const Exception& exception)
+	    {
+		ST_CAUGHT(exception);
+
+		y2war("reading subvolumes failed, falling back to 'btrfs subvolume list'");
+		data.clear();
+	    }
+	}
+
 	SystemCmd::Options cmd_options(BTRFSBIN " subvolume list -a -p " + quote(mountpoint));
 	cmd_options.mockup_key = BTRFSBIN " subvolume list -a -p (device:" + key + ")";
 	cmd_options.throw_behaviour = SystemCmd::DoThrow;
@@ -220,6 +247,24 @@ namespace storage
     CmdBtrfsSubvolumeGetDefault::CmdBtrfsSubvolumeGetDefault(const key_t& key, const string& mountpoint)
 	: id(BtrfsSubvolume::Impl::unknown_id)
     {
+	if (btrfs_use_ioctls())
+	{
+	    try
+	    {
+		id = btrfs_default_subvolume_id(mountpoint);
+
+		y2mil(*this);
+
+		return;
+	    }
+	    catch (const Exception& exception)
+	    {
+		ST_CAUGHT(exception);
+
+		y2war("reading default subvolume failed, falling back to 'btrfs subvolume get-default'");
+	    }
+	}
+
 	SystemCmd::Options cmd_options(BTRFSBIN " subvolume get-default " + quote(mountpoint));
 	cmd_options.mockup_key = BTRFSBIN " subvolume get-default (device:" + key + ")";
 	cmd_options.throw_behaviour = SystemCmd::DoThrow;
@@ -91,8 +91,9 @@ namespace storage
 
 
     /**
-     * Class to probe for btrfs subvolumes: Call "btrfs subvolume list
-     * <mountpoint>".
+     * Class to probe for btrfs subvolumes: Read the root tree with the
+     * tree search ioctl or, for mockup or if that fails, call "btrfs
+     * subvolume list <mountpoint>".
      */
     class CmdBtrfsSubvolumeList
     {
@@ -135,8 +136,9 @@ namespace storage
 
 
     /**
-     * Class to probe for btrfs default subvolume: Call "btrfs subvolume
-     * get-default <mountpoint>".
+     * Class to probe for btrfs default subvolume: Read the root tree with
+     * the tree search ioctl or, for mockup or if that fails, call "btrfs
+     * subvolume get-default <mountpoint>".
      */
     class CmdBtrfsSubvolumeGetDefault
     {
@@ -35,12 +35,27 @@ namespace storage
     CmdCryptsetup::CmdCryptsetup(const string& name)
 	: encryption_type(EncryptionType::UNKNOWN), name(name)
     {
-	SystemCmd cmd(CRYPTSETUPBIN " status " + quote(name));
+	SystemCmd cmd(command(name));
 	if (cmd.retcode() == 0 && !cmd.stdout().empty())
 	    parse(cmd.stdout());
     }
 
 
+    CmdCryptsetup::CmdCryptsetup(const string& name, const SystemCmd& cmd)
+	: encryption_type(EncryptionType::UNKNOWN), name(name)
+    {
+	if (cmd.retcode() == 0 && !cmd.stdout().empty())
+	    parse(cmd.stdout());
+    }
+
+
+    string
+    CmdCryptsetup::command(const string& name)
+    {
+	return CRYPTSETUPBIN " status " + quote(name);
+    }
+
+
     void
     CmdCryptsetup::parse(const vector<string>& lines)
     {
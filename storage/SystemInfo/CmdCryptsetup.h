@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 
+#include "storage/Utils/SystemCmd.h"
 #include "storage/Devices/Encryption.h"
 
 
@@ -43,6 +44,17 @@ namespace storage
 
 	CmdCryptsetup(const string& name);
 
+	/**
+	 * Constructor for the result of the command returned by command()
+	 * that was already run, e.g. during prefetch.
+	 */
+	CmdCryptsetup(const string& name, const SystemCmd& cmd);
+
+	/**
+	 * Returns the command run by the constructor.
+	 */
+	static string command(const string& name);
+
 	friend std::ostream& operator<<(std::ostream& s, const CmdCryptsetup& cmdcryptsetup);
 
 	EncryptionType encryption_type;
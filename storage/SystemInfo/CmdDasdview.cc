@@ -33,8 +33,22 @@ namespace storage
     Dasdview::Dasdview(const string& device)
 	: device(device), type(DasdType::UNKNOWN), format(DasdFormat::NONE)
     {
-	SystemCmd cmd(DASDVIEWBIN " --extended " + quote(device));
+	SystemCmd cmd(command(device));
 
+	process(cmd);
+    }
+
+
+    Dasdview::Dasdview(const string& device, const SystemCmd& cmd)
+	: device(device), type(DasdType::UNKNOWN), format(DasdFormat::NONE)
+    {
+	process(cmd);
+    }
+
+
+    void
+    Dasdview::process(const SystemCmd& cmd)
+    {
 	if (cmd.retcode() == 0)
 	{
 	    parse(cmd.stdout());
@@ -46,6 +60,13 @@ namespace storage
     }
 
 
+    string
+    Dasdview::command(const string& device)
+    {
+	return DASDVIEWBIN " --extended " + quote(device);
+    }
+
+
     void
     Dasdview::parse(const vector<string>& lines)
     {
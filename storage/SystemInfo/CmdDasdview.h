@@ -41,6 +41,17 @@ namespace storage
 
 	Dasdview(const string& device);
 
+	/**
+	 * Constructor for the result of the command returned by command()
+	 * that was already run, e.g. during prefetch.
+	 */
+	Dasdview(const string& device, const SystemCmd& cmd);
+
+	/**
+	 * Returns the command run by the constructor.
+	 */
+	static string command(const string& device);
+
 	friend std::ostream& operator<<(std::ostream& s, const Dasdview& dasdview);
 
 	DasdType get_type() const { return type; }
@@ -48,6 +59,8 @@ namespace storage
 
     private:
 
+	void process(const SystemCmd& cmd);
+
 	void parse(const std::vector<string>& lines);
 
 	string device;
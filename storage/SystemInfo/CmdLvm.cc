@@ -36,6 +36,13 @@
 
 #define COMMON_LVM_OPTIONS "--reportformat json --units b --nosuffix"
 
+#define PVS_OPTIONS "pv_name,pv_uuid,vg_name,vg_uuid,pv_attr"
+
+#define LVS_OPTIONS "lv_name,lv_uuid,vg_name,vg_uuid,lv_role,lv_attr,lv_size,stripes,stripe_size," \
+    "chunk_size,pool_lv,pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid"
+
+#define VGS_OPTIONS "vg_name,vg_uuid,vg_attr,vg_extent_size,vg_extent_count,vg_free_count"
+
 
 namespace storage
 {
@@ -43,42 +50,73 @@ namespace storage
 
 
     void
-    CmdLvm::parse(const vector<string>& lines, const char* tag)
+    CmdLvm::parse(const string& json, const map<string, CmdLvm*>& cmds)
     {
-	JsonFile json_file(lines);
+	JsonReader reader(json);
+	JsonRecord record;
 
-	vector<json_object*> tmp1;
-	if (get_child_nodes(json_file.get_root(), "report", tmp1))
+	reader.expect(JsonReader::Token::BEGIN_OBJECT);
+
+	while (reader.next_key())
 	{
-	    for (json_object* tmp2 : tmp1)
+	    if (reader.get_value() != "report")
+	    {
+		reader.skip_value();
+		continue;
+	    }
+
+	    reader.expect(JsonReader::Token::BEGIN_ARRAY);
+
+	    while (reader.next_object())
 	    {
-		vector<json_object*> tmp3;
-		if (get_child_nodes(tmp2, tag, tmp3))
+		while (reader.next_key())
 		{
-		    for (json_object* tmp4 : tmp3)
-			parse(tmp4);
+		    map<string, CmdLvm*>::const_iterator it = cmds.find(reader.get_value().to_string());
+		    if (it == cmds.end())
+		    {
+			reader.skip_value();
+			continue;
+		    }
+
+		    reader.expect(JsonReader::Token::BEGIN_ARRAY);
+
+		    while (reader.next_object())
+		    {
+			reader.read_record(record);
+			it->second->parse(record);
+		    }
 		}
 	    }
 	}
+
+	for (const map<string, CmdLvm*>::value_type& value : cmds)
+	    value.second->parsed();
     }
 
 
-    CmdPvs::CmdPvs()
+    CmdPvs::CmdPvs(bool do_probe)
     {
-	SystemCmd cmd(PVSBIN " " COMMON_LVM_OPTIONS " --options pv_name,pv_uuid,vg_name,vg_uuid,"
-		      "pv_attr");
-	if (cmd.retcode() == 0 && !cmd.stdout().empty())
-	    parse(cmd.stdout());
+	if (!do_probe)
+	    return;
+
+	SystemCmd cmd(PVSBIN " " COMMON_LVM_OPTIONS " --options " PVS_OPTIONS);
+	if (cmd.retcode() == 0 && !cmd.stdout_buffer().empty())
+	    parse(cmd.stdout_buffer());
     }
 
 
     void
-    CmdPvs::parse(const vector<string>& lines)
+    CmdPvs::parse(const string& json)
     {
 	pvs.clear();
 
-	CmdLvm::parse(lines, "pv");
+	CmdLvm::parse(json, { { "pv", this } });
+    }
+
 
+    void
+    CmdPvs::parsed()
+    {
 	sort(pvs.begin(), pvs.end(), [](const Pv& lhs, const Pv& rhs) { return lhs.pv_name < rhs.pv_name; });
 
 	y2mil(*this);
@@ -86,18 +124,18 @@ namespace storage
 
 
     void
-    CmdPvs::parse(json_object* object)
+    CmdPvs::parse(const JsonRecord& record)
     {
 	Pv pv;
 
-	get_child_value(object, "pv_name", pv.pv_name);
-	get_child_value(object, "pv_uuid", pv.pv_uuid);
+	get_child_value(record, "pv_name", pv.pv_name);
+	get_child_value(record, "pv_uuid", pv.pv_uuid);
 
-	get_child_value(object, "vg_name", pv.vg_name);
-	get_child_value(object, "vg_uuid", pv.vg_uuid);
+	get_child_value(record, "vg_name", pv.vg_name);
+	get_child_value(record, "vg_uuid", pv.vg_uuid);
 
 	string pv_attr;
-	get_child_value(object, "pv_attr", pv_attr);
+	get_child_value(record, "pv_attr", pv_attr);
 	if (pv_attr.size() < 3)
 	    ST_THROW(ParseException("bad pv_attr", pv_attr, "a--"));
 
@@ -138,24 +176,30 @@ namespace storage
     }
 
 
-    CmdLvs::CmdLvs()
+    CmdLvs::CmdLvs(bool do_probe)
     {
-	SystemCmd cmd(LVSBIN " " COMMON_LVM_OPTIONS " --all --options lv_name,lv_uuid,vg_name,"
-		      "vg_uuid,lv_role,lv_attr,lv_size,stripes,stripe_size,chunk_size,pool_lv,"
-		      "pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid");
+	if (!do_probe)
+	    return;
+
+	SystemCmd cmd(LVSBIN " " COMMON_LVM_OPTIONS " --all --options " LVS_OPTIONS);
 
-	if (cmd.retcode() == 0 && !cmd.stdout().empty())
-	    parse(cmd.stdout());
+	if (cmd.retcode() == 0 && !cmd.stdout_buffer().empty())
+	    parse(cmd.stdout_buffer());
     }
 
 
     void
-    CmdLvs::parse(const vector<string>& lines)
+    CmdLvs::parse(const string& json)
     {
 	lvs.clear();
 
-	CmdLvm::parse(lines, "lv");
+	CmdLvm::parse(json, { { "lv", this } });
+    }
+
 
+    void
+    CmdLvs::parsed()
+    {
 	sort(lvs.begin(), lvs.end(), [](const Lv& lhs, const Lv& rhs) { return lhs.lv_name < rhs.lv_name; });
 
 	y2mil(*this);
@@ -163,25 +207,25 @@ namespace storage
 
 
     void
-    CmdLvs::parse(json_object* object)
+    CmdLvs::parse(const JsonRecord& record)
     {
 	Lv lv;
 
-	get_child_value(object, "lv_name", lv.lv_name);
-	get_child_value(object, "lv_uuid", lv.lv_uuid);
+	get_child_value(record, "lv_name", lv.lv_name);
+	get_child_value(record, "lv_uuid", lv.lv_uuid);
 
-	get_child_value(object, "lv_size", lv.size);
+	get_child_value(record, "lv_size", lv.size);
 
-	get_child_value(object, "stripes", lv.stripes);
-	get_child_value(object, "stripe_size", lv.stripe_size);
+	get_child_value(record, "stripes", lv.stripes);
+	get_child_value(record, "stripe_size", lv.stripe_size);
 
-	get_child_value(object, "chunk_size", lv.chunk_size);
+	get_child_value(record, "chunk_size", lv.chunk_size);
 
-	get_child_value(object, "vg_name", lv.vg_name);
-	get_child_value(object, "vg_uuid", lv.vg_uuid);
+	get_child_value(record, "vg_name", lv.vg_name);
+	get_child_value(record, "vg_uuid", lv.vg_uuid);
 
 	string lv_attr;
-	get_child_value(object, "lv_attr", lv_attr);
+	get_child_value(record, "lv_attr", lv_attr);
 
 	lv.active = lv_attr[4] == 'a';
 
@@ -193,14 +237,14 @@ namespace storage
 	    case 'r': lv.lv_type = LvType::RAID; break;
 	}
 
-	get_child_value(object, "pool_lv", lv.pool_name);
-	get_child_value(object, "pool_lv_uuid", lv.pool_uuid);
+	get_child_value(record, "pool_lv", lv.pool_name);
+	get_child_value(record, "pool_lv_uuid", lv.pool_uuid);
 
-	get_child_value(object, "data_lv", lv.data_name);
-	get_child_value(object, "data_lv_uuid", lv.data_uuid);
+	get_child_value(record, "data_lv", lv.data_name);
+	get_child_value(record, "data_lv_uuid", lv.data_uuid);
 
-	get_child_value(object, "metadata_lv", lv.metadata_name);
-	get_child_value(object, "metadata_lv_uuid", lv.metadata_uuid);
+	get_child_value(record, "metadata_lv", lv.metadata_name);
+	get_child_value(record, "metadata_lv_uuid", lv.metadata_uuid);
 
 	lvs.push_back(lv);
     }
@@ -274,22 +318,29 @@ namespace storage
     }
 
 
-    CmdVgs::CmdVgs()
+    CmdVgs::CmdVgs(bool do_probe)
     {
-	SystemCmd cmd(VGSBIN " " COMMON_LVM_OPTIONS " --options vg_name,vg_uuid,vg_attr,"
-		      "vg_extent_size,vg_extent_count,vg_free_count");
-	if (cmd.retcode() == 0 && !cmd.stdout().empty())
-	    parse(cmd.stdout());
+	if (!do_probe)
+	    return;
+
+	SystemCmd cmd(VGSBIN " " COMMON_LVM_OPTIONS " --options " VGS_OPTIONS);
+	if (cmd.retcode() == 0 && !cmd.stdout_buffer().empty())
+	    parse(cmd.stdout_buffer());
     }
 
 
     void
-    CmdVgs::parse(const vector<string>& lines)
+    CmdVgs::parse(const string& json)
     {
 	vgs.clear();
 
-	CmdLvm::parse(lines, "vg");
+	CmdLvm::parse(json, { { "vg", this } });
+    }
+
 
+    void
+    CmdVgs::parsed()
+    {
 	sort(vgs.begin(), vgs.end(), [](const Vg& lhs, const Vg& rhs) { return lhs.vg_name < rhs.vg_name; });
 
 	y2mil(*this);
@@ -297,21 +348,21 @@ namespace storage
 
 
     void
-    CmdVgs::parse(json_object* object)
+    CmdVgs::parse(const JsonRecord& record)
     {
 	Vg vg;
 
-	get_child_value(object, "vg_name", vg.vg_name);
-	get_child_value(object, "vg_uuid", vg.vg_uuid);
+	get_child_value(record, "vg_name", vg.vg_name);
+	get_child_value(record, "vg_uuid", vg.vg_uuid);
 
 	string vg_attr;
-	get_child_value(object, "vg_attr", vg_attr);
+	get_child_value(record, "vg_attr", vg_attr);
 	if (vg_attr.size() < 6)
 	    ST_THROW(ParseException("bad vg_attr", vg_attr, "wz--n-"));
 
-	get_child_value(object, "vg_extent_size", vg.extent_size);
-	get_child_value(object, "vg_extent_count", vg.extent_count);
-	get_child_value(object, "vg_free_count", vg.free_extent_count);
+	get_child_value(record, "vg_extent_size", vg.extent_size);
+	get_child_value(record, "vg_extent_count", vg.extent_count);
+	get_child_value(record, "vg_free_count", vg.free_extent_count);
 
 	vgs.push_back(vg);
     }
@@ -350,4 +401,32 @@ namespace storage
 	return s;
     }
 
+
+    CmdLvmFullreport::CmdLvmFullreport()
+    {
+	// The segment reports cannot be disabled so request only a single
+	// column for them.
+
+	SystemCmd cmd(LVMBIN " fullreport " COMMON_LVM_OPTIONS " --all --configreport pv --options "
+		      PVS_OPTIONS " --configreport vg --options " VGS_OPTIONS " --configreport lv "
+		      "--options " LVS_OPTIONS " --configreport pvseg --options pvseg_start "
+		      "--configreport seg --options seg_start");
+
+	if (cmd.retcode() != 0 || cmd.stdout_buffer().empty())
+	    ST_THROW(SystemCmdException(&cmd, "lvm fullreport failed"));
+
+	parse(cmd.stdout_buffer());
+    }
+
+
+    void
+    CmdLvmFullreport::parse(const string& json)
+    {
+	cmd_pvs = std::make_shared<CmdPvs>(false);
+	cmd_vgs = std::make_shared<CmdVgs>(false);
+	cmd_lvs = std::make_shared<CmdLvs>(false);
+
+	CmdLvm::parse(json, { { "pv", cmd_pvs.get() }, { "vg", cmd_vgs.get() }, { "lv", cmd_lvs.get() } });
+    }
+
 }
@@ -27,6 +27,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <memory>
 
 #include "storage/Devices/LvmLv.h"
 #include "storage/Utils/JsonFile.h"
@@ -44,18 +46,35 @@ namespace storage
 
 	virtual ~CmdLvm() {}
 
-	void parse(const vector<string>& lines, const char* tag);
+	/**
+	 * Reads the JSON output of the LVM report commands in a single pass
+	 * and calls parse() of the command registered for the tag of the
+	 * report, e.g. "pv", "vg" or "lv", for every object in the reports.
+	 * Afterwards calls parsed() of all commands.
+	 */
+	static void parse(const string& json, const std::map<string, CmdLvm*>& cmds);
 
-	virtual void parse(json_object* object) = 0;
+	virtual void parse(const JsonRecord& record) = 0;
+
+	/**
+	 * Called after all objects are parsed.
+	 */
+	virtual void parsed() = 0;
+
+	friend class CmdLvmFullreport;
 
     };
 
 
-    class CmdPvs : protected CmdLvm
+    class CmdPvs : public CmdLvm
     {
     public:
 
-	CmdPvs();
+	/**
+	 * Without do_probe the object stays empty, used by
+	 * CmdLvmFullreport.
+	 */
+	CmdPvs(bool do_probe = true);
 
 	struct Pv
 	{
@@ -76,19 +95,24 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
-	void parse(json_object* object) override;
+	void parse(const string& json);
+	void parse(const JsonRecord& record) override;
+	void parsed() override;
 
 	vector<Pv> pvs;
 
     };
 
 
-    class CmdLvs : protected CmdLvm
+    class CmdLvs : public CmdLvm
     {
     public:
 
-	CmdLvs();
+	/**
+	 * Without do_probe the object stays empty, used by
+	 * CmdLvmFullreport.
+	 */
+	CmdLvs(bool do_probe = true);
 
 	struct Lv
 	{
@@ -125,19 +149,24 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
-	void parse(json_object* object) override;
+	void parse(const string& json);
+	void parse(const JsonRecord& record) override;
+	void parsed() override;
 
 	vector<Lv> lvs;
 
     };
 
 
-    class CmdVgs : protected CmdLvm
+    class CmdVgs : public CmdLvm
     {
     public:
 
-	CmdVgs();
+	/**
+	 * Without do_probe the object stays empty, used by
+	 * CmdLvmFullreport.
+	 */
+	CmdVgs(bool do_probe = true);
 
 	struct Vg
 	{
@@ -159,13 +188,42 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
-	void parse(json_object* object) override;
+	void parse(const string& json);
+	void parse(const JsonRecord& record) override;
+	void parsed() override;
 
 	vector<Vg> vgs;
 
     };
 
+
+    /**
+     * Runs lvm fullreport which reports the pvs, vgs and lvs with a single
+     * scan of the devices instead of one scan each for pvs, vgs and lvs.
+     */
+    class CmdLvmFullreport
+    {
+    public:
+
+	/**
+	 * @throw SystemCmdException, Exception
+	 */
+	CmdLvmFullreport();
+
+	const std::shared_ptr<CmdPvs>& get_cmd_pvs() const { return cmd_pvs; }
+	const std::shared_ptr<CmdVgs>& get_cmd_vgs() const { return cmd_vgs; }
+	const std::shared_ptr<CmdLvs>& get_cmd_lvs() const { return cmd_lvs; }
+
+    private:
+
+	void parse(const string& json);
+
+	std::shared_ptr<CmdPvs> cmd_pvs;
+	std::shared_ptr<CmdVgs> cmd_vgs;
+	std::shared_ptr<CmdLvs> cmd_lvs;
+
+    };
+
 }
 
 #endif
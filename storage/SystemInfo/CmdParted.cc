@@ -21,10 +21,20 @@
  */
 
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <endian.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
 #include <fstream>
+#include <boost/crc.hpp>
 
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/Mockup.h"
+#include "storage/Utils/Remote.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/SystemInfo/CmdParted.h"
@@ -43,9 +53,26 @@ namespace storage
 	: device(device), label(PtType::UNKNOWN), region(), implicit(false),
 	  gpt_enlarge(false), gpt_pmbr_boot(false), logical_sector_size(0), physical_sector_size(0)
     {
-	SystemCmd cmd(PARTEDBIN " --script --machine " + quote(device) + " unit s print",
-		      SystemCmd::DoThrow);
+	if (read_disk())
+	    return;
 
+	SystemCmd cmd(command(device), SystemCmd::DoThrow);
+
+	process(cmd);
+    }
+
+
+    Parted::Parted(const string& device, const SystemCmd& cmd)
+	: device(device), label(PtType::UNKNOWN), region(), implicit(false),
+	  gpt_enlarge(false), gpt_pmbr_boot(false), logical_sector_size(0), physical_sector_size(0)
+    {
+	process(cmd);
+    }
+
+
+    void
+    Parted::process(const SystemCmd& cmd)
+    {
 	// No check for exit status since parted 3.1 exits with 1 if no
 	// partition table is found.
 
@@ -75,6 +102,465 @@ namespace storage
     }
 
 
+    string
+    Parted::command(const string& device)
+    {
+	return PARTEDBIN " --script --machine " + quote(device) + " unit s print";
+    }
+
+
+    Parted::Parted(const string& device, Direct)
+	: device(device), label(PtType::UNKNOWN), region(), implicit(false),
+	  gpt_enlarge(false), gpt_pmbr_boot(false), logical_sector_size(0), physical_sector_size(0)
+    {
+    }
+
+
+    std::shared_ptr<Parted>
+    Parted::read_directly(const string& device)
+    {
+	std::shared_ptr<Parted> parted(new Parted(device, Direct()));
+
+	if (!parted->read_disk())
+	    return nullptr;
+
+	return parted;
+    }
+
+
+    namespace
+    {
+
+	bool
+	direct_possible(const string& device)
+	{
+	    // DASDs have their own partition tables.
+
+	    return Mockup::get_mode() == Mockup::Mode::NONE && !get_remote_callbacks() &&
+		!boost::starts_with(device, DEVDIR "/dasd");
+	}
+
+
+	uint16_t
+	get_le16(const unsigned char* p)
+	{
+	    uint16_t tmp;
+	    memcpy(&tmp, p, sizeof(tmp));
+	    return le16toh(tmp);
+	}
+
+
+	uint32_t
+	get_le32(const unsigned char* p)
+	{
+	    uint32_t tmp;
+	    memcpy(&tmp, p, sizeof(tmp));
+	    return le32toh(tmp);
+	}
+
+
+	uint64_t
+	get_le64(const unsigned char* p)
+	{
+	    uint64_t tmp;
+	    memcpy(&tmp, p, sizeof(tmp));
+	    return le64toh(tmp);
+	}
+
+
+	vector<unsigned char>
+	read_bytes(int fd, unsigned long long offset, size_t count)
+	{
+	    vector<unsigned char> ret(count);
+
+	    size_t done = 0;
+	    while (done < count)
+	    {
+		ssize_t r = pread(fd, ret.data() + done, count - done, offset + done);
+		if (r < 0 && errno == EINTR)
+		    continue;
+
+		if (r < 0)
+		    ST_THROW(Exception(Exception::strErrno(errno, "pread failed")));
+
+		if (r == 0)
+		    ST_THROW(Exception("short read"));
+
+		done += r;
+	    }
+
+	    return ret;
+	}
+
+
+	uint32_t
+	crc32(const unsigned char* data, size_t count)
+	{
+	    boost::crc_32_type crc;
+	    crc.process_bytes(data, count);
+	    return crc.checksum();
+	}
+
+
+	/**
+	 * The GPT partition types for which parted reports a flag and the
+	 * resulting ids, see Parted::scan_entry_flags(). Other types are
+	 * reported as ID_LINUX.
+	 */
+	const vector<pair<string, unsigned int>> gpt_types = {
+	    { "A19D880F-05FC-4D3B-A006-743F0F84911E", ID_RAID },
+	    { "E6D6D379-F507-44C2-A23C-238F2A3DF928", ID_LVM },
+	    { "9E1A2D38-C612-4316-AA26-8B49521E5A8B", ID_PREP },
+	    { "C12A7328-F81F-11D2-BA4B-00A0C93EC93B", ID_ESP },
+	    { "0657FD6D-A4AB-43C4-84E5-0933C84B4F4F", ID_SWAP },
+	    { "21686148-6449-6E6F-744E-656564454649", ID_BIOS_BOOT },
+	    { "EBD0A0A2-B9E5-4433-87C0-68B6B72699C7", ID_WINDOWS_BASIC_DATA },
+	    { "E3C9E316-0B5C-4DB8-817D-F92DF00215AE", ID_MICROSOFT_RESERVED },
+	    { "DE94BBA4-06D1-4D40-A16A-BFD50179D6AC", ID_DIAG }
+	};
+
+
+	unsigned int
+	gpt_type_to_id(const unsigned char* p)
+	{
+	    // The first three fields of a GUID are stored little-endian.
+
+	    string guid = sformat("%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X", get_le32(p),
+				  get_le16(p + 4), get_le16(p + 6), p[8], p[9], p[10], p[11], p[12],
+				  p[13], p[14], p[15]);
+
+	    for (const pair<string, unsigned int>& gpt_type : gpt_types)
+	    {
+		if (gpt_type.first == guid)
+		    return gpt_type.second;
+	    }
+
+	    return ID_LINUX;
+	}
+
+
+	bool
+	valid_gpt_header(const vector<unsigned char>& header, unsigned long long lba)
+	{
+	    if (memcmp(header.data(), "EFI PART", 8) != 0)
+		return false;
+
+	    uint32_t header_size = get_le32(&header[12]);
+	    if (header_size < 92 || header_size > header.size())
+		return false;
+
+	    vector<unsigned char> tmp(header.begin(), header.begin() + header_size);
+	    memset(&tmp[16], 0, 4);
+
+	    if (crc32(tmp.data(), tmp.size()) != get_le32(&header[16]))
+		return false;
+
+	    return get_le64(&header[24]) == lba;
+	}
+
+
+	vector<unsigned char>
+	read_gpt_entries(int fd, const vector<unsigned char>& header, unsigned int sector_size)
+	{
+	    uint64_t lba = get_le64(&header[72]);
+	    uint32_t num = get_le32(&header[80]);
+	    uint32_t size = get_le32(&header[84]);
+
+	    if (size < 128 || num > 1024)
+		return vector<unsigned char>();
+
+	    vector<unsigned char> entries = read_bytes(fd, lba * sector_size, num * size);
+
+	    if (crc32(entries.data(), entries.size()) != get_le32(&header[88]))
+		return vector<unsigned char>();
+
+	    return entries;
+	}
+
+
+	const unsigned int mbr_entries_offset = 446;
+
+    }
+
+
+    bool
+    Parted::read_disk()
+    {
+	if (!direct_possible(device))
+	    return false;
+
+	int fd = open(device.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+	    y2war(Exception::strErrno(errno, "open of " + device + " failed"));
+	    return false;
+	}
+
+	implicit = false;
+	gpt_enlarge = false;
+	gpt_fix_backup = false;
+	gpt_pmbr_boot = false;
+	entries.clear();
+
+	bool ret = false;
+
+	try
+	{
+	    unsigned long long size = 0;
+
+	    struct stat st;
+	    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+	    {
+		// image file, e.g. for testing
+		size = st.st_size;
+		logical_sector_size = physical_sector_size = 512;
+	    }
+	    else
+	    {
+		unsigned int tmp = 0;
+
+		if (ioctl(fd, BLKGETSIZE64, &size) < 0 || ioctl(fd, BLKSSZGET, &logical_sector_size) < 0 ||
+		    ioctl(fd, BLKPBSZGET, &tmp) < 0)
+		    ST_THROW(Exception(Exception::strErrno(errno, "ioctl failed")));
+
+		physical_sector_size = tmp;
+	    }
+
+	    if (logical_sector_size < 512 || size < 3ULL * logical_sector_size)
+		ST_THROW(Exception("device too small"));
+
+	    region = Region(0, size / logical_sector_size, logical_sector_size);
+
+	    vector<unsigned char> mbr = read_bytes(fd, 0, logical_sector_size);
+
+	    // Without the signature there is no partition table or a
+	    // filesystem on the whole device. Telling these apart is left to
+	    // parted.
+
+	    if (mbr[510] == 0x55 && mbr[511] == 0xAA)
+	    {
+		bool protective = false;
+
+		for (unsigned int i = 0; i < 4; ++i)
+		    if (mbr[mbr_entries_offset + 16 * i + 4] == 0xee)
+			protective = true;
+
+		ret = protective ? read_gpt(fd, mbr) : read_msdos(fd, mbr);
+	    }
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	    ret = false;
+	}
+
+	close(fd);
+
+	if (!ret)
+	{
+	    y2mil("reading partition table of " << device << " directly not possible");
+	    entries.clear();
+	    return false;
+	}
+
+	sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs)
+	    { return lhs.number < rhs.number; }
+	);
+
+	y2mil(*this);
+
+	return true;
+    }
+
+
+    bool
+    Parted::read_msdos(int fd, const vector<unsigned char>& mbr)
+    {
+	label = PtType::MSDOS;
+
+	// A FAT or NTFS boot sector also has the signature.
+
+	if (memcmp(&mbr[3], "NTFS", 4) == 0 || memcmp(&mbr[54], "FAT", 3) == 0 ||
+	    memcmp(&mbr[82], "FAT", 3) == 0)
+	    return false;
+
+	const unsigned long long num_sectors = region.get_length();
+
+	const Entry* extended = nullptr;
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+	    const unsigned char* p = &mbr[mbr_entries_offset + 16 * i];
+
+	    if (p[0] != 0x00 && p[0] != 0x80)
+		return false;
+
+	    unsigned int type = p[4];
+	    unsigned long long start = get_le32(p + 8);
+	    unsigned long long size = get_le32(p + 12);
+
+	    if (type == 0x00)
+		continue;
+
+	    if (size == 0 || start + size > num_sectors)
+		return false;
+
+	    // Other types of extended partitions are left to parted.
+	    if (type == 0x85 || type == 0x1f)
+		return false;
+
+	    Entry entry;
+	    entry.number = i + 1;
+	    entry.region = Region(start, size, logical_sector_size);
+	    entry.id = type;
+	    entry.boot = p[0] == 0x80;
+	    entry.type = (type == 0x05 || type == 0x0f) ? PartitionType::EXTENDED : PartitionType::PRIMARY;
+
+	    entries.push_back(entry);
+
+	    if (entry.type == PartitionType::EXTENDED)
+	    {
+		if (extended)
+		    return false;
+
+		extended = &entries.back();
+	    }
+	}
+
+	// No partitions at all is left to parted.
+
+	if (entries.empty())
+	    return false;
+
+	if (!extended)
+	    return true;
+
+	// The logical partitions are a chain of extended boot records. Each
+	// has the logical partition relative to itself and the next extended
+	// boot record relative to the extended partition.
+
+	const Region extended_region = extended->region;
+	unsigned long long ebr = extended_region.get_start();
+
+	for (unsigned int number = 5; ; ++number)
+	{
+	    if (number > 256 || ebr < extended_region.get_start() || ebr > extended_region.get_end())
+		return false;
+
+	    vector<unsigned char> sector = read_bytes(fd, ebr * logical_sector_size, logical_sector_size);
+	    if (sector[510] != 0x55 || sector[511] != 0xAA)
+		return false;
+
+	    const unsigned char* p = &sector[mbr_entries_offset];
+
+	    unsigned int type = p[4];
+	    unsigned long long start = ebr + get_le32(p + 8);
+	    unsigned long long size = get_le32(p + 12);
+
+	    // An extended partition without logical partitions.
+	    if (number == 5 && type == 0x00)
+		break;
+
+	    if ((p[0] != 0x00 && p[0] != 0x80) || type == 0x00 || size == 0 ||
+		start + size > extended_region.get_end() + 1)
+		return false;
+
+	    Entry entry;
+	    entry.number = number;
+	    entry.region = Region(start, size, logical_sector_size);
+	    entry.id = type;
+	    entry.boot = p[0] == 0x80;
+	    entry.type = PartitionType::LOGICAL;
+
+	    entries.push_back(entry);
+
+	    const unsigned char* q = &sector[mbr_entries_offset + 16];
+
+	    if (q[4] == 0x00)
+		break;
+
+	    if (q[4] != 0x05 && q[4] != 0x0f)
+		return false;
+
+	    ebr = extended_region.get_start() + get_le32(q + 8);
+	}
+
+	return true;
+    }
+
+
+    bool
+    Parted::read_gpt(int fd, const vector<unsigned char>& mbr)
+    {
+	label = PtType::GPT;
+
+	// A hybrid MBR has other partitions besides the protective one.
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+	    const unsigned char* p = &mbr[mbr_entries_offset + 16 * i];
+
+	    if (p[4] == 0xee)
+		gpt_pmbr_boot = p[0] == 0x80;
+	    else if (p[4] != 0x00)
+		return false;
+	}
+
+	const unsigned long long last_lba = region.get_length() - 1;
+
+	vector<unsigned char> header = read_bytes(fd, logical_sector_size, logical_sector_size);
+	if (!valid_gpt_header(header, 1))
+	    return false;
+
+	// If the backup is not at the end of the device, e.g. since the
+	// device was enlarged, or if the backup is broken parted reports
+	// that.
+
+	if (get_le64(&header[32]) != last_lba)
+	    return false;
+
+	vector<unsigned char> backup_header = read_bytes(fd, last_lba * logical_sector_size,
+							 logical_sector_size);
+	if (!valid_gpt_header(backup_header, last_lba) || get_le64(&backup_header[32]) != 1 ||
+	    get_le32(&backup_header[88]) != get_le32(&header[88]))
+	    return false;
+
+	vector<unsigned char> array = read_gpt_entries(fd, header, logical_sector_size);
+	if (array.empty() || read_gpt_entries(fd, backup_header, logical_sector_size).empty())
+	    return false;
+
+	const unsigned long long first_usable = get_le64(&header[40]);
+	const unsigned long long last_usable = get_le64(&header[48]);
+
+	const uint32_t num = get_le32(&header[80]);
+	const uint32_t size = get_le32(&header[84]);
+
+	for (uint32_t i = 0; i < num; ++i)
+	{
+	    const unsigned char* p = &array[i * size];
+
+	    if (all_of(p, p + 16, [](unsigned char c) { return c == 0; }))
+		continue;
+
+	    unsigned long long first = get_le64(p + 32);
+	    unsigned long long last = get_le64(p + 40);
+
+	    if (first > last || first < first_usable || last > last_usable)
+		return false;
+
+	    Entry entry;
+	    entry.number = i + 1;
+	    entry.region = Region(first, last - first + 1, logical_sector_size);
+	    entry.id = gpt_type_to_id(p);
+	    entry.legacy_boot = get_le64(p + 48) & (1ULL << 2);
+
+	    entries.push_back(entry);
+	}
+
+	return true;
+    }
+
+
     void
     Parted::parse(const vector<string>& stdout, const vector<string>& stderr)
     {
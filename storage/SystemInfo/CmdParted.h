@@ -25,6 +25,8 @@
 #define STORAGE_CMD_PARTED_H
 
 
+#include <memory>
+
 #include "storage/Utils/Region.h"
 #include "storage/Devices/PartitionTable.h"
 
@@ -34,6 +36,8 @@ namespace storage
     using std::string;
     using std::vector;
 
+    class SystemCmd;
+
 
     /**
      * Class for probing for partitions with the 'parted' command.
@@ -50,6 +54,27 @@ namespace storage
 	 */
 	Parted(const string& device);
 
+	/**
+	 * Constructor: Parse the output of the 'parted' command returned
+	 * by command() that was already run, e.g. during prefetch.
+	 * This may throw a SystemCmdException or a ParseException.
+	 */
+	Parted(const string& device, const SystemCmd& cmd);
+
+	/**
+	 * Returns the command run by the constructor.
+	 */
+	static string command(const string& device);
+
+	/**
+	 * Reads GPT and MS-DOS partition tables directly from the device
+	 * without running parted. Returns nullptr for other or exotic
+	 * partition tables, e.g. an enlarged GPT or a hybrid MBR, and
+	 * during mockup or with remote callbacks. Then parted must be
+	 * used. The constructor uses this function first.
+	 */
+	static std::shared_ptr<Parted> read_directly(const string& device);
+
         /**
 	 * Entry for one partition.
 	 */
@@ -118,6 +143,23 @@ namespace storage
 
     private:
 
+	struct Direct {};
+
+	/**
+	 * Constructor used by read_directly(). Does not probe anything.
+	 */
+	Parted(const string& device, Direct);
+
+	void process(const SystemCmd& cmd);
+
+	/**
+	 * Reads the partition table from the device. Returns false if that
+	 * is not possible.
+	 */
+	bool read_disk();
+	bool read_msdos(int fd, const vector<unsigned char>& mbr);
+	bool read_gpt(int fd, const vector<unsigned char>& mbr);
+
 	typedef vector<Entry>::const_iterator const_iterator;
 
 	string device;
@@ -22,9 +22,11 @@
 
 #include <sys/sysmacros.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/ExceptionImpl.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/SystemInfo/CmdUdevadm.h"
@@ -35,9 +37,126 @@ namespace storage
     using namespace std;
 
 
-    CmdUdevadmInfo::CmdUdevadmInfo(const string& file)
+    CmdUdevadmExportDb::CmdUdevadmExportDb()
+    {
+	// See comment in CmdUdevadmInfo::CmdUdevadmInfo().
+	SystemCmd(UDEVADMBIN_SETTLE);
+
+	SystemCmd cmd(UDEVADMBIN " info --export-db", SystemCmd::DoThrow);
+	if (cmd.retcode() != 0)
+	    ST_THROW(SystemCmdException(&cmd, "udevadm info --export-db failed"));
+
+	lines = cmd.stdout();
+
+	parse();
+    }
+
+
+    void
+    CmdUdevadmExportDb::parse()
+    {
+	// Records are separated by empty lines. Only records with a device
+	// node are of interest. Records without major and minor number are
+	// only indexed by name since they would otherwise all collide on 0:0.
+
+	size_t begin = 0;
+
+	vector<string> files;
+	unsigned int major = 0;
+	unsigned int minor = 0;
+	bool has_major = false;
+	bool has_minor = false;
+
+	for (size_t i = 0; i <= lines.size(); ++i)
+	{
+	    if (i == lines.size() || lines[i].empty())
+	    {
+		for (const string& file : files)
+		    records[file] = make_pair(begin, i);
+
+		if (!files.empty() && has_major && has_minor)
+		{
+		    vector<string>& tmp = files_by_majorminor[makedev(major, minor)];
+		    tmp.insert(tmp.end(), files.begin(), files.end());
+		}
+
+		files.clear();
+		major = minor = 0;
+		has_major = has_minor = false;
+		begin = i + 1;
+		continue;
+	    }
+
+	    const string& line = lines[i];
+
+	    if (boost::starts_with(line, "N: "))
+		files.push_back(DEVDIR "/" + line.substr(3));
+
+	    if (boost::starts_with(line, "S: "))
+		files.push_back(DEVDIR "/" + line.substr(3));
+
+	    if (boost::starts_with(line, "E: MAJOR="))
+	    {
+		line.substr(9) >> major;
+		has_major = true;
+	    }
+
+	    if (boost::starts_with(line, "E: MINOR="))
+	    {
+		line.substr(9) >> minor;
+		has_minor = true;
+	    }
+	}
+
+	y2mil(*this);
+    }
+
+
+    bool
+    CmdUdevadmExportDb::find(const string& file, vector<string>::const_iterator& begin,
+			     vector<string>::const_iterator& end) const
+    {
+	map<string, pair<size_t, size_t>>::const_iterator it = records.find(file);
+	if (it == records.end())
+	    return false;
+
+	begin = lines.begin() + it->second.first;
+	end = lines.begin() + it->second.second;
+
+	return true;
+    }
+
+
+    const vector<string>&
+    CmdUdevadmExportDb::find_by_majorminor(dev_t majorminor) const
+    {
+	static const vector<string> empty;
+
+	map<dev_t, vector<string>>::const_iterator it = files_by_majorminor.find(majorminor);
+	return it != files_by_majorminor.end() ? it->second : empty;
+    }
+
+
+    std::ostream&
+    operator<<(std::ostream& s, const CmdUdevadmExportDb& cmdudevadmexportdb)
+    {
+	s << "lines:" << cmdudevadmexportdb.lines.size() << " device-files:"
+	  << cmdudevadmexportdb.records.size() << '\n';
+
+	return s;
+    }
+
+
+    CmdUdevadmInfo::CmdUdevadmInfo(const key_t& file, const CmdUdevadmExportDb* cmdudevadmexportdb)
 	: file(file), path(), name(), majorminor(0), by_path_links(), by_id_links()
     {
+	vector<string>::const_iterator begin, end;
+	if (cmdudevadmexportdb && cmdudevadmexportdb->find(file, begin, end))
+	{
+	    parse(begin, end);
+	    return;
+	}
+
 	// Without emptying the udev queue 'udevadm info' can display old data
 	// or even complain about unknown devices. Even during probing this
 	// can happen since e.g. 'parted' opens the disk device read-write
@@ -47,17 +166,17 @@ namespace storage
 
 	SystemCmd cmd(UDEVADMBIN " info " + quote(file));
 	if (cmd.retcode() == 0)
-	    parse(cmd.stdout());
+	    parse(cmd.stdout().begin(), cmd.stdout().end());
     }
 
 
     void
-    CmdUdevadmInfo::parse(const vector<string>& stdout)
+    CmdUdevadmInfo::parse(vector<string>::const_iterator begin, vector<string>::const_iterator end)
     {
 	unsigned int major = 0;
 	unsigned int minor = 0;
 
-	for (const string& line : stdout)
+	for (const string& line : boost::make_iterator_range(begin, end))
 	{
 	    if (boost::starts_with(line, "P: "))
 		line.substr(2) >> path;
@@ -26,12 +26,63 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 
 namespace storage
 {
     using std::string;
     using std::vector;
+    using std::map;
+
+
+    /**
+     * Class to read the complete udev database with 'udevadm info
+     * --export-db'. Only one 'udevadm settle' is needed for the complete
+     * database instead of one per device.
+     */
+    class CmdUdevadmExportDb
+    {
+
+    public:
+
+	/**
+	 * This may throw a SystemCmdException.
+	 */
+	CmdUdevadmExportDb();
+
+	/**
+	 * Returns the range of lines of the database record for the device
+	 * file. The file can be the device name or a symbolic link created
+	 * by udev, e.g. /dev/sda or /dev/disk/by-id/wwn-0x500a0751. Returns
+	 * false if no record is found.
+	 */
+	bool find(const string& file, vector<string>::const_iterator& begin,
+		  vector<string>::const_iterator& end) const;
+
+	/**
+	 * Returns the device name and all symbolic links created by udev
+	 * for the device with the major and minor number. Returns an empty
+	 * vector if no such device is found.
+	 */
+	const vector<string>& find_by_majorminor(dev_t majorminor) const;
+
+	friend std::ostream& operator<<(std::ostream& s, const CmdUdevadmExportDb& cmdudevadmexportdb);
+
+    private:
+
+	void parse();
+
+	vector<string> lines;
+
+	// maps device files to the first line and the line after the last
+	// line of the record
+	map<string, std::pair<size_t, size_t>> records;
+
+	// maps major and minor numbers to the device files
+	map<dev_t, vector<string>> files_by_majorminor;
+
+    };
 
 
     class CmdUdevadmInfo
@@ -39,7 +90,13 @@ namespace storage
 
     public:
 
-	CmdUdevadmInfo(const string& file);
+	typedef string key_t;
+
+	/**
+	 * Runs 'udevadm info' for file unless the information is available
+	 * in cmdudevadmexportdb (which can be nullptr).
+	 */
+	CmdUdevadmInfo(const key_t& file, const CmdUdevadmExportDb* cmdudevadmexportdb = nullptr);
 
 	const string& get_path() const { return path; }
 	const string& get_name() const { return name; }
@@ -55,7 +112,7 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& stdout);
+	void parse(vector<string>::const_iterator begin, vector<string>::const_iterator end);
 
 	string file;
 
@@ -72,36 +72,23 @@ namespace storage
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	{
 	    const Mockup::File& mockup_file = Mockup::get_file(path);
-	    content = mockup_file.content;
-
-	    y2mil(*this);
+	    content.assign(mockup_file.content);
 	}
-
-	if (get_remote_callbacks())
+	else if (get_remote_callbacks())
 	{
 	    const RemoteFile mockup_file = get_remote_callbacks()->get_file(path);
-	    content = mockup_file.content;
+	    content.assign(mockup_file.content);
 	}
 	else
 	{
-	    ifstream s(path);
-	    classic(s);
-	    s.unsetf(ifstream::skipws);
-
-	    string line;
-	    getline(s, line);
-	    while (s.good())
-	    {
-		content.push_back(line);
-		getline(s, line);
-	    }
+	    content.read(path);
 	}
 
 	// TODO error checking
 
 	if (Mockup::get_mode() == Mockup::Mode::RECORD)
 	{
-	    Mockup::set_file(path, content);
+	    Mockup::set_file(path, content.to_lines());
 	}
 
 	y2mil(*this);
@@ -116,7 +103,7 @@ namespace storage
 	    ST_THROW(Exception("empty file"));
 
 	int ret;
-	content.front() >> ret;
+	content[0].to_string() >> ret;
 
 	// TODO error checking
 
@@ -132,7 +119,7 @@ namespace storage
 	    ST_THROW(Exception("empty file"));
 
 	unsigned long long ret;
-	content.front() >> ret;
+	content[0].to_string() >> ret;
 
 	// TODO error checking
 
@@ -147,7 +134,7 @@ namespace storage
 	if (content.empty())
 	    ST_THROW(Exception("empty file"));
 
-	return content.front();
+	return content[0].to_string();
     }
 
 
@@ -162,7 +149,7 @@ namespace storage
     std::ostream&
     operator<<(std::ostream& s, const File& file)
     {
-	s << "path:" << file.path << " content:" << file.content << '\n';
+	s << "path:" << file.path << " content:" << file.content.to_lines() << '\n';
 
 	return s;
     }
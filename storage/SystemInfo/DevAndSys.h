@@ -33,6 +33,8 @@
 #include <vector>
 #include <map>
 
+#include "storage/Utils/AsciiFile.h"
+
 
 namespace storage
 {
@@ -71,13 +73,8 @@ namespace storage
     {
     public:
 
-	typedef vector<string>::const_iterator const_iterator;
-
 	File(const string& path);
 
-	const_iterator begin() const { return content.begin(); }
-	const_iterator end() const { return content.end(); }
-
 	friend std::ostream& operator<<(std::ostream& s, const File& file);
 
 	template<typename Type> Type get() const;
@@ -86,7 +83,7 @@ namespace storage
 
 	string path;
 
-	vector<string> content;
+	LineBuffer content;
 
     };
 
@@ -43,20 +43,20 @@ namespace storage
 	AsciiFile mdstat("/proc/mdstat");
 	mdstat.log_content();
 
-	parse(mdstat.get_lines());
+	parse(mdstat.get_line_buffer());
     }
 
 
     void
-    ProcMdstat::parse(const vector<string>& lines)
+    ProcMdstat::parse(const LineBuffer& lines)
     {
-	for (vector<string>::const_iterator it1 = lines.begin(); it1 != lines.end(); ++it1)
+	for (size_t i = 0; i + 1 < lines.size(); ++i)
 	{
-	    if (extractNthWord(1, *it1) == ":")
+	    if (extract_nth_word(1, lines[i]) == ":")
 	    {
-		string name = extractNthWord(0, *it1);
+		string name = extract_nth_word(0, lines[i]).to_string();
 		if (boost::starts_with(name, "md"))
-		    data[name] = parse(*it1, *(it1 + 1));
+		    data[name] = parse(lines[i].to_string(), lines[i + 1].to_string());
 	    }
 	}
 
@@ -336,12 +336,27 @@ namespace storage
     MdadmDetail::MdadmDetail(const string& device)
 	: uuid(), devname(), metadata(), level(MdLevel::UNKNOWN), device(device)
     {
-	SystemCmd cmd(MDADMBIN " --detail " + quote(device) + " --export");
+	SystemCmd cmd(command(device));
 	if (cmd.retcode() == 0)
 	    parse(cmd.stdout());
     }
 
 
+    MdadmDetail::MdadmDetail(const string& device, const SystemCmd& cmd)
+	: uuid(), devname(), metadata(), level(MdLevel::UNKNOWN), device(device)
+    {
+	if (cmd.retcode() == 0)
+	    parse(cmd.stdout());
+    }
+
+
+    string
+    MdadmDetail::command(const string& device)
+    {
+	return MDADMBIN " --detail " + quote(device) + " --export";
+    }
+
+
     void
     MdadmDetail::parse(const vector<string>& lines)
     {
@@ -37,6 +37,9 @@ namespace storage
     using std::map;
     using std::vector;
 
+    class LineBuffer;
+    class SystemCmd;
+
 
     class ProcMdstat
     {
@@ -102,7 +105,7 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
+	void parse(const LineBuffer& lines);
 
 	Entry parse(const string& line1, const string& line2);
 
@@ -117,6 +120,17 @@ namespace storage
 
 	MdadmDetail(const string& device);
 
+	/**
+	 * Constructor for the result of the command returned by command()
+	 * that was already run, e.g. during prefetch.
+	 */
+	MdadmDetail(const string& device, const SystemCmd& cmd);
+
+	/**
+	 * Returns the command run by the constructor.
+	 */
+	static string command(const string& device);
+
 	string uuid;
 	string devname;
 	string metadata;
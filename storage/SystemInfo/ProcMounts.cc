@@ -40,8 +40,8 @@ namespace storage
 	AsciiFile mounts("/proc/mounts");
 	AsciiFile swaps("/proc/swaps");
 
-	parse_proc_mounts_lines(mounts.get_lines());
-	parse_proc_swaps_lines(swaps.get_lines());
+	parse_proc_mounts_lines(mounts.get_line_buffer());
+	parse_proc_swaps_lines(swaps.get_line_buffer());
     }
 
 
@@ -62,7 +62,7 @@ namespace storage
 
 
     void
-    ProcMounts::parse_proc_mounts_lines(const vector<string>& lines)
+    ProcMounts::parse_proc_mounts_lines(const LineBuffer& lines)
     {
         EtcFstab fstab("");
         fstab.parse( lines );
@@ -92,11 +92,11 @@ namespace storage
 
 
     void
-    ProcMounts::parse_proc_swaps_lines(const vector<string>& lines)
+    ProcMounts::parse_proc_swaps_lines(const LineBuffer& lines)
     {
-	for (size_t i=1; i < lines.size(); ++i)
+	for (size_t i = 1; i < lines.size(); ++i)
 	{
-	    string dev = EtcFstab::fstab_decode(extractNthWord(0, lines[i]));
+	    string dev = EtcFstab::fstab_decode(extract_nth_word(0, lines[i]).to_string());
 	    string::size_type pos = dev.find(" (deleted)");
 	    if (pos != string::npos)
 		dev.erase(pos);
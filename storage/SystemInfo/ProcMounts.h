@@ -39,6 +39,7 @@ namespace storage
     using std::multimap;
 
     class SystemInfo;
+    class LineBuffer;
 
 
     class ProcMounts
@@ -61,8 +62,8 @@ namespace storage
     protected:
 
         void clear();
-	void parse_proc_mounts_lines(const vector<string>& lines);
-	void parse_proc_swaps_lines (const vector<string>& lines);
+	void parse_proc_mounts_lines(const LineBuffer& lines);
+	void parse_proc_swaps_lines(const LineBuffer& lines);
 
 	typedef multimap<string, FstabEntry *>::const_iterator const_iterator;
 	typedef multimap<string, FstabEntry *>::value_type value_type;
@@ -38,23 +38,24 @@ namespace storage
     {
 	AsciiFile parts("/proc/partitions");
 
-	parse(parts.get_lines());
+	parse(parts.get_line_buffer());
     }
 
 
     void
-    ProcParts::parse(const vector<string>& lines)
+    ProcParts::parse(const LineBuffer& lines)
     {
 	data.clear();
 
-	for (vector<string>::const_iterator it = lines.begin(); it != lines.end(); ++it)
+	for (size_t i = 1; i < lines.size(); ++i)
 	{
-	    if (it == lines.begin() || it->empty())
+	    const boost::string_ref line = lines[i];
+	    if (line.empty())
 		continue;
 
-	    string device = DEVDIR "/" + extractNthWord(3, *it);
+	    string device = DEVDIR "/" + extract_nth_word(3, line).to_string();
 	    unsigned long long size_k;
-	    extractNthWord(2, *it) >> size_k;
+	    extract_nth_word(2, line).to_string() >> size_k;
 	    data[device] = size_k * KiB;
 	}
 
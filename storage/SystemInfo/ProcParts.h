@@ -36,6 +36,8 @@ namespace storage
     using std::map;
     using std::vector;
 
+    class LineBuffer;
+
 
     class ProcParts
     {
@@ -68,7 +70,7 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
+	void parse(const LineBuffer& lines);
 
 	const_iterator find_entry(const string& device) const;
 
@@ -20,9 +20,18 @@
  */
 
 
+#include <dirent.h>
+#include <string.h>
+#include <functional>
+#include <boost/algorithm/string.hpp>
+
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/Stopwatch.h"
 #include "storage/SystemInfo/SystemInfo.h"
+#include "storage/Devices/MdImpl.h"
 
 
 namespace storage
@@ -39,4 +48,288 @@ namespace storage
 	y2deb("destructed SystemInfo");
     }
 
+
+    namespace
+    {
+
+	bool
+	has_holders(const string& sysfs_path)
+	{
+	    DIR* dir = opendir((SYSFSDIR + sysfs_path + "/holders").c_str());
+	    if (!dir)
+		return false;
+
+	    bool ret = false;
+
+	    while (struct dirent* entry = readdir(dir))
+	    {
+		if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+		{
+		    ret = true;
+		    break;
+		}
+	    }
+
+	    closedir(dir);
+
+	    return ret;
+	}
+
+
+	/**
+	 * A command run during prefetch and the function storing the
+	 * result in the cache of the SystemInfo.
+	 */
+	struct PrefetchCommand
+	{
+	    PrefetchCommand(const SystemCmd::Options& options,
+			    const std::function<void(const SystemCmd&)>& store)
+		: options(options), store(store) {}
+
+	    SystemCmd::Options options;
+	    std::function<void(const SystemCmd&)> store;
+	};
+
+
+	/**
+	 * Runs the commands concurrently with at most max_parallel commands
+	 * at the same time and passes the results to the store functions.
+	 * Results that cannot be stored, e.g. since the command could not
+	 * be run, are dropped. The command is simply run again when the
+	 * object is requested and the error reported then.
+	 */
+	void
+	run_prefetch_commands(const vector<PrefetchCommand>& commands, unsigned int max_parallel)
+	{
+	    y2mil("prefetch commands:" << commands.size() << " max-parallel:" << max_parallel);
+
+	    Stopwatch stopwatch;
+
+	    vector<SystemCmd::Future> futures;
+	    vector<const PrefetchCommand*> running;
+
+	    vector<PrefetchCommand>::const_iterator next = commands.begin();
+
+	    while (next != commands.end() || !running.empty())
+	    {
+		while (next != commands.end() && running.size() < max_parallel)
+		{
+		    futures.push_back(SystemCmd::start(next->options));
+		    running.push_back(&*next++);
+		}
+
+		SystemCmd::wait_any(futures);
+
+		for (size_t i = 0; i < futures.size();)
+		{
+		    if (!futures[i].ready())
+		    {
+			++i;
+			continue;
+		    }
+
+		    try
+		    {
+			running[i]->store(futures[i].get());
+		    }
+		    catch (const Exception& exception)
+		    {
+			ST_CAUGHT(exception);
+		    }
+
+		    futures.erase(futures.begin() + i);
+		    running.erase(running.begin() + i);
+		}
+	    }
+
+	    y2mil("stopwatch " << stopwatch << " for prefetch");
+	}
+
+    }
+
+
+    void
+    SystemInfo::prefetch()
+    {
+	// The selection of devices follows Disk::Impl::probe_disks(),
+	// Dasd::Impl::probe_dasds(), Md::Impl::probe_mds() and
+	// Luks::Impl::probe_lukses(). Parted is not run for disks used by
+	// something else, e.g. multipath. The btrfs subvolume lists are not
+	// prefetched since they need a mounted filesystem, see
+	// Btrfs::Impl::probe_pass_2().
+
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks())
+	    return;
+
+	vector<PrefetchCommand> commands;
+
+	try
+	{
+	    for (const string& short_name : getDir(SYSFSDIR "/block"))
+	    {
+		string name = DEVDIR "/" + short_name;
+
+		if (Md::Impl::is_valid_sysfs_name(name))
+		{
+		    if (getProcMdstat().has_entry(short_name) && !mdadmdetails.includes(name))
+		    {
+			commands.emplace_back(MdadmDetail::command(name), [this, name](const SystemCmd& cmd) {
+			    mdadmdetails.set(name, std::make_shared<MdadmDetail>(name, cmd));
+			});
+		    }
+		    continue;
+		}
+
+		if (boost::starts_with(name, DEVDIR "/loop"))
+		    continue;
+
+		const CmdUdevadmInfo& cmdudevadminfo = getCmdUdevadmInfo(name);
+
+		if (getFile(SYSFSDIR + cmdudevadminfo.get_path() + "/ext_range").get<int>() <= 1)
+		    continue;
+
+		if (boost::starts_with(name, DEVDIR "/dasd"))
+		{
+		    if (!dasdviews.includes(name))
+		    {
+			commands.emplace_back(Dasdview::command(name), [this, name](const SystemCmd& cmd) {
+			    dasdviews.set(name, std::make_shared<Dasdview>(name, cmd));
+			});
+		    }
+		}
+		else if (!has_holders(cmdudevadminfo.get_path()) && !parteds.includes(name))
+		{
+		    // Most partition tables can be read directly, parted is
+		    // only run for the others.
+
+		    std::shared_ptr<Parted> parted = Parted::read_directly(name);
+		    if (parted)
+			parteds.set(name, parted);
+		    else
+		    {
+			SystemCmd::Options options(Parted::command(name), SystemCmd::DoThrow);
+			commands.emplace_back(options, [this, name](const SystemCmd& cmd) {
+			    parteds.set(name, std::make_shared<Parted>(name, cmd));
+			});
+		    }
+		}
+	    }
+	}
+	catch (const Exception& exception)
+	{
+	    // errors are reported when the objects are requested during
+	    // probing
+	    ST_CAUGHT(exception);
+	}
+
+	try
+	{
+	    for (const CmdDmsetupInfo::value_type& value : getCmdDmsetupInfo())
+	    {
+		if (value.second.subsystem != "CRYPT")
+		    continue;
+
+		const string& name = value.first;
+
+		if (!cmd_cryptsetups.includes(name))
+		{
+		    commands.emplace_back(CmdCryptsetup::command(name), [this, name](const SystemCmd& cmd) {
+			cmd_cryptsetups.set(name, std::make_shared<CmdCryptsetup>(name, cmd));
+		    });
+		}
+	    }
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	}
+
+	run_prefetch_commands(commands, 16);
+    }
+
+
+    void
+    SystemInfo::reuse(const SystemInfo& old, const set<string>& affected)
+    {
+	// Only the results keyed by the device are taken over. Results of
+	// btrfs commands are keyed by one of the devices of the
+	// filesystem. So affected must include all devices of a filesystem
+	// if one of them changed.
+
+	auto unaffected = [&affected](const string& device) {
+	    return affected.find(device) == affected.end();
+	};
+
+	mdadmdetails.reuse(old.mdadmdetails, unaffected);
+	parteds.reuse(old.parteds, unaffected);
+	dasdviews.reuse(old.dasdviews, unaffected);
+
+	cmdbtrfssubvolumelists.reuse(old.cmdbtrfssubvolumelists, unaffected);
+	cmdbtrfssubvolumegetdefaults.reuse(old.cmdbtrfssubvolumegetdefaults, unaffected);
+
+	cmdlsattr.reuse(old.cmdlsattr, [&unaffected](const CmdLsattr::key_t& key) {
+	    return unaffected(std::get<0>(key));
+	});
+    }
+
+
+    const CmdUdevadmInfo&
+    SystemInfo::getCmdUdevadmInfo(const string& file)
+    {
+	// The complete udev database is read once so that 'udevadm settle'
+	// and 'udevadm info' do not have to be run for every device. If that
+	// fails, e.g. during playback of old mockup files, CmdUdevadmInfo
+	// falls back to query the device individually.
+
+	const CmdUdevadmExportDb* tmp = nullptr;
+
+	if (!cmdudevadminfos.includes(file))
+	    tmp = getCmdUdevadmExportDb();
+
+	return cmdudevadminfos.get(file, tmp);
+    }
+
+
+    void
+    SystemInfo::use_cmd_lvm_fullreport()
+    {
+	if (cmd_lvm_fullreport_tried)
+	    return;
+
+	cmd_lvm_fullreport_tried = true;
+
+	try
+	{
+	    CmdLvmFullreport cmd_lvm_fullreport;
+
+	    cmdpvs.set(cmd_lvm_fullreport.get_cmd_pvs());
+	    cmdvgs.set(cmd_lvm_fullreport.get_cmd_vgs());
+	    cmdlvs.set(cmd_lvm_fullreport.get_cmd_lvs());
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	}
+    }
+
+
+    const CmdUdevadmExportDb*
+    SystemInfo::getCmdUdevadmExportDb()
+    {
+	if (cmd_udevadm_export_db_failed)
+	    return nullptr;
+
+	try
+	{
+	    return &cmdudevadmexportdb.get();
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+
+	    cmd_udevadm_export_db_failed = true;
+	    return nullptr;
+	}
+    }
+
 }
@@ -25,6 +25,7 @@
 #define STORAGE_SYSTEM_INFO_H
 
 
+#include <set>
 #include <boost/noncopyable.hpp>
 
 #include "storage/EtcFstab.h"
@@ -54,6 +55,7 @@
 namespace storage
 {
     using std::map;
+    using std::set;
 
 
     class SystemInfo : private boost::noncopyable
@@ -75,6 +77,21 @@ namespace storage
 	SystemInfo();
 	~SystemInfo();
 
+	/**
+	 * Runs the commands needed for every disk, DASD and MD during
+	 * probing concurrently. The results are stored in the caches of
+	 * this SystemInfo, e.g. the one for getParted().
+	 */
+	void prefetch();
+
+	/**
+	 * Takes over the results of the commands run per device from a
+	 * previous SystemInfo, e.g. parted, except for the devices in
+	 * affected. All other results, e.g. blkid or the LVM reports, are
+	 * read again. Used for the incremental reprobe.
+	 */
+	void reuse(const SystemInfo& old, const set<string>& affected);
+
 	const EtcFstab& getEtcFstab() { return etc_fstab.get(); }
 	const EtcCrypttab& getEtcCrypttab() { return etc_crypttab.get(); }
 	const EtcMdadm& getEtcMdadm() { return etc_mdadm.get(); }
@@ -108,10 +125,13 @@ namespace storage
 	const CmdBtrfsSubvolumeGetDefault& getCmdBtrfsSubvolumeGetDefault(const string& device, const string& mountpoint)
 	    { return cmdbtrfssubvolumegetdefaults.get(CmdBtrfsSubvolumeGetDefault::key_t(device), mountpoint); }
 
-	const CmdPvs& getCmdPvs() { return cmdpvs.get(); }
-	const CmdVgs& getCmdVgs() { return cmdvgs.get(); }
-	const CmdLvs& getCmdLvs() { return cmdlvs.get(); }
-	const CmdUdevadmInfo& getCmdUdevadmInfo(const string& file) { return cmdudevadminfos.get(file); }
+	const CmdPvs& getCmdPvs() { use_cmd_lvm_fullreport(); return cmdpvs.get(); }
+	const CmdVgs& getCmdVgs() { use_cmd_lvm_fullreport(); return cmdvgs.get(); }
+	const CmdLvs& getCmdLvs() { use_cmd_lvm_fullreport(); return cmdlvs.get(); }
+	const CmdUdevadmInfo& getCmdUdevadmInfo(const string& file);
+
+	// Returns nullptr if the udev database is not available.
+	const CmdUdevadmExportDb* getCmdUdevadmExportDb();
 	const CmdDf& getCmdDf(const string& mountpoint) { return cmddfs.get(mountpoint); }
 
 	// The device is only used for the cache-key.
@@ -120,6 +140,20 @@ namespace storage
 
     private:
 
+	/**
+	 * Runs lvm fullreport once and takes the results for getCmdPvs(),
+	 * getCmdVgs() and getCmdLvs() from it. If lvm fullreport is not
+	 * supported or fails, e.g. with old LVM versions or old mockup
+	 * files, pvs, vgs and lvs are run individually.
+	 */
+	void use_cmd_lvm_fullreport();
+
+	bool cmd_lvm_fullreport_tried = false;
+
+	// Set once reading the udev database failed so that the failure is
+	// only logged once and not for every device.
+	bool cmd_udevadm_export_db_failed = false;
+
 	/* LazyObject, LazyObjects and LazyObjectsWithKey cache the object and
 	   a potential exception during object construction. HelperBase does
 	   the common part. */
@@ -150,6 +184,11 @@ namespace storage
 		return *object;
 	    }
 
+	    void set(const std::shared_ptr<Object>& object)
+	    {
+		this->object = object;
+	    }
+
 	private:
 
 	    std::shared_ptr<Object> object;
@@ -171,6 +210,27 @@ namespace storage
 
 	    typedef HelperBase<Object, Arg> Helper;
 
+	    bool includes(const Arg& arg) const
+	    {
+		return data.find(arg) != data.end();
+	    }
+
+	    template <typename Predicate>
+	    void reuse(const LazyObjects& old, Predicate predicate)
+	    {
+		for (const typename map<Arg, Helper>::value_type& value : old.data)
+		    if (predicate(value.first))
+			data.insert(value);
+	    }
+
+	    /**
+	     * Sets an object created elsewhere, e.g. during prefetch.
+	     */
+	    void set(const Arg& arg, const std::shared_ptr<Object>& object)
+	    {
+		data[arg].set(object);
+	    }
+
 	    const Object& get(const Arg& arg)
 	    {
 		typename map<Arg, Helper>::iterator pos = data.lower_bound(arg);
@@ -201,6 +261,14 @@ namespace storage
 		return pos != data.end() && !typename map<Key, Helper>::key_compare()(key, pos->first);
 	    }
 
+	    template <typename Predicate>
+	    void reuse(const LazyObjectsWithKey& old, Predicate predicate)
+	    {
+		for (const typename map<Key, Helper>::value_type& value : old.data)
+		    if (predicate(value.first))
+			data.insert(value);
+	    }
+
 	    const Object& get(const Key& key, Args... args)
 	    {
 		typename map<Key, Helper>::iterator pos = data.lower_bound(key);
@@ -246,7 +314,8 @@ namespace storage
 	LazyObject<CmdVgs> cmdvgs;
 	LazyObject<CmdLvs> cmdlvs;
 
-	LazyObjects<CmdUdevadmInfo> cmdudevadminfos;
+	LazyObject<CmdUdevadmExportDb> cmdudevadmexportdb;
+	LazyObjectsWithKey<CmdUdevadmInfo, const CmdUdevadmExportDb*> cmdudevadminfos;
 	LazyObjects<CmdDf> cmddfs;
 
 	LazyObjectsWithKey<CmdLsattr, string, string> cmdlsattr;
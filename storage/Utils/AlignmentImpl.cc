@@ -89,6 +89,13 @@ namespace storage
 
     bool
     Alignment::Impl::align_region_in_place(Region& region, AlignPolicy align_policy) const
+    {
+	return align_region_in_place(region.get_impl(), align_policy);
+    }
+
+
+    bool
+    Alignment::Impl::align_region_in_place(Region::Impl& region, AlignPolicy align_policy) const
     {
 	unsigned long block_size = region.get_block_size();
 
@@ -120,7 +127,9 @@ namespace storage
 	    } break;
 	}
 
-	region = Region(start, length, region.get_block_size());
+	region.set_start(start);
+	region.set_length(length);
+
 	return true;
     }
 
@@ -128,7 +137,7 @@ namespace storage
     bool
     Alignment::Impl::can_be_aligned(const Region& region, AlignPolicy align_policy) const
     {
-	Region tmp(region);
+	Region::Impl tmp(region.get_impl());
 	return align_region_in_place(tmp, align_policy);
     }
 
@@ -136,11 +145,11 @@ namespace storage
     Region
     Alignment::Impl::align(const Region& region, AlignPolicy align_policy) const
     {
-	Region tmp(region);
+	Region::Impl tmp(region.get_impl());
 	if (!align_region_in_place(tmp, align_policy))
 	    ST_THROW(AlignError());
 
-	return tmp;
+	return Region(tmp);
     }
 
 
@@ -25,6 +25,7 @@
 
 
 #include "storage/Utils/Alignment.h"
+#include "storage/Utils/RegionImpl.h"
 
 
 namespace storage
@@ -63,6 +64,11 @@ namespace storage
 
 	bool align_region_in_place(Region& region, AlignPolicy align_policy) const;
 
+	/**
+	 * Same as above but does not allocate.
+	 */
+	bool align_region_in_place(Region::Impl& region, AlignPolicy align_policy) const;
+
 	friend std::ostream& operator<<(std::ostream& s, const Impl& impl);
 
     private:
@@ -223,6 +223,41 @@ string extractNthWord(int Num_iv, const string& Line_Cv, bool GetRest_bi)
   return Ret_Ci;
   }
 
+    boost::string_ref
+    extract_nth_word(int num, boost::string_ref line, bool get_rest)
+    {
+	boost::string_ref::size_type pos = line.find_first_not_of(app_ws);
+	if (pos == boost::string_ref::npos)
+	    return boost::string_ref();
+
+	line.remove_prefix(pos);
+
+	for (int i = 0; i < num; ++i)
+	{
+	    pos = line.find_first_of(app_ws);
+	    if (pos == boost::string_ref::npos)
+		return boost::string_ref();
+
+	    line.remove_prefix(pos);
+
+	    pos = line.find_first_not_of(app_ws);
+	    if (pos == boost::string_ref::npos)
+		return boost::string_ref();
+
+	    line.remove_prefix(pos);
+	}
+
+	if (!get_rest)
+	{
+	    pos = line.find_first_of(app_ws);
+	    if (pos != boost::string_ref::npos)
+		line = line.substr(0, pos);
+	}
+
+	return line;
+    }
+
+
 list<string> splitString( const string& s, const string& delChars,
 		          bool multipleDelim, bool skipEmpty,
 			  const string& quotes )
@@ -33,6 +33,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <boost/utility/string_ref.hpp>
 
 
 namespace storage
@@ -73,6 +74,12 @@ bool setStatMode(const string& Path_Cv, mode_t val );
 
 string extractNthWord(int Num_iv, const string& Line_Cv, bool GetRest_bi = false);
 
+    /**
+     * Like extractNthWord() but returns a view into line instead of a
+     * copy. Returns an empty view if line has fewer words.
+     */
+    boost::string_ref extract_nth_word(int num, boost::string_ref line, bool get_rest = false);
+
 std::list<string> splitString( const string& s, const string& delChars=" \t\n",
                           bool multipleDelim=true, bool skipEmpty=true,
 			  const string& quotes="" );
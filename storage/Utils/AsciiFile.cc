@@ -22,6 +22,8 @@
 
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <fstream>
 
 #include "storage/Utils/LoggerImpl.h"
@@ -35,8 +37,106 @@ namespace storage
     using namespace std;
 
 
+    bool
+    LineBuffer::read(const string& name)
+    {
+	clear();
+
+	int fd = open(name.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	    return false;
+
+	// Files in /proc and /sys report a size of zero so the size is only
+	// used as hint.
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	    buffer.reserve(st.st_size + 1);
+
+	bool ok = true;
+
+	char tmp[4096];
+	while (true)
+	{
+	    ssize_t n = ::read(fd, tmp, sizeof(tmp));
+	    if (n < 0 && errno == EINTR)
+		continue;
+
+	    if (n <= 0)
+	    {
+		ok = n == 0;
+		break;
+	    }
+
+	    buffer.append(tmp, n);
+	}
+
+	close(fd);
+
+	if (!ok)
+	{
+	    clear();
+	    return false;
+	}
+
+	if (!buffer.empty() && buffer.back() != '\n')
+	    buffer.push_back('\n');
+
+	for (size_t pos = 0; pos < buffer.size(); pos = buffer.find('\n', pos) + 1)
+	    offsets.push_back(pos);
+
+	return true;
+    }
+
+
+    void
+    LineBuffer::assign(const vector<string>& lines)
+    {
+	clear();
+
+	offsets.reserve(lines.size());
+
+	for (const string& line : lines)
+	{
+	    offsets.push_back(buffer.size());
+	    buffer.append(line);
+	    buffer.push_back('\n');
+	}
+    }
+
+
+    void
+    LineBuffer::clear()
+    {
+	buffer.clear();
+	offsets.clear();
+    }
+
+
+    boost::string_ref
+    LineBuffer::operator[](size_t i) const
+    {
+	size_t end = i + 1 < offsets.size() ? offsets[i + 1] : buffer.size();
+	return boost::string_ref(buffer.data() + offsets[i], end - offsets[i] - 1);
+    }
+
+
+    vector<string>
+    LineBuffer::to_lines() const
+    {
+	vector<string> ret;
+	ret.reserve(size());
+
+	for (size_t i = 0; i < size(); ++i)
+	    ret.push_back(operator[](i).to_string());
+
+	return ret;
+    }
+
+
     AsciiFile::AsciiFile(const string& name, bool remove_empty)
-	: name(name), remove_empty(remove_empty)
+	: name(name), remove_empty(remove_empty), buffer(), lines(), lines_valid(false),
+	  dirty(false)
     {
 	reload();
     }
@@ -45,10 +145,13 @@ namespace storage
     bool
     AsciiFile::reload()
     {
+	lines_valid = false;
+	dirty = false;
+
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	{
 	    const Mockup::File& mockup_file = Mockup::get_file(name);
-	    lines = mockup_file.content;
+	    buffer.assign(mockup_file.content);
 	    return true;
 	}
 
@@ -57,31 +160,19 @@ namespace storage
 	if (get_remote_callbacks())
 	{
 	    const RemoteFile remote_file = get_remote_callbacks()->get_file(name);
-	    lines = remote_file.content;
+	    buffer.assign(remote_file.content);
 	    ret = true;
 	}
 	else
 	{
 	    y2mil("loading file " << name);
-	    clear();
 
-	    ifstream file(name);
-	    classic(file);
-	    string line;
-
-	    ret = file.good();
-	    file.unsetf(ifstream::skipws);
-	    getline(file, line);
-	    while (file.good())
-	    {
-		lines.push_back(line);
-		getline(file, line);
-	    }
+	    ret = buffer.read(name);
 	}
 
 	if (Mockup::get_mode() == Mockup::Mode::RECORD)
 	{
-	    Mockup::set_file(name, lines);
+	    Mockup::set_file(name, buffer.to_lines());
 	}
 
 	return ret;
@@ -91,15 +182,17 @@ namespace storage
     bool
     AsciiFile::save()
     {
+	const AsciiFile& tmp = *this;
+
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	{
-	    Mockup::set_file(name, lines);
+	    Mockup::set_file(name, tmp.get_lines());
 	    return true;
 	}
 
 	if (Mockup::get_mode() == Mockup::Mode::RECORD)
 	{
-	    Mockup::set_file(name, lines);
+	    Mockup::set_file(name, tmp.get_lines());
 	}
 
 	if (remove_empty && empty())
@@ -115,8 +208,8 @@ namespace storage
 	    ofstream file(name);
 	    classic(file);
 
-	    for (const string& line : lines)
-	    	file << line << std::endl;
+	    // unmodified content is written in one piece
+	    file << get_line_buffer().get_content();
 
 	    file.close();
 
@@ -125,13 +218,61 @@ namespace storage
     }
 
 
+    void
+    AsciiFile::clear()
+    {
+	buffer.clear();
+	lines.clear();
+	lines_valid = true;
+	dirty = false;
+    }
+
+
+    vector<string>&
+    AsciiFile::get_lines()
+    {
+	static_cast<const AsciiFile*>(this)->get_lines();
+
+	dirty = true;
+
+	return lines;
+    }
+
+
+    const vector<string>&
+    AsciiFile::get_lines() const
+    {
+	if (!lines_valid)
+	{
+	    lines = buffer.to_lines();
+	    lines_valid = true;
+	}
+
+	return lines;
+    }
+
+
+    const LineBuffer&
+    AsciiFile::get_line_buffer() const
+    {
+	if (dirty)
+	{
+	    buffer.assign(lines);
+	    dirty = false;
+	}
+
+	return buffer;
+    }
+
+
     void
     AsciiFile::log_content() const
     {
 	y2mil("content of " << name);
 
-	for (const string& line : lines)
-	    y2mil(line);
+	const LineBuffer& tmp = get_line_buffer();
+	for (size_t i = 0; i < tmp.size(); ++i)
+	    y2mil(tmp[i]);
     }
 
 }
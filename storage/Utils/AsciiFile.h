@@ -27,6 +27,7 @@
 
 #include <string>
 #include <vector>
+#include <boost/utility/string_ref.hpp>
 
 
 namespace storage
@@ -35,6 +36,50 @@ namespace storage
     using std::vector;
 
 
+    /**
+     * Lines of a file kept in one buffer. The file is read with a single
+     * read, the lines are available as views into the buffer. Unlike
+     * getline a last line without newline is not dropped.
+     */
+    class LineBuffer
+    {
+    public:
+
+	LineBuffer() : buffer(), offsets() {}
+
+	/**
+	 * Reads the file. Returns false if the file cannot be read.
+	 */
+	bool read(const string& name);
+
+	void assign(const vector<string>& lines);
+
+	void clear();
+
+	bool empty() const { return offsets.empty(); }
+	size_t size() const { return offsets.size(); }
+
+	/**
+	 * Line i without the newline. The view is valid until the buffer
+	 * is modified.
+	 */
+	boost::string_ref operator[](size_t i) const;
+
+	vector<string> to_lines() const;
+
+	/**
+	 * The complete content, every line terminated by a newline.
+	 */
+	const string& get_content() const { return buffer; }
+
+    private:
+
+	string buffer;
+	vector<size_t> offsets;
+
+    };
+
+
     class AsciiFile
     {
     public:
@@ -48,19 +93,40 @@ namespace storage
 
 	void log_content() const;
 
-	bool empty() const { return lines.empty(); }
+	bool empty() const { return dirty ? lines.empty() : buffer.empty(); }
+
+	void clear();
 
-	void clear() { lines.clear(); }
+	/**
+	 * The lines as vector. Only created on the first call. Using the
+	 * non-const version marks the file as modified, so it must be called
+	 * again before every modification.
+	 */
+	vector<string>& get_lines();
+	const vector<string>& get_lines() const;
 
-	vector<string>& get_lines() { return lines; }
-	const vector<string>& get_lines() const { return lines; }
+	/**
+	 * The lines without copying them. After a modification the buffer is
+	 * rebuilt once, so views into it stay valid until the next
+	 * modification.
+	 */
+	const LineBuffer& get_line_buffer() const;
 
     protected:
 
 	const string name;
 	const bool remove_empty;
 
-	vector<string> lines;
+	mutable LineBuffer buffer;
+
+	mutable vector<string> lines;
+	mutable bool lines_valid;
+
+	/**
+	 * Whether lines may have been modified since buffer was last
+	 * updated. In that case lines and not buffer holds the content.
+	 */
+	mutable bool dirty;
 
     };
 
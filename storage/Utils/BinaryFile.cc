@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#include <string.h>
+#include <fstream>
+#include <sstream>
+
+#include "storage/Utils/BinaryFile.h"
+#include "storage/Utils/ExceptionImpl.h"
+
+
+namespace storage
+{
+
+    namespace
+    {
+
+	const char magic[8] = { 'S', 'T', 'D', 'G', 'B', 'I', 'N', '\n' };
+
+	const uint32_t version = 2;
+
+    }
+
+
+    void
+    BinaryWriter::put_u8(uint8_t value)
+    {
+	body.push_back(value);
+    }
+
+
+    void
+    BinaryWriter::put_bool(bool value)
+    {
+	put_u8(value ? 1 : 0);
+    }
+
+
+    void
+    BinaryWriter::put_u32(uint32_t value)
+    {
+	for (int i = 0; i < 4; ++i)
+	    body.push_back(value >> (8 * i));
+    }
+
+
+    void
+    BinaryWriter::put_u64(uint64_t value)
+    {
+	for (int i = 0; i < 8; ++i)
+	    body.push_back(value >> (8 * i));
+    }
+
+
+    void
+    BinaryWriter::put_i64(int64_t value)
+    {
+	put_u64(value);
+    }
+
+
+    uint32_t
+    BinaryWriter::intern(const string& value)
+    {
+	map<string, uint32_t>::const_iterator it = string_index.find(value);
+	if (it != string_index.end())
+	    return it->second;
+
+	it = string_index.emplace(value, strings.size()).first;
+	strings.push_back(&it->first);
+
+	return it->second;
+    }
+
+
+    void
+    BinaryWriter::put_string(const string& value)
+    {
+	put_u32(intern(value));
+    }
+
+
+    void
+    BinaryWriter::put_strings(const vector<string>& values)
+    {
+	put_u32(values.size());
+
+	for (const string& value : values)
+	    put_string(value);
+    }
+
+
+    void
+    BinaryWriter::put_region(const Region& region)
+    {
+	put_u64(region.get_start());
+	put_u64(region.get_length());
+	put_u32(region.get_block_size());
+    }
+
+
+    void
+    BinaryWriter::put_topology(const Topology& topology)
+    {
+	put_i64(topology.get_alignment_offset());
+	put_u64(topology.get_optimal_io_size());
+	put_u64(topology.get_minimal_grain());
+    }
+
+
+    void
+    BinaryWriter::save(const string& filename) const
+    {
+	string header(magic, sizeof(magic));
+
+	BinaryWriter tmp;
+	tmp.put_u32(version);
+	tmp.put_u32(strings.size());
+	for (const string* value : strings)
+	{
+	    tmp.put_u32(value->size());
+	    tmp.body.append(*value);
+	}
+
+	std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+
+	file.write(header.data(), header.size());
+	file.write(tmp.body.data(), tmp.body.size());
+	file.write(body.data(), body.size());
+
+	file.close();
+
+	if (!file)
+	    ST_THROW(Exception("failed to save binary file " + filename));
+    }
+
+
+    BinaryReader::BinaryReader(const string& filename)
+	: filename(filename), data(), pos(0)
+    {
+	std::ifstream file(filename, std::ifstream::binary);
+
+	std::ostringstream tmp;
+	tmp << file.rdbuf();
+
+	if (!file)
+	    ST_THROW(Exception("failed to load binary file " + filename));
+
+	data = tmp.str();
+
+	if (data.size() < sizeof(magic) || memcmp(data.data(), magic, sizeof(magic)) != 0)
+	    ST_THROW(Exception("not a binary devicegraph file " + filename));
+
+	pos = sizeof(magic);
+
+	if (get_u32() != version)
+	    error("unsupported version");
+
+	// Every string needs at least its size, so a larger number of
+	// strings cannot be valid.
+
+	uint32_t n = get_u32();
+	if (n > (data.size() - pos) / 4)
+	    error("invalid number of strings");
+
+	strings.reserve(n);
+
+	for (uint32_t i = 0; i < n; ++i)
+	{
+	    uint32_t size = get_u32();
+	    need(size);
+	    strings.emplace_back(data, pos, size);
+	    pos += size;
+	}
+    }
+
+
+    void
+    BinaryReader::error(const string& what) const
+    {
+	ST_THROW(Exception(what + " in binary file " + filename));
+    }
+
+
+    void
+    BinaryReader::need(size_t n) const
+    {
+	if (data.size() - pos < n)
+	    ST_THROW(Exception("truncated binary file " + filename));
+    }
+
+
+    uint8_t
+    BinaryReader::get_u8()
+    {
+	need(1);
+	return data[pos++];
+    }
+
+
+    bool
+    BinaryReader::get_bool()
+    {
+	switch (get_u8())
+	{
+	    case 0:
+		return false;
+
+	    case 1:
+		return true;
+	}
+
+	error("invalid boolean");
+	return false;
+    }
+
+
+    uint32_t
+    BinaryReader::get_u32()
+    {
+	need(4);
+
+	uint32_t value = 0;
+	for (int i = 0; i < 4; ++i)
+	    value |= (uint32_t)(uint8_t) data[pos++] << (8 * i);
+
+	return value;
+    }
+
+
+    uint64_t
+    BinaryReader::get_u64()
+    {
+	need(8);
+
+	uint64_t value = 0;
+	for (int i = 0; i < 8; ++i)
+	    value |= (uint64_t)(uint8_t) data[pos++] << (8 * i);
+
+	return value;
+    }
+
+
+    int64_t
+    BinaryReader::get_i64()
+    {
+	return get_u64();
+    }
+
+
+    const string&
+    BinaryReader::get_string()
+    {
+	uint32_t index = get_u32();
+	if (index >= strings.size())
+	    error("invalid string index");
+
+	return strings[index];
+    }
+
+
+    vector<string>
+    BinaryReader::get_strings()
+    {
+	uint32_t n = get_u32();
+	if (n > (data.size() - pos) / 4)
+	    error("invalid number of strings");
+
+	vector<string> values;
+	values.reserve(n);
+
+	for (uint32_t i = 0; i < n; ++i)
+	    values.push_back(get_string());
+
+	return values;
+    }
+
+
+    Region
+    BinaryReader::get_region()
+    {
+	unsigned long long start = get_u64();
+	unsigned long long length = get_u64();
+	unsigned int block_size = get_u32();
+
+	return Region(start, length, block_size);
+    }
+
+
+    Topology
+    BinaryReader::get_topology()
+    {
+	long alignment_offset = get_i64();
+	unsigned long optimal_io_size = get_u64();
+	unsigned long minimal_grain = get_u64();
+
+	Topology topology(alignment_offset, optimal_io_size);
+	topology.set_minimal_grain(minimal_grain);
+
+	return topology;
+    }
+
+
+    bool
+    is_binary_file(const string& filename)
+    {
+	std::ifstream file(filename, std::ifstream::binary);
+
+	char buffer[sizeof(magic)];
+	if (!file.read(buffer, sizeof(buffer)))
+	    return false;
+
+	return memcmp(buffer, magic, sizeof(magic)) == 0;
+    }
+
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#ifndef STORAGE_BINARY_FILE_H
+#define STORAGE_BINARY_FILE_H
+
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/noncopyable.hpp>
+
+#include "storage/Utils/Region.h"
+#include "storage/Utils/Topology.h"
+
+
+namespace storage
+{
+
+    using std::string;
+    using std::vector;
+    using std::map;
+
+
+    /**
+     * Compact binary representation of devicegraphs.
+     *
+     * The file consists of a header with magic and version, a string table
+     * and a body. The body holds one record per device and holder. The
+     * records are written directly by the classes, see
+     * Device::Impl::save(BinaryWriter&), and contain the fields in a fixed
+     * order without names. Numbers are stored as fixed-width
+     * little-endian values and strings as index into the string table.
+     */
+    class BinaryWriter : private boost::noncopyable
+    {
+
+    public:
+
+	void put_bool(bool value);
+	void put_u32(uint32_t value);
+	void put_u64(uint64_t value);
+	void put_i64(int64_t value);
+
+	void put_string(const string& value);
+	void put_strings(const vector<string>& values);
+
+	void put_region(const Region& region);
+	void put_topology(const Topology& topology);
+
+	/**
+	 * Writes the header, the string table and the body.
+	 *
+	 * @throw Exception
+	 */
+	void save(const string& filename) const;
+
+    private:
+
+	void put_u8(uint8_t value);
+
+	uint32_t intern(const string& value);
+
+	map<string, uint32_t> string_index;
+	vector<const string*> strings;
+
+	string body;
+
+    };
+
+
+    /**
+     * Reads the values in the order written by BinaryWriter. All get
+     * functions throw an Exception if the file is truncated or contains
+     * invalid values.
+     */
+    class BinaryReader : private boost::noncopyable
+    {
+
+    public:
+
+	/**
+	 * Reads the file and checks header and string table.
+	 *
+	 * @throw Exception
+	 */
+	BinaryReader(const string& filename);
+
+	bool get_bool();
+	uint32_t get_u32();
+	uint64_t get_u64();
+	int64_t get_i64();
+
+	const string& get_string();
+	vector<string> get_strings();
+
+	Region get_region();
+	Topology get_topology();
+
+	/**
+	 * Whether the complete body has been read.
+	 */
+	bool at_end() const { return pos == data.size(); }
+
+	/**
+	 * Throws an Exception mentioning the file.
+	 */
+	void error(const string& what) const;
+
+    private:
+
+	uint8_t get_u8();
+
+	void need(size_t n) const;
+
+	const string filename;
+
+	string data;
+	size_t pos;
+
+	vector<string> strings;
+
+    };
+
+
+    /**
+     * Checks whether the file starts with the magic of the binary format.
+     */
+    bool is_binary_file(const string& filename);
+
+}
+
+
+#endif
@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <endian.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <linux/btrfs_tree.h>
+#include <map>
+#include <functional>
+#include <boost/noncopyable.hpp>
+
+#include "storage/Utils/BtrfsUtils.h"
+#include "storage/Utils/AppUtil.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/Remote.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    bool
+    btrfs_use_ioctls()
+    {
+	return Mockup::get_mode() == Mockup::Mode::NONE && !get_remote_callbacks() &&
+	    !SystemCmd::get_testmode();
+    }
+
+
+    namespace
+    {
+
+	class Fd : private boost::noncopyable
+	{
+	public:
+
+	    Fd(const string& path)
+		: fd(open(path.c_str(), O_RDONLY | O_CLOEXEC))
+	    {
+		if (fd < 0)
+		    ST_THROW(Exception(Exception::strErrno(errno, "open of " + path + " failed")));
+	    }
+
+	    ~Fd() { close(fd); }
+
+	    int get() const { return fd; }
+
+	private:
+
+	    const int fd;
+
+	};
+
+
+	void
+	fill_vol_args(struct btrfs_ioctl_vol_args& args, const string& name)
+	{
+	    if (name.empty() || name.size() > BTRFS_PATH_NAME_MAX)
+		ST_THROW(Exception("invalid subvolume name " + name));
+
+	    memset(&args, 0, sizeof(args));
+	    strncpy(args.name, name.c_str(), BTRFS_PATH_NAME_MAX);
+	}
+
+    }
+
+
+    void
+    btrfs_create_subvolume(const string& path)
+    {
+	y2mil("create subvolume " << path);
+
+	Fd fd(dirname(path));
+
+	struct btrfs_ioctl_vol_args args;
+	fill_vol_args(args, basename(path));
+
+	if (ioctl(fd.get(), BTRFS_IOC_SUBVOL_CREATE, &args) < 0)
+	    ST_THROW(Exception(Exception::strErrno(errno, "create subvolume " + path + " failed")));
+    }
+
+
+    void
+    btrfs_delete_subvolume(const string& path)
+    {
+	y2mil("delete subvolume " << path);
+
+	Fd fd(dirname(path));
+
+	struct btrfs_ioctl_vol_args args;
+	fill_vol_args(args, basename(path));
+
+	if (ioctl(fd.get(), BTRFS_IOC_SNAP_DESTROY, &args) < 0)
+	    ST_THROW(Exception(Exception::strErrno(errno, "delete subvolume " + path + " failed")));
+    }
+
+
+    long
+    btrfs_subvolume_id(const string& path)
+    {
+	Fd fd(path);
+
+	// With treeid 0 and the objectid of the root directory of a
+	// subvolume the kernel returns the id of the subvolume.
+
+	struct btrfs_ioctl_ino_lookup_args args;
+	memset(&args, 0, sizeof(args));
+	args.treeid = 0;
+	args.objectid = BTRFS_FIRST_FREE_OBJECTID;
+
+	if (ioctl(fd.get(), BTRFS_IOC_INO_LOOKUP, &args) < 0)
+	    ST_THROW(Exception(Exception::strErrno(errno, "lookup of subvolume id of " + path + " failed")));
+
+	y2mil("subvolume " << path << " has id " << args.treeid);
+
+	return args.treeid;
+    }
+
+
+    void
+    btrfs_set_default_subvolume(const string& mount_point, long id)
+    {
+	y2mil("set default subvolume " << id << " on " << mount_point);
+
+	Fd fd(mount_point);
+
+	__u64 tmp = id;
+
+	if (ioctl(fd.get(), BTRFS_IOC_DEFAULT_SUBVOL, &tmp) < 0)
+	    ST_THROW(Exception(Exception::strErrno(errno, "set default subvolume on " + mount_point +
+						   " failed")));
+    }
+
+
+    void
+    btrfs_set_nocow(const string& path, bool nocow)
+    {
+	y2mil("set nocow " << nocow << " on " << path);
+
+	Fd fd(path);
+
+	// The kernel uses an int for the flags although the ioctl is
+	// defined with a long.
+
+	int flags;
+
+	if (ioctl(fd.get(), FS_IOC_GETFLAGS, &flags) < 0)
+	    ST_THROW(Exception(Exception::strErrno(errno, "get flags of " + path + " failed")));
+
+	int new_flags = nocow ? flags | FS_NOCOW_FL : flags & ~FS_NOCOW_FL;
+
+	if (new_flags != flags && ioctl(fd.get(), FS_IOC_SETFLAGS, &new_flags) < 0)
+	    ST_THROW(Exception(Exception::strErrno(errno, "set flags of " + path + " failed")));
+    }
+
+
+
+    namespace
+    {
+
+	/**
+	 * Runs the ioctls on a file descriptor of a mounted btrfs.
+	 */
+	class FdSearch : public BtrfsSearch
+	{
+	public:
+
+	    FdSearch(const string& mount_point) : fd(mount_point) {}
+
+	    void tree_search(struct btrfs_ioctl_search_args& args) const override
+	    {
+		if (ioctl(fd.get(), BTRFS_IOC_TREE_SEARCH, &args) < 0)
+		    ST_THROW(Exception(Exception::strErrno(errno, "tree search failed")));
+	    }
+
+	    void ino_lookup(struct btrfs_ioctl_ino_lookup_args& args) const override
+	    {
+		if (ioctl(fd.get(), BTRFS_IOC_INO_LOOKUP, &args) < 0)
+		    ST_THROW(Exception(Exception::strErrno(errno, "lookup of directory failed")));
+	    }
+
+	private:
+
+	    const Fd fd;
+
+	};
+
+
+	/**
+	 * Calls the tree search ioctl for all items of the type in the root
+	 * tree with objectid between min_objectid and max_objectid. The
+	 * function gets the search header and the item data.
+	 */
+	void
+	search_root_tree(const BtrfsSearch& search, __u64 min_objectid, __u64 max_objectid, __u32 type,
+			 std::function<void(const struct btrfs_ioctl_search_header&, const char*)> func)
+	{
+	    struct btrfs_ioctl_search_args args;
+	    memset(&args, 0, sizeof(args));
+
+	    struct btrfs_ioctl_search_key& key = args.key;
+	    key.tree_id = BTRFS_ROOT_TREE_OBJECTID;
+	    key.min_objectid = min_objectid;
+	    key.max_objectid = max_objectid;
+	    key.min_type = type;
+	    key.max_type = type;
+	    key.min_offset = 0;
+	    key.max_offset = (__u64)(-1);
+	    key.min_transid = 0;
+	    key.max_transid = (__u64)(-1);
+
+	    while (true)
+	    {
+		key.nr_items = 4096;
+
+		search.tree_search(args);
+
+		if (key.nr_items == 0)
+		    break;
+
+		struct btrfs_ioctl_search_header header;
+
+		size_t pos = 0;
+
+		for (__u32 i = 0; i < key.nr_items; ++i)
+		{
+		    if (pos + sizeof(header) > sizeof(args.buf))
+			ST_THROW(Exception("invalid tree search result"));
+
+		    memcpy(&header, args.buf + pos, sizeof(header));
+		    pos += sizeof(header);
+
+		    if (pos + header.len > sizeof(args.buf))
+			ST_THROW(Exception("invalid tree search result"));
+
+		    // The key range also contains items of other types for
+		    // objectids between the minimum and maximum.
+
+		    if (header.type == type)
+			func(header, args.buf + pos);
+
+		    pos += header.len;
+		}
+
+		// Continue after the last item found.
+
+		key.min_objectid = header.objectid;
+		key.min_type = header.type;
+		key.min_offset = header.offset;
+
+		if (key.min_offset < (__u64)(-1))
+		{
+		    ++key.min_offset;
+		}
+		else if (key.min_objectid < max_objectid)
+		{
+		    ++key.min_objectid;
+		    key.min_type = type;
+		    key.min_offset = 0;
+		}
+		else
+		{
+		    break;
+		}
+	    }
+	}
+
+
+	/**
+	 * Returns the path of directory dirid in the subvolume treeid
+	 * relative to the subvolume, with a trailing slash unless empty.
+	 */
+	string
+	lookup_directory(const BtrfsSearch& search, __u64 treeid, __u64 dirid)
+	{
+	    struct btrfs_ioctl_ino_lookup_args args;
+	    memset(&args, 0, sizeof(args));
+	    args.treeid = treeid;
+	    args.objectid = dirid;
+
+	    search.ino_lookup(args);
+
+	    return string(args.name, strnlen(args.name, sizeof(args.name)));
+	}
+
+    }
+
+
+    vector<BtrfsSubvolumeEntry>
+    btrfs_list_subvolumes(const string& mount_point)
+    {
+	return btrfs_list_subvolumes(FdSearch(mount_point));
+    }
+
+
+    vector<BtrfsSubvolumeEntry>
+    btrfs_list_subvolumes(const BtrfsSearch& search)
+    {
+	// Every subvolume except the top-level subvolume has a root backref
+	// in the root tree. The key of the root backref holds the id of the
+	// subvolume and the id of the parent subvolume, the item holds the
+	// directory in the parent and the name.
+
+	struct Backref
+	{
+	    long parent_id;
+	    __u64 dirid;
+	    string name;
+	};
+
+	vector<long> ids;
+	std::map<long, Backref> backrefs;
+
+	search_root_tree(search, BTRFS_FIRST_FREE_OBJECTID, BTRFS_LAST_FREE_OBJECTID,
+			 BTRFS_ROOT_BACKREF_KEY,
+			 [&ids, &backrefs](const struct btrfs_ioctl_search_header& header, const char* data) {
+	    if (backrefs.find(header.objectid) != backrefs.end())
+		return;
+
+	    struct btrfs_root_ref root_ref;
+	    if (header.len < sizeof(root_ref))
+		ST_THROW(Exception("invalid root backref"));
+	    memcpy(&root_ref, data, sizeof(root_ref));
+
+	    if (header.len < sizeof(root_ref) + le16toh(root_ref.name_len))
+		ST_THROW(Exception("invalid root backref"));
+
+	    Backref& backref = backrefs[header.objectid];
+	    backref.parent_id = header.offset;
+	    backref.dirid = le64toh(root_ref.dirid);
+	    backref.name = string(data + sizeof(root_ref), le16toh(root_ref.name_len));
+
+	    ids.push_back(header.objectid);
+	});
+
+	std::map<long, string> paths;
+	paths[BTRFS_FS_TREE_OBJECTID] = "";
+
+	std::function<const string&(long)> path = [&](long id) -> const string& {
+	    std::map<long, string>::const_iterator it = paths.find(id);
+	    if (it != paths.end())
+		return it->second;
+
+	    std::map<long, Backref>::const_iterator it2 = backrefs.find(id);
+	    if (it2 == backrefs.end())
+		ST_THROW(Exception("subvolume " + to_string(id) + " not found"));
+
+	    const Backref& backref = it2->second;
+
+	    string parent_path = path(backref.parent_id);
+	    if (!parent_path.empty())
+		parent_path += "/";
+
+	    return paths[id] = parent_path + lookup_directory(search, backref.parent_id, backref.dirid) +
+		backref.name;
+	};
+
+	vector<BtrfsSubvolumeEntry> ret;
+
+	for (long id : ids)
+	    ret.emplace_back(id, backrefs[id].parent_id, path(id));
+
+	return ret;
+    }
+
+
+    long
+    btrfs_default_subvolume_id(const string& mount_point)
+    {
+	return btrfs_default_subvolume_id(FdSearch(mount_point));
+    }
+
+
+    long
+    btrfs_default_subvolume_id(const BtrfsSearch& search)
+    {
+	// The default subvolume is the location of the dir item "default"
+	// in the root tree directory.
+
+	long id = BTRFS_FS_TREE_OBJECTID;
+
+	search_root_tree(search, BTRFS_ROOT_TREE_DIR_OBJECTID, BTRFS_ROOT_TREE_DIR_OBJECTID,
+			 BTRFS_DIR_ITEM_KEY,
+			 [&id](const struct btrfs_ioctl_search_header& header, const char* data) {
+	    struct btrfs_dir_item dir_item;
+	    if (header.len < sizeof(dir_item))
+		ST_THROW(Exception("invalid dir item"));
+	    memcpy(&dir_item, data, sizeof(dir_item));
+
+	    if (header.len < sizeof(dir_item) + le16toh(dir_item.name_len))
+		ST_THROW(Exception("invalid dir item"));
+
+	    string name(data + sizeof(dir_item), le16toh(dir_item.name_len));
+	    if (name == "default")
+		id = le64toh(dir_item.location.objectid);
+	});
+
+	return id;
+    }
+
+}
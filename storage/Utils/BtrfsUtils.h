@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_BTRFS_UTILS_H
+#define STORAGE_BTRFS_UTILS_H
+
+
+#include <string>
+#include <vector>
+#include <linux/btrfs.h>
+
+
+namespace storage
+{
+
+    using std::string;
+    using std::vector;
+
+
+    /**
+     * Functions operating on btrfs subvolumes with ioctls instead of
+     * running the btrfs command. This avoids a fork for every subvolume
+     * when many subvolumes are handled. All paths are absolute paths in
+     * a mounted btrfs. All functions throw an Exception on errors.
+     */
+
+
+    /**
+     * Returns whether the ioctls may be used. For mockup, remote
+     * callbacks and testmode the commands must be used instead since
+     * nothing is really done on the system then.
+     */
+    bool btrfs_use_ioctls();
+
+
+    /**
+     * Creates the subvolume path. The parent directory must exist.
+     */
+    void btrfs_create_subvolume(const string& path);
+
+    /**
+     * Deletes the subvolume path. The subvolume must not contain other
+     * subvolumes.
+     */
+    void btrfs_delete_subvolume(const string& path);
+
+    /**
+     * Returns the id of the subvolume path.
+     */
+    long btrfs_subvolume_id(const string& path);
+
+    /**
+     * Sets the subvolume with the id as default subvolume of the btrfs
+     * mounted at mount_point.
+     */
+    void btrfs_set_default_subvolume(const string& mount_point, long id);
+
+    /**
+     * Sets or clears the 'no copy on write' attribute of path, like
+     * 'chattr +C' or 'chattr -C'.
+     */
+    void btrfs_set_nocow(const string& path, bool nocow);
+
+
+    struct BtrfsSubvolumeEntry
+    {
+	BtrfsSubvolumeEntry(long id, long parent_id, const string& path)
+	    : id(id), parent_id(parent_id), path(path) {}
+
+	long id;
+	long parent_id;
+	string path;
+    };
+
+    /**
+     * The ioctls used to read the subvolumes. The functions throw an
+     * Exception on errors. Apart from the real ioctls on a mounted btrfs
+     * the testsuite uses captured results.
+     */
+    class BtrfsSearch
+    {
+    public:
+
+	virtual ~BtrfsSearch() {}
+
+	virtual void tree_search(struct btrfs_ioctl_search_args& args) const = 0;
+	virtual void ino_lookup(struct btrfs_ioctl_ino_lookup_args& args) const = 0;
+
+    };
+
+    /**
+     * Lists all subvolumes of the btrfs mounted at mount_point like
+     * 'btrfs subvolume list -a -p' but by reading the root tree with the
+     * tree search ioctl. The paths are relative to the top-level
+     * subvolume. Requires CAP_SYS_ADMIN.
+     */
+    vector<BtrfsSubvolumeEntry> btrfs_list_subvolumes(const string& mount_point);
+
+    vector<BtrfsSubvolumeEntry> btrfs_list_subvolumes(const BtrfsSearch& search);
+
+    /**
+     * Returns the id of the default subvolume of the btrfs mounted at
+     * mount_point like 'btrfs subvolume get-default'. Requires
+     * CAP_SYS_ADMIN.
+     */
+    long btrfs_default_subvolume_id(const string& mount_point);
+
+    long btrfs_default_subvolume_id(const BtrfsSearch& search);
+
+}
+
+
+#endif
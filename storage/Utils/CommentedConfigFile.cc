@@ -129,7 +129,7 @@ bool CommentedConfigFile::read( const string & filename )
     // reading is done via AsciiFile to the mockup playback and recording
 
     AsciiFile ascii_file(filename);
-    bool success = parse(ascii_file.get_lines());
+    bool success = parse(ascii_file.get_line_buffer());
 
     return success;
 }
@@ -165,6 +165,15 @@ bool CommentedConfigFile::write( const string & new_filename )
 
 
 bool CommentedConfigFile::parse( const string_vec & lines )
+{
+    LineBuffer tmp;
+    tmp.assign( lines );
+
+    return parse( tmp );
+}
+
+
+bool CommentedConfigFile::parse( const LineBuffer & lines )
 {
     clear_all();
 
@@ -176,7 +185,7 @@ bool CommentedConfigFile::parse( const string_vec & lines )
     if ( header_end > -1 )
     {
         for ( int i=0; i <= header_end; ++i )
-            header_comments.push_back( lines[i] );
+            header_comments.push_back( lines[i].to_string() );
 
         content_start = header_end + 1;
     }
@@ -184,7 +193,7 @@ bool CommentedConfigFile::parse( const string_vec & lines )
     if ( footer_start > -1 )
     {
         for ( size_t i = footer_start; i < lines.size(); ++i )
-            footer_comments.push_back( lines[i] );
+            footer_comments.push_back( lines[i].to_string() );
 
         content_end = footer_start - 1;
     }
@@ -198,7 +207,7 @@ bool CommentedConfigFile::parse( const string_vec & lines )
 }
 
 
-bool CommentedConfigFile::parse_entries( const string_vec & lines,
+bool CommentedConfigFile::parse_entries( const LineBuffer & lines,
                                          int from,
                                          int end )
 {
@@ -207,10 +216,10 @@ bool CommentedConfigFile::parse_entries( const string_vec & lines,
 
     for ( int i = from; i <= end; ++i )
     {
-        const string & line = lines[i];
+        const boost::string_ref line = lines[i];
 
         if ( is_empty_line( line ) || is_comment_line( line ) )
-            comment_before.push_back( line );
+            comment_before.push_back( line.to_string() );
         else // found a content line
         {
             CommentedConfigFile::Entry * entry = create_entry();
@@ -220,7 +229,7 @@ bool CommentedConfigFile::parse_entries( const string_vec & lines,
             comment_before.clear();
             string content;
             string line_comment;
-            split_off_comment( line, content, line_comment );
+            split_off_comment( line.to_string(), content, line_comment );
             entry->set_line_comment( line_comment );
             bool ok = entry->parse( content, i+1 );
 
@@ -238,14 +247,14 @@ bool CommentedConfigFile::parse_entries( const string_vec & lines,
 }
 
 
-int CommentedConfigFile::find_header_comment_end( const string_vec & lines )
+int CommentedConfigFile::find_header_comment_end( const LineBuffer & lines )
 {
     int header_end      = -1;
     int last_empty_line = -1;
 
     for ( int i=0; i < (int) lines.size(); ++i )
     {
-        const string & line = lines[i];
+        const boost::string_ref line = lines[i];
 
         if ( is_empty_line( line ) )
             last_empty_line = i;
@@ -274,14 +283,14 @@ int CommentedConfigFile::find_header_comment_end( const string_vec & lines )
 }
 
 
-int CommentedConfigFile::find_footer_comment_start( const string_vec & lines,
+int CommentedConfigFile::find_footer_comment_start( const LineBuffer & lines,
                                                     int from )
 {
     int footer_start = -1;
 
     for ( int i = lines.size()-1; i >= from; --i )
     {
-        const string & line = lines[i];
+        const boost::string_ref line = lines[i];
 
         if ( is_empty_line( line ) || is_comment_line( line ) )
             footer_start = i;
@@ -336,26 +345,23 @@ void CommentedConfigFile::clear_all()
 }
 
 
-bool CommentedConfigFile::is_comment_line( const string & line )
+bool CommentedConfigFile::is_comment_line( boost::string_ref line )
 {
     size_t pos = line.find_first_not_of( WHITESPACE );
 
-    if ( pos == string::npos ) // No non-whitespace character in line
+    if ( pos == boost::string_ref::npos ) // No non-whitespace character in line
         return false;
 
-    if ( pos == 0 )
-        return boost::starts_with( line, comment_marker );
-    else
-        return boost::starts_with( line.substr( pos ), comment_marker );
+    return line.substr( pos ).starts_with( comment_marker );
 }
 
 
-bool CommentedConfigFile::is_empty_line( const string & line )
+bool CommentedConfigFile::is_empty_line( boost::string_ref line )
 {
     if ( line.empty() )
         return true;
 
-    return line.find_first_not_of( WHITESPACE ) == string::npos;
+    return line.find_first_not_of( WHITESPACE ) == boost::string_ref::npos;
 }
 
 
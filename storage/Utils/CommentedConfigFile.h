@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 #include <boost/noncopyable.hpp>
+#include <boost/utility/string_ref.hpp>
 
 
 namespace storage
@@ -36,6 +37,8 @@ using std::vector;
 
 typedef vector<string> string_vec;
 
+class LineBuffer;
+
 
 /**
  * Utility class to read and write config files that might contain comments.
@@ -255,6 +258,7 @@ public:
      * Parse 'lines' and replace the current content with it.
      **/
     bool parse( const string_vec & lines );
+    bool parse( const LineBuffer & lines );
 
     /**
      * Format the entire file as string lines, including header, footer and all
@@ -462,13 +466,13 @@ protected:
      * Return 'true' if this is a comment line (not an empty line!), i.e. the
      * first nonblank character is the comment marker ("#" by default).
      **/
-    bool is_comment_line( const string & line );
+    bool is_comment_line( boost::string_ref line );
 
     /**
      * Return 'true' if this is an empty line, i.e. there are no nonblank
      * characters.
      **/
-    bool is_empty_line( const string & line );
+    bool is_empty_line( boost::string_ref line );
 
     /**
      * Split 'line' into a content and a comment part that are returned in
@@ -489,19 +493,19 @@ protected:
      * Return the line number of the end of the header comment or -1 if there
      * is none.
      **/
-    int find_header_comment_end( const string_vec & lines );
+    int find_header_comment_end( const LineBuffer & lines );
 
     /**
      * Return the line number of the start of the footer comment (starting with
      * line number 'from' or -1 if there is none.
      **/
-    int find_footer_comment_start( const string_vec & lines, int from );
+    int find_footer_comment_start( const LineBuffer & lines, int from );
 
     /**
      * Parse entries from line no. 'from' to line no. 'end' in 'lines'.
      * Return 'true' if success, 'false' if error.
      **/
-    bool parse_entries( const string_vec & lines, int from, int end );
+    bool parse_entries( const LineBuffer & lines, int from, int end );
 
 
 private:
@@ -23,6 +23,9 @@
 
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <chrono>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/FileUtils.h"
@@ -31,6 +34,7 @@
 #include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/StorageTmpl.h"
 
 
 namespace storage
@@ -81,6 +85,103 @@ namespace storage
     }
 
 
+    namespace
+    {
+
+	vector<string>
+	missing_files(const vector<string>& files)
+	{
+	    vector<string> ret;
+
+	    for (const string& file : files)
+	    {
+		if (access(file.c_str(), R_OK) != 0)
+		    ret.push_back(file);
+	    }
+
+	    return ret;
+	}
+
+
+	/**
+	 * Watches the nearest existing directory of file for newly created
+	 * entries. Since a missing directory, e.g. /dev/mapper, can be
+	 * created later on this must be repeated after every event. Adding
+	 * an existing watch again is cheap.
+	 */
+	void
+	add_watch(int fd, const string& file)
+	{
+	    string dir = dirname(file);
+
+	    while (inotify_add_watch(fd, dir.c_str(), IN_CREATE | IN_MOVED_TO) < 0 && dir != "/" &&
+		   dir != ".")
+		dir = dirname(dir);
+	}
+
+    }
+
+
+    bool
+    wait_for_files(const vector<string>& files, unsigned int timeout)
+    {
+	vector<string> missing = missing_files(files);
+	if (missing.empty())
+	    return true;
+
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+	    std::chrono::milliseconds(timeout);
+
+	int fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+	if (fd < 0)
+	    y2war(Exception::strErrno(errno, "inotify_init1 failed"));
+
+	while (true)
+	{
+	    if (fd >= 0)
+	    {
+		for (const string& file : missing)
+		    add_watch(fd, file);
+	    }
+
+	    // Check again after adding the watches so that files created
+	    // meanwhile are not missed.
+
+	    missing = missing_files(missing);
+	    if (missing.empty())
+		break;
+
+	    int remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+		deadline - std::chrono::steady_clock::now()).count();
+	    if (remaining <= 0)
+		break;
+
+	    if (fd < 0)
+	    {
+		// without inotify fall back to polling
+		usleep(10000);
+		continue;
+	    }
+
+	    struct pollfd pfd = { fd, POLLIN, 0 };
+	    if (poll(&pfd, 1, remaining) > 0)
+	    {
+		// only the occurrence of events matters
+		char buffer[4096];
+		while (read(fd, buffer, sizeof(buffer)) > 0)
+		    ;
+	    }
+	}
+
+	if (fd >= 0)
+	    close(fd);
+
+	y2mil("files:" << files << " missing:" << missing);
+
+	return missing.empty();
+    }
+
+
     TmpMount::TmpMount(const string& path, const string& name_template, const string& device,
 		       bool read_only, const vector<string>& options)
 	: TmpDir(path, name_template)
@@ -76,6 +76,14 @@ namespace storage
     };
 
 
+    /**
+     * Waits until all files exist but at most timeout milliseconds. The
+     * files are watched with inotify so the function returns as soon as
+     * the last file appears. Returns whether all files exist.
+     */
+    bool wait_for_files(const vector<string>& files, unsigned int timeout);
+
+
     class TmpMount : public TmpDir
     {
 
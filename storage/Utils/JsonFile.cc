@@ -20,10 +20,12 @@
  */
 
 
+#include <string.h>
 #include <iostream>
 #include <functional>
 #include <memory>
 #include <sstream>
+#include <limits>
 
 #include "storage/Utils/JsonFile.h"
 #include "storage/Utils/ExceptionImpl.h"
@@ -136,4 +138,588 @@ namespace storage
 	return true;
     }
 
+
+    void
+    JsonRecord::clear()
+    {
+	buffer.clear();
+	fields.clear();
+    }
+
+
+    void
+    JsonRecord::add(boost::string_ref key, boost::string_ref value)
+    {
+	Field field;
+
+	field.key_pos = buffer.size();
+	field.key_len = key.size();
+	buffer.append(key.data(), key.size());
+
+	field.value_pos = buffer.size();
+	field.value_len = value.size();
+	buffer.append(value.data(), value.size());
+
+	fields.push_back(field);
+    }
+
+
+    bool
+    JsonRecord::find(const char* name, boost::string_ref& value) const
+    {
+	boost::string_ref tmp(name);
+
+	for (const Field& field : fields)
+	{
+	    if (tmp == boost::string_ref(buffer.data() + field.key_pos, field.key_len))
+	    {
+		value = boost::string_ref(buffer.data() + field.value_pos, field.value_len);
+		return true;
+	    }
+	}
+
+	return false;
+    }
+
+
+    template<>
+    bool
+    get_child_value(const JsonRecord& record, const char* name, string& value)
+    {
+	boost::string_ref tmp;
+	if (!record.find(name, tmp))
+	    return false;
+
+	value.assign(tmp.data(), tmp.size());
+	return true;
+    }
+
+
+    namespace
+    {
+
+	template<typename Type>
+	bool
+	get_unsigned_child_value(const JsonRecord& record, const char* name, Type& value)
+	{
+	    boost::string_ref tmp;
+	    if (!record.find(name, tmp))
+		return false;
+
+	    // Like reading with an istream non-numbers give 0 and reading
+	    // stops at the first non-digit. A value that does not fit is an
+	    // error.
+
+	    value = 0;
+
+	    for (char c : tmp)
+	    {
+		if (c < '0' || c > '9')
+		    break;
+
+		Type digit = c - '0';
+
+		if (value > (std::numeric_limits<Type>::max() - digit) / 10)
+		    ST_THROW(ParseException(sformat("value of %s out of range", name), tmp.to_string(),
+					    "unsigned number"));
+
+		value = 10 * value + digit;
+	    }
+
+	    return true;
+	}
+
+    }
+
+
+    template<>
+    bool
+    get_child_value(const JsonRecord& record, const char* name, unsigned long& value)
+    {
+	return get_unsigned_child_value(record, name, value);
+    }
+
+
+    template<>
+    bool
+    get_child_value(const JsonRecord& record, const char* name, unsigned long long& value)
+    {
+	return get_unsigned_child_value(record, name, value);
+    }
+
+
+    JsonReader::JsonReader(boost::string_ref text)
+	: pos(text.data()), end(text.data() + text.size()), value(), after_key(false),
+	  after_value(false)
+    {
+    }
+
+
+    void
+    JsonReader::skip_whitespace()
+    {
+	while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+	    ++pos;
+    }
+
+
+    JsonReader::Token
+    JsonReader::next()
+    {
+	skip_whitespace();
+
+	if (after_key)
+	{
+	    if (pos == end || *pos != ':')
+		ST_THROW(Exception("json parser failed, ':' expected"));
+
+	    ++pos;
+	    after_key = false;
+
+	    skip_whitespace();
+	    return read_value();
+	}
+
+	if (after_value)
+	{
+	    if (stack.empty())
+	    {
+		if (pos != end)
+		    ST_THROW(Exception("json parser failed, trailing data"));
+
+		return Token::END;
+	    }
+
+	    if (pos == end)
+		ST_THROW(Exception("json parser failed, unexpected end"));
+
+	    switch (*pos)
+	    {
+		case ',':
+		    ++pos;
+		    after_value = false;
+		    skip_whitespace();
+
+		    // Like json-c a trailing comma is accepted.
+		    if (pos != end && *pos == (stack.back() == '{' ? '}' : ']'))
+		    {
+			++pos;
+			after_value = true;
+			char c = stack.back();
+			stack.pop_back();
+			return c == '{' ? Token::END_OBJECT : Token::END_ARRAY;
+		    }
+
+		    if (stack.back() == '{')
+		    {
+			read_string();
+			after_key = true;
+			return Token::KEY;
+		    }
+		    return read_value();
+
+		case '}':
+		    if (stack.back() != '{')
+			break;
+		    ++pos;
+		    stack.pop_back();
+		    return Token::END_OBJECT;
+
+		case ']':
+		    if (stack.back() != '[')
+			break;
+		    ++pos;
+		    stack.pop_back();
+		    return Token::END_ARRAY;
+	    }
+
+	    ST_THROW(Exception("json parser failed, ',' or end of container expected"));
+	}
+
+	// at the beginning of the text or of a container
+
+	if (stack.empty())
+	    return read_value();
+
+	if (pos != end && *pos == (stack.back() == '{' ? '}' : ']'))
+	{
+	    ++pos;
+	    after_value = true;
+	    char c = stack.back();
+	    stack.pop_back();
+	    return c == '{' ? Token::END_OBJECT : Token::END_ARRAY;
+	}
+
+	if (stack.back() == '{')
+	{
+	    read_string();
+	    after_key = true;
+	    return Token::KEY;
+	}
+
+	return read_value();
+    }
+
+
+    JsonReader::Token
+    JsonReader::read_value()
+    {
+	if (pos == end)
+	    ST_THROW(Exception("json parser failed, unexpected end"));
+
+	after_value = true;
+
+	switch (*pos)
+	{
+	    case '{':
+		++pos;
+		stack.push_back('{');
+		after_value = false;
+		return Token::BEGIN_OBJECT;
+
+	    case '[':
+		++pos;
+		stack.push_back('[');
+		after_value = false;
+		return Token::BEGIN_ARRAY;
+
+	    case '"':
+		read_string();
+		return Token::STRING;
+
+	    case 't':
+		read_literal("true");
+		return Token::TRUE;
+
+	    case 'f':
+		read_literal("false");
+		return Token::FALSE;
+
+	    case 'n':
+		read_literal("null");
+		return Token::NULL_VALUE;
+	}
+
+	const char* start = pos;
+
+	if (pos != end && *pos == '-')
+	    ++pos;
+
+	const char* digits = pos;
+	while (pos != end && ((*pos >= '0' && *pos <= '9') || *pos == '.' || *pos == 'e' ||
+			      *pos == 'E' || *pos == '+' || *pos == '-'))
+	    ++pos;
+
+	if (pos == digits || *digits < '0' || *digits > '9')
+	    ST_THROW(Exception("json parser failed, unexpected character"));
+
+	value = boost::string_ref(start, pos - start);
+
+	return Token::NUMBER;
+    }
+
+
+    void
+    JsonReader::read_literal(const char* literal)
+    {
+	size_t len = strlen(literal);
+
+	if ((size_t)(end - pos) < len || strncmp(pos, literal, len) != 0)
+	    ST_THROW(Exception("json parser failed, unexpected literal"));
+
+	pos += len;
+    }
+
+
+    namespace
+    {
+
+	void
+	append_utf8(string& s, unsigned long code_point)
+	{
+	    if (code_point < 0x80)
+	    {
+		s += (char)(code_point);
+	    }
+	    else if (code_point < 0x800)
+	    {
+		s += (char)(0xc0 | (code_point >> 6));
+		s += (char)(0x80 | (code_point & 0x3f));
+	    }
+	    else if (code_point < 0x10000)
+	    {
+		s += (char)(0xe0 | (code_point >> 12));
+		s += (char)(0x80 | ((code_point >> 6) & 0x3f));
+		s += (char)(0x80 | (code_point & 0x3f));
+	    }
+	    else
+	    {
+		s += (char)(0xf0 | (code_point >> 18));
+		s += (char)(0x80 | ((code_point >> 12) & 0x3f));
+		s += (char)(0x80 | ((code_point >> 6) & 0x3f));
+		s += (char)(0x80 | (code_point & 0x3f));
+	    }
+	}
+
+
+	unsigned long
+	read_hex4(const char*& pos, const char* end)
+	{
+	    if (end - pos < 4)
+		ST_THROW(Exception("json parser failed, bad unicode escape"));
+
+	    unsigned long ret = 0;
+
+	    for (int i = 0; i < 4; ++i, ++pos)
+	    {
+		char c = *pos;
+
+		ret <<= 4;
+
+		if (c >= '0' && c <= '9')
+		    ret |= c - '0';
+		else if (c >= 'a' && c <= 'f')
+		    ret |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+		    ret |= c - 'A' + 10;
+		else
+		    ST_THROW(Exception("json parser failed, bad unicode escape"));
+	    }
+
+	    return ret;
+	}
+
+    }
+
+
+    void
+    JsonReader::read_string()
+    {
+	if (pos == end || *pos != '"')
+	    ST_THROW(Exception("json parser failed, string expected"));
+
+	const char* start = ++pos;
+
+	// Fast path for strings without escapes.
+
+	while (pos != end && *pos != '"' && *pos != '\\')
+	{
+	    if ((unsigned char)(*pos) < 0x20)
+		ST_THROW(Exception("json parser failed, control character in string"));
+	    ++pos;
+	}
+
+	if (pos == end)
+	    ST_THROW(Exception("json parser failed, unterminated string"));
+
+	if (*pos == '"')
+	{
+	    value = boost::string_ref(start, pos - start);
+	    ++pos;
+	    return;
+	}
+
+	scratch.assign(start, pos - start);
+
+	while (true)
+	{
+	    if (pos == end)
+		ST_THROW(Exception("json parser failed, unterminated string"));
+
+	    char c = *pos++;
+
+	    if (c == '"')
+		break;
+
+	    if ((unsigned char)(c) < 0x20)
+		ST_THROW(Exception("json parser failed, control character in string"));
+
+	    if (c != '\\')
+	    {
+		scratch += c;
+		continue;
+	    }
+
+	    if (pos == end)
+		ST_THROW(Exception("json parser failed, unterminated string"));
+
+	    switch (c = *pos++)
+	    {
+		case '"': case '\\': case '/': scratch += c; break;
+		case 'b': scratch += '\b'; break;
+		case 'f': scratch += '\f'; break;
+		case 'n': scratch += '\n'; break;
+		case 'r': scratch += '\r'; break;
+		case 't': scratch += '\t'; break;
+
+		case 'u': {
+		    unsigned long code_point = read_hex4(pos, end);
+
+		    // surrogate pair
+		    if (code_point >= 0xd800 && code_point < 0xdc00 && end - pos >= 2 &&
+			pos[0] == '\\' && pos[1] == 'u')
+		    {
+			pos += 2;
+			unsigned long low = read_hex4(pos, end);
+			if (low < 0xdc00 || low >= 0xe000)
+			    ST_THROW(Exception("json parser failed, bad surrogate pair"));
+			code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+		    }
+
+		    append_utf8(scratch, code_point);
+		} break;
+
+		default:
+		    ST_THROW(Exception("json parser failed, bad escape"));
+	    }
+	}
+
+	value = boost::string_ref(scratch);
+    }
+
+
+    void
+    JsonReader::expect(Token token)
+    {
+	if (next() != token)
+	    ST_THROW(Exception("json parser failed, unexpected token"));
+    }
+
+
+    void
+    JsonReader::skip_container()
+    {
+	for (size_t depth = 1; depth > 0; )
+	{
+	    switch (next())
+	    {
+		case Token::BEGIN_OBJECT:
+		case Token::BEGIN_ARRAY:
+		    ++depth;
+		    break;
+
+		case Token::END_OBJECT:
+		case Token::END_ARRAY:
+		    --depth;
+		    break;
+
+		case Token::END:
+		    ST_THROW(Exception("json parser failed, unexpected end"));
+
+		default:
+		    break;
+	    }
+	}
+    }
+
+
+    void
+    JsonReader::skip_value()
+    {
+	switch (next())
+	{
+	    case Token::BEGIN_OBJECT:
+	    case Token::BEGIN_ARRAY:
+		skip_container();
+		break;
+
+	    case Token::STRING:
+	    case Token::NUMBER:
+	    case Token::TRUE:
+	    case Token::FALSE:
+	    case Token::NULL_VALUE:
+		break;
+
+	    default:
+		ST_THROW(Exception("json parser failed, value expected"));
+	}
+    }
+
+
+    bool
+    JsonReader::next_key()
+    {
+	switch (next())
+	{
+	    case Token::KEY:
+		return true;
+
+	    case Token::END_OBJECT:
+		return false;
+
+	    default:
+		ST_THROW(Exception("json parser failed, key expected"));
+	}
+    }
+
+
+    bool
+    JsonReader::next_object()
+    {
+	while (true)
+	{
+	    switch (next())
+	    {
+		case Token::BEGIN_OBJECT:
+		    return true;
+
+		case Token::END_ARRAY:
+		    return false;
+
+		case Token::BEGIN_ARRAY:
+		    skip_container();
+		    break;
+
+		case Token::STRING:
+		case Token::NUMBER:
+		case Token::TRUE:
+		case Token::FALSE:
+		case Token::NULL_VALUE:
+		    break;
+
+		default:
+		    ST_THROW(Exception("json parser failed, array element expected"));
+	    }
+	}
+    }
+
+
+    void
+    JsonReader::read_record(JsonRecord& record)
+    {
+	record.clear();
+
+	while (next_key())
+	{
+	    key.assign(value.data(), value.size());
+
+	    switch (next())
+	    {
+		case Token::STRING:
+		case Token::NUMBER:
+		    record.add(key, value);
+		    break;
+
+		case Token::TRUE:
+		    record.add(key, "true");
+		    break;
+
+		case Token::FALSE:
+		    record.add(key, "false");
+		    break;
+
+		case Token::NULL_VALUE:
+		    break;
+
+		case Token::BEGIN_OBJECT:
+		case Token::BEGIN_ARRAY:
+		    skip_container();
+		    break;
+
+		default:
+		    ST_THROW(Exception("json parser failed, value expected"));
+	    }
+	}
+    }
+
 }
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include <boost/noncopyable.hpp>
+#include <boost/utility/string_ref.hpp>
 
 
 namespace storage
@@ -60,6 +61,144 @@ namespace storage
     bool
     get_child_nodes(json_object* parent, const char* name, vector<json_object*>& children);
 
+
+    /**
+     * A flat JSON object with the scalar values of an object read by
+     * JsonReader::read_record(). The keys and values are kept in one
+     * buffer that is reused when the record is cleared.
+     */
+    class JsonRecord
+    {
+    public:
+
+	void clear();
+
+	void add(boost::string_ref key, boost::string_ref value);
+
+	bool find(const char* name, boost::string_ref& value) const;
+
+    private:
+
+	struct Field
+	{
+	    size_t key_pos;
+	    size_t key_len;
+	    size_t value_pos;
+	    size_t value_len;
+	};
+
+	string buffer;
+	vector<Field> fields;
+
+    };
+
+
+    /**
+     * @throw ParseException
+     */
+    template<typename Type>
+    bool get_child_value(const JsonRecord& record, const char* name, Type& value);
+
+
+    /**
+     * Streaming JSON reader returning one token at a time. Unlike JsonFile
+     * no object tree is built and strings without escapes are not copied.
+     * Like json-c trailing commas in objects and arrays are accepted.
+     */
+    class JsonReader : private boost::noncopyable
+    {
+
+    public:
+
+	enum class Token
+	{
+	    BEGIN_OBJECT, END_OBJECT, BEGIN_ARRAY, END_ARRAY, KEY, STRING, NUMBER, TRUE,
+	    FALSE, NULL_VALUE, END
+	};
+
+	/**
+	 * The text must outlive the reader.
+	 */
+	JsonReader(boost::string_ref text);
+
+	/**
+	 * Reads the next token.
+	 *
+	 * @throw Exception
+	 */
+	Token next();
+
+	/**
+	 * Reads the next token and throws if it is not the expected token.
+	 *
+	 * @throw Exception
+	 */
+	void expect(Token token);
+
+	/**
+	 * Value of the last KEY, STRING or NUMBER token. Only valid until
+	 * next() is called again.
+	 */
+	boost::string_ref get_value() const { return value; }
+
+	/**
+	 * Reads the next key of the current object. Returns false at the end
+	 * of the object.
+	 *
+	 * @throw Exception
+	 */
+	bool next_key();
+
+	/**
+	 * Reads up to the next object in the current array, other elements
+	 * are skipped. Returns false at the end of the array.
+	 *
+	 * @throw Exception
+	 */
+	bool next_object();
+
+	/**
+	 * Skips the next value, e.g. the value of a key.
+	 *
+	 * @throw Exception
+	 */
+	void skip_value();
+
+	/**
+	 * Reads the rest of the current object into record. Nested objects
+	 * and arrays as well as null values are skipped.
+	 *
+	 * @throw Exception
+	 */
+	void read_record(JsonRecord& record);
+
+    private:
+
+	void skip_whitespace();
+	void skip_container();
+
+	Token read_value();
+	void read_string();
+	void read_literal(const char* literal);
+
+	const char* pos;
+	const char* const end;
+
+	boost::string_ref value;
+
+	// Buffers for strings with escapes and for the key in
+	// read_record().
+	string scratch;
+	string key;
+
+	// Open containers, either '{' or '['.
+	vector<char> stack;
+
+	bool after_key;
+	bool after_value;
+
+    };
+
 }
 
 
@@ -32,9 +32,54 @@ namespace storage
     static const string& component = "libstorage";
 
 
+    LogQueue::LogQueue()
+    {
+	for (int i = 0; i < 4; ++i)
+	    enabled[i] = query_log_level((LogLevel)(i));
+    }
+
+
+    void
+    LogQueue::flush()
+    {
+	vector<Entry> tmp;
+
+	{
+	    std::lock_guard<std::mutex> lock(mutex);
+	    tmp.swap(entries);
+	}
+
+	Logger* logger = get_logger();
+	if (!logger)
+	    return;
+
+	for (const Entry& entry : tmp)
+	    logger->write(entry.log_level, component, entry.file, entry.line, entry.func, entry.content);
+    }
+
+
+    LogQueue::Redirect::Redirect(LogQueue& log_queue)
+	: previous(current)
+    {
+	current = &log_queue;
+    }
+
+
+    LogQueue::Redirect::~Redirect()
+    {
+	current = previous;
+    }
+
+
+    thread_local LogQueue* LogQueue::current = nullptr;
+
+
     bool
     query_log_level(LogLevel log_level)
     {
+	if (LogQueue::current)
+	    return LogQueue::current->enabled[(int)(log_level)];
+
 	Logger* logger = get_logger();
 	if (logger)
 	{
@@ -67,8 +112,10 @@ namespace storage
     close_log_stream(LogLevel log_level, const char* file, unsigned line, const char* func,
 		     ostringstream* stream)
     {
-	Logger* logger = get_logger();
-	if (logger)
+	LogQueue* log_queue = LogQueue::current;
+
+	Logger* logger = log_queue ? nullptr : get_logger();
+	if (log_queue || logger)
 	{
 	    string content = stream->str();
 	    string::size_type pos1 = 0;
@@ -76,8 +123,19 @@ namespace storage
 	    {
 		string::size_type pos2 = content.find('\n', pos1);
 		if (pos2 != string::npos || pos1 != content.length())
-		    logger->write(log_level, component, file, line, func,
-				  content.substr(pos1, pos2 - pos1));
+		{
+		    if (log_queue)
+		    {
+			std::lock_guard<std::mutex> lock(log_queue->mutex);
+			log_queue->entries.push_back({ log_level, file, line, func,
+				content.substr(pos1, pos2 - pos1) });
+		    }
+		    else
+		    {
+			logger->write(log_level, component, file, line, func,
+				      content.substr(pos1, pos2 - pos1));
+		    }
+		}
 		if (pos2 == string::npos)
 		    break;
 		pos1 = pos2 + 1;
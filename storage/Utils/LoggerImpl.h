@@ -26,6 +26,8 @@
 
 
 #include <sstream>
+#include <vector>
+#include <mutex>
 
 #include "storage/Utils/Logger.h"
 
@@ -33,6 +35,68 @@
 namespace storage
 {
 
+    /**
+     * Queue for log lines of threads that must not call the logger, e.g.
+     * since the logger is implemented in Ruby or Python. The log lines
+     * of a thread are queued while a LogQueue::Redirect object exists in
+     * the thread. The thread that created the LogQueue passes them to
+     * the logger with flush().
+     */
+    class LogQueue
+    {
+    public:
+
+	/**
+	 * Queries the log levels enabled by the logger. Must be called
+	 * from the thread allowed to call the logger.
+	 */
+	LogQueue();
+
+	/**
+	 * Passes all queued log lines to the logger. Must be called from
+	 * the thread allowed to call the logger.
+	 */
+	void flush();
+
+	class Redirect
+	{
+	public:
+
+	    Redirect(LogQueue& log_queue);
+	    ~Redirect();
+
+	private:
+
+	    LogQueue* previous;
+
+	};
+
+    private:
+
+	friend bool query_log_level(LogLevel log_level);
+
+	friend void close_log_stream(LogLevel log_level, const char* file, unsigned line,
+				     const char* func, std::ostringstream*);
+
+	struct Entry
+	{
+	    LogLevel log_level;
+	    const char* file;
+	    unsigned line;
+	    const char* func;
+	    std::string content;
+	};
+
+	bool enabled[4];
+
+	std::mutex mutex;
+	std::vector<Entry> entries;
+
+	static thread_local LogQueue* current;
+
+    };
+
+
     bool query_log_level(LogLevel log_level);
 
     std::ostringstream* open_log_stream();
@@ -69,6 +69,12 @@ namespace storage
     }
 
 
+    Region::Region(const Impl& impl)
+	: impl(new Impl(impl))
+    {
+    }
+
+
     Region::~Region()
     {
     }
@@ -188,6 +188,11 @@ namespace storage
 
 	class Impl;
 
+	/**
+	 * Only for internal use. Ignored in the bindings.
+	 */
+	explicit Region(const Impl& impl);
+
 	Impl& get_impl();
 	const Impl& get_impl() const;
 
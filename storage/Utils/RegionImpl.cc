@@ -28,13 +28,6 @@
 namespace storage
 {
 
-    Region::Impl::Impl(unsigned long long start, unsigned long long length, unsigned int block_size)
-	: start(start), length(length), block_size(block_size)
-    {
-	assert_valid_block_size();
-    }
-
-
     std::ostream&
     operator<<(std::ostream& s, const Region::Impl& impl)
     {
@@ -169,26 +162,33 @@ namespace storage
 	unsigned long long end = get_end();
 	unsigned long long block_size = get_block_size();
 
-	vector<Region> used_regions_sorted = used_regions;
+	// Sort the impls instead of the regions since copying or swapping
+	// regions allocates.
+
+	vector<Impl> used_regions_sorted;
+	used_regions_sorted.reserve(used_regions.size());
+	for (const Region& used_region : used_regions)
+	    used_regions_sorted.push_back(used_region.get_impl());
 	sort(used_regions_sorted.begin(), used_regions_sorted.end());
 
 	vector<Region> ret;
+	ret.reserve(used_regions.size() + 1);
 
-	for (const Region& used_region : used_regions_sorted)
+	for (const Impl& used_region : used_regions_sorted)
 	{
-	    if (!used_region.get_impl().inside(*this))
+	    if (!used_region.inside(*this))
 		ST_THROW(NotInside());
 
-	    assert_equal_block_size(used_region.get_impl());
+	    assert_equal_block_size(used_region);
 
 	    if (used_region.get_start() > start)
-		ret.emplace_back(start, used_region.get_start() - start, block_size);
+		ret.emplace_back(Impl(start, used_region.get_start() - start, block_size));
 
 	    start = used_region.get_end() + 1;
 	}
 
 	if (end > start)
-	    ret.emplace_back(start, end - start + 1, block_size);
+	    ret.emplace_back(Impl(start, end - start + 1, block_size));
 
 	return ret;
     }
@@ -34,12 +34,19 @@
 namespace storage
 {
 
+    /**
+     * Region::Impl is a plain value with inline storage. Library code doing
+     * bulk computations with regions, e.g. alignment or partition slots,
+     * should use it directly and only create Regions for the result since
+     * every Region allocates its Impl.
+     */
     class Region::Impl
     {
     public:
 
 	Impl() : start(0), length(0), block_size(0) {}
-	Impl(unsigned long long start, unsigned long long length, unsigned int block_size);
+	Impl(unsigned long long start, unsigned long long length, unsigned int block_size)
+	    : start(start), length(length), block_size(block_size) { assert_valid_block_size(); }
 
 	bool empty() const { return length == 0; }
 
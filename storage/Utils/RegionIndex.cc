@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#include <algorithm>
+
+#include "storage/Utils/RegionIndex.h"
+
+
+namespace storage
+{
+
+    RegionIndex::RegionIndex(const Region& region, const vector<Region>& used_regions)
+	: region(region.get_impl()), overlapping(false)
+    {
+	for (const Region& unused_region : region.unused_regions(used_regions))
+	    add_unused(unused_region.get_start(), unused_region.get_end());
+
+	for (const Region& used_region : used_regions)
+	    used.emplace(used_region.get_start(), used_region.get_end());
+
+	unsigned long long max_end = 0;
+	for (std::multiset<range_t>::const_iterator it = used.begin(); it != used.end(); ++it)
+	{
+	    if (it != used.begin() && it->first <= max_end)
+		overlapping = true;
+
+	    max_end = std::max(max_end, it->second);
+	}
+    }
+
+
+    void
+    RegionIndex::add_unused(unsigned long long start, unsigned long long end)
+    {
+	if (start > end)
+	    return;
+
+	// Like Region::unused_regions() a single block at the end of the
+	// region is not reported as unused.
+
+	if (start == end && end == region.get_end())
+	    return;
+
+	unused[start] = end;
+	unused_by_length.emplace(end - start + 1, start);
+    }
+
+
+    void
+    RegionIndex::remove_unused(unsigned long long start)
+    {
+	std::map<unsigned long long, unsigned long long>::iterator it = unused.find(start);
+	if (it == unused.end())
+	    return;
+
+	unused_by_length.erase(range_t(it->second - it->first + 1, it->first));
+	unused.erase(it);
+    }
+
+
+    bool
+    RegionIndex::add_used(const Region& used_region)
+    {
+	if (overlapping || used_region.get_block_size() != region.get_block_size() ||
+	    used_region.get_length() == 0)
+	    return false;
+
+	unsigned long long start = used_region.get_start();
+	unsigned long long end = used_region.get_end();
+
+	std::map<unsigned long long, unsigned long long>::const_iterator it = unused.upper_bound(start);
+	if (it == unused.begin())
+	    return false;
+
+	--it;
+
+	if (it->first > start || it->second < end)
+	    return false;
+
+	const range_t gap = *it;
+
+	remove_unused(gap.first);
+
+	if (start > gap.first)
+	    add_unused(gap.first, start - 1);
+
+	if (end < gap.second)
+	    add_unused(end + 1, gap.second);
+
+	used.emplace(start, end);
+
+	return true;
+    }
+
+
+    bool
+    RegionIndex::remove_used(const Region& used_region)
+    {
+	if (overlapping)
+	    return false;
+
+	std::multiset<range_t>::iterator it = used.find(range_t(used_region.get_start(),
+								used_region.get_end()));
+	if (it == used.end())
+	    return false;
+
+	unsigned long long start = region.get_start();
+	if (it != used.begin())
+	    start = std::prev(it)->second + 1;
+
+	unsigned long long end = region.get_end();
+	if (std::next(it) != used.end())
+	    end = std::next(it)->first - 1;
+
+	remove_unused(start);
+	remove_unused(it->second + 1);
+
+	used.erase(it);
+
+	add_unused(start, end);
+
+	return true;
+    }
+
+
+    vector<Region>
+    RegionIndex::get_unused() const
+    {
+	vector<Region> ret;
+	ret.reserve(unused.size());
+
+	for_each_unused([&ret](const Region::Impl& unused_region) {
+	    ret.emplace_back(unused_region);
+	    return true;
+	});
+
+	return ret;
+    }
+
+
+    size_t
+    RegionIndex::num_used_before(unsigned long long start) const
+    {
+	return std::distance(used.begin(), used.lower_bound(range_t(start, 0)));
+    }
+
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#ifndef STORAGE_REGION_INDEX_H
+#define STORAGE_REGION_INDEX_H
+
+
+#include <set>
+#include <map>
+#include <vector>
+
+#include "storage/Utils/RegionImpl.h"
+
+
+namespace storage
+{
+
+    using std::vector;
+
+
+    /**
+     * Sorted index of used regions inside a region together with the
+     * unused regions between them. Used regions can be added and removed
+     * in O(log n) and the unused regions are available sorted by start or
+     * by length.
+     *
+     * The unused regions are the same as computed by
+     * Region::unused_regions().
+     */
+    class RegionIndex
+    {
+    public:
+
+	/**
+	 * Creates the index for region with the used regions. The used
+	 * regions must be inside region, overlapping used regions are
+	 * allowed but prevent removing used regions later on.
+	 *
+	 * @throw NotInside
+	 */
+	RegionIndex(const Region& region, const vector<Region>& used_regions);
+
+	const Region::Impl& get_region() const { return region; }
+
+	size_t num_used() const { return used.size(); }
+
+	/**
+	 * Adds a used region. Returns false and leaves the index unchanged if
+	 * the region is not completely unused.
+	 */
+	bool add_used(const Region& used_region);
+
+	/**
+	 * Removes a used region. Returns false and leaves the index
+	 * unchanged if the region is not in the index or the index has
+	 * overlapping used regions.
+	 */
+	bool remove_used(const Region& used_region);
+
+	/**
+	 * Returns the unused regions sorted by start.
+	 */
+	vector<Region> get_unused() const;
+
+	/**
+	 * Returns the number of used regions starting before start.
+	 */
+	size_t num_used_before(unsigned long long start) const;
+
+	/**
+	 * Calls func for the unused regions sorted by start until func
+	 * returns false. Does not allocate.
+	 */
+	template <typename Func>
+	void for_each_unused(Func func) const
+	{
+	    for (const std::pair<const unsigned long long, unsigned long long>& gap : unused)
+	    {
+		if (!func(Region::Impl(gap.first, gap.second - gap.first + 1, region.get_block_size())))
+		    break;
+	    }
+	}
+
+	/**
+	 * Calls func for the unused regions sorted by length, largest first,
+	 * until func returns false. Does not allocate.
+	 */
+	template <typename Func>
+	void for_each_unused_by_length(Func func) const
+	{
+	    for (const range_t& gap : unused_by_length)
+	    {
+		if (!func(Region::Impl(gap.second, gap.first, region.get_block_size())))
+		    break;
+	    }
+	}
+
+    private:
+
+	typedef std::pair<unsigned long long, unsigned long long> range_t;
+
+	// Orders pairs of length and start by descending length and ascending
+	// start.
+	struct larger_first
+	{
+	    bool operator()(const range_t& lhs, const range_t& rhs) const
+	    {
+		return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+	    }
+	};
+
+	void add_unused(unsigned long long start, unsigned long long end);
+	void remove_unused(unsigned long long start);
+
+	Region::Impl region;
+
+	bool overlapping;
+
+	// Used regions as start and end.
+	std::multiset<range_t> used;
+
+	// Unused regions, from start to end and as length and start.
+	std::map<unsigned long long, unsigned long long> unused;
+	std::set<range_t, larger_first> unused_by_length;
+
+    };
+
+}
+
+
+#endif
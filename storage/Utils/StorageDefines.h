@@ -31,6 +31,8 @@
 
 #define SYSFSDIR "/sys"
 
+#define UDEVDATADIR "/run/udev/data"
+
 #define SYSCONFIGFILE "/etc/sysconfig/storage"
 
 #define SHBIN "/bin/sh"
@@ -62,6 +64,8 @@
 #define VGSCANBIN "/sbin/vgscan"
 #define VGCHANGEBIN "/sbin/vgchange"
 
+#define LVMBIN "/sbin/lvm"
+
 #define CRYPTSETUPBIN "/sbin/cryptsetup"
 #define LOSETUPBIN "/sbin/losetup"
 #define MULTIPATHBIN "/sbin/multipath"
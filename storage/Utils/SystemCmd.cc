@@ -25,11 +25,22 @@
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <string.h>
+#include <spawn.h>
+#include <dirent.h>
 #include <ostream>
 #include <fstream>
 #include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <string>
 #include <sstream>
+#include <list>
+#include <set>
+#include <memory>
+#include <algorithm>
+#include <exception>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/ExceptionImpl.h"
@@ -39,6 +50,7 @@
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/OutputProcessor.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/ProbeStatistics.h"
 
 
 #define SYSCALL_FAILED( SYSCALL_MSG ) \
@@ -48,17 +60,262 @@
     ST_MAYBE_THROW( Exception( Exception::strErrno( errno, SYSCALL_MSG ) ), false )
 
 // See man bash
-// Since all commands are started via a shell, only the shell's return value is returned.
+// For commands started via a shell only the shell's return value is
+// returned. Commands started without a shell that cannot be executed
+// report the same values.
 #define SHELL_RET_COMMAND_NOT_EXECUTABLE	126
 #define SHELL_RET_COMMAND_NOT_FOUND		127
 #define SHELL_RET_SIGNAL			128
 
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34))
+#define HAVE_POSIX_SPAWN_ADDCLOSEFROM
+#endif
+
 
 namespace storage
 {
     using namespace std;
 
 
+    namespace
+    {
+
+	bool
+	needs_quoting(const string& arg)
+	{
+	    return arg.empty() || arg.find_first_not_of("abcdefghijklmnopqrstuvwxyz"
+							"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+							"0123456789_-+=/.,:@%") != string::npos;
+	}
+
+
+	/**
+	 * The environment for the child process, the current environment
+	 * with LC_ALL and LANGUAGE set to C.
+	 */
+	vector<string>
+	child_environment()
+	{
+	    vector<string> ret;
+
+	    for (char** p = environ; *p; ++p)
+	    {
+		if (!boost::starts_with(*p, "LC_ALL=") && !boost::starts_with(*p, "LANGUAGE="))
+		    ret.push_back(*p);
+	    }
+
+	    ret.push_back("LC_ALL=C");
+	    ret.push_back("LANGUAGE=C");
+
+	    return ret;
+	}
+
+
+	vector<char*>
+	to_pointers(vector<string>& strs)
+	{
+	    vector<char*> ret;
+
+	    for (string& str : strs)
+		ret.push_back(&str[0]);
+
+	    ret.push_back(nullptr);
+
+	    return ret;
+	}
+
+
+#ifndef HAVE_POSIX_SPAWN_ADDCLOSEFROM
+
+	/**
+	 * Searches the program in PATH like execvp() does. Returns an error
+	 * number if the program is not found.
+	 */
+	int
+	find_program(const char* name, string& path)
+	{
+	    if (strchr(name, '/'))
+	    {
+		path = name;
+		return 0;
+	    }
+
+	    const char* tmp = getenv("PATH");
+
+	    vector<string> dirs;
+	    boost::split(dirs, tmp ? tmp : "/bin:/usr/bin", boost::is_any_of(":"));
+
+	    int error = ENOENT;
+
+	    for (const string& dir : dirs)
+	    {
+		string candidate = (dir.empty() ? "." : dir) + "/" + name;
+
+		struct stat buf;
+		if (stat(candidate.c_str(), &buf) != 0 || !S_ISREG(buf.st_mode))
+		    continue;
+
+		if (access(candidate.c_str(), X_OK) == 0)
+		{
+		    path = candidate;
+		    return 0;
+		}
+
+		error = errno;
+	    }
+
+	    return error;
+	}
+
+
+	/**
+	 * Closes all file descriptors from 3 on except keep. Runs in the
+	 * child after fork, so only async-signal-safe functions are used.
+	 * Uses close_range if available, otherwise the open file
+	 * descriptors are read from /proc/self/fd. Only if that fails too
+	 * all possible file descriptors below max_fd are closed.
+	 */
+	void
+	close_fds(int keep, int max_fd)
+	{
+#ifdef SYS_close_range
+	    if ((keep <= 3 || syscall(SYS_close_range, 3, keep - 1, 0) == 0) &&
+		syscall(SYS_close_range, max(keep + 1, 3), ~0U, 0) == 0)
+		return;
+#endif
+
+	    int dir_fd = open("/proc/self/fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	    if (dir_fd >= 0)
+	    {
+		char buffer[4096];
+		long n;
+
+		while ((n = syscall(SYS_getdents64, dir_fd, buffer, sizeof(buffer))) > 0)
+		{
+		    for (long pos = 0; pos < n;)
+		    {
+			const struct dirent64* entry = reinterpret_cast<const struct dirent64*>(buffer + pos);
+			pos += entry->d_reclen;
+
+			int fd = 0;
+			const char* p = entry->d_name;
+			for (; *p >= '0' && *p <= '9'; ++p)
+			    fd = 10 * fd + (*p - '0');
+
+			if (*p == '\0' && p != entry->d_name && fd >= 3 && fd != keep && fd != dir_fd)
+			    close(fd);
+		    }
+		}
+
+		close(dir_fd);
+
+		if (n == 0)
+		    return;
+	    }
+
+	    for (int fd = 3; fd < max_fd; ++fd)
+	    {
+		if (fd != keep)
+		    close(fd);
+	    }
+	}
+
+
+	/**
+	 * Starts the program like posix_spawn() or posix_spawnp() with
+	 * stdin, stdout and stderr redirected and all other file
+	 * descriptors closed. Returns an error number if the program could
+	 * not be started.
+	 */
+	int
+	fork_exec(int& pid, bool search_path, char* const argv[], char* const envp[], int sin,
+		  int sout, int serr)
+	{
+	    // Everything needing memory allocation is done before the fork,
+	    // in particular searching the program in PATH.
+
+	    string path = argv[0];
+	    if (search_path)
+	    {
+		int error = find_program(argv[0], path);
+		if (error != 0)
+		    return error;
+	    }
+
+	    const int max_fd = getdtablesize();
+
+	    // A failed exec is reported via this pipe, a successful exec
+	    // closes it.
+
+	    int status_pipe[2];
+	    if (pipe2(status_pipe, O_CLOEXEC) < 0)
+		return errno;
+
+	    pid = fork();
+
+	    if (pid < 0)
+	    {
+		int error = errno;
+		close(status_pipe[0]);
+		close(status_pipe[1]);
+		return error;
+	    }
+
+	    if (pid == 0)
+	    {
+		// In the child only async-signal-safe functions may be used.
+
+		if (dup2(sin, STDIN_FILENO) >= 0 && dup2(sout, STDOUT_FILENO) >= 0 &&
+		    dup2(serr, STDERR_FILENO) >= 0)
+		{
+		    close_fds(status_pipe[1], max_fd);
+
+		    execve(path.c_str(), argv, envp);
+		}
+
+		int error = errno;
+		ssize_t ret = write(status_pipe[1], &error, sizeof(error));
+		(void) ret;
+		_exit(SHELL_RET_COMMAND_NOT_FOUND);
+	    }
+
+	    close(status_pipe[1]);
+
+	    int error = 0;
+	    ssize_t n;
+	    while ((n = read(status_pipe[0], &error, sizeof(error))) < 0 && errno == EINTR)
+		;
+
+	    close(status_pipe[0]);
+
+	    if (n != sizeof(error))
+		return 0;
+
+	    // The exec failed and the child exits, reap it.
+
+	    while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR)
+		;
+
+	    return error;
+	}
+
+#endif
+
+    }
+
+
+    SystemCmd::Options::Options(const vector<string>& args, ThrowBehaviour throw_behaviour)
+	: command(), args(args), throw_behaviour(throw_behaviour), stdin_text(), mockup_key()
+    {
+	for (const string& arg : args)
+	{
+	    if (!command.empty())
+		command += " ";
+	    command += needs_quoting(arg) ? quote(arg) : arg;
+	}
+    }
+
+
     SystemCmd::SystemCmd(const Options& options)
 	: options(options), _combineOutput(false), _execInBackground(false), _cmdRet(0),
 	  _cmdPid(0), _outputProc(nullptr)
@@ -89,37 +346,30 @@ namespace storage
     }
 
 
+    SystemCmd::SystemCmd(const Options& options, Background)
+	: options(options), _combineOutput(false), _execInBackground(false), _cmdRet(0),
+	  _cmdPid(0), _outputProc(nullptr)
+    {
+	init();
+	executeBackground();
+    }
+
+
     void
     SystemCmd::init()
     {
-        _childStdin = NULL;
-	_files[0] = _files[1] = NULL;
+	_pfds[0].fd = _pfds[1].fd = _pfds[2].fd = -1;
 	_pfds[0].events = POLLOUT; // stdin
 	_pfds[1].events = POLLIN;  // stdout
 	_pfds[2].events = POLLIN;  // stderr
+	invalidate();
     }
 
 
     void
     SystemCmd::cleanup()
     {
-        if ( _childStdin )
-        {
-            fclose( _childStdin );
-            _childStdin = NULL;
-        }
-
-	if ( _files[IDX_STDOUT] )
-	{
-	    fclose( _files[IDX_STDOUT] );
-	    _files[IDX_STDOUT] = NULL;
-	}
-
-	if ( _files[IDX_STDERR] )
-	{
-	    fclose( _files[IDX_STDERR] );
-	    _files[IDX_STDERR] = NULL;
-	}
+	closeFds();
     }
 
 
@@ -130,13 +380,15 @@ namespace storage
 
 
     void
-    SystemCmd::closeOpenFds() const
+    SystemCmd::closeFds()
     {
-	int max_fd = getdtablesize();
-
-	for ( int fd = 3; fd < max_fd; fd++ )
+	for (struct pollfd& pfd : _pfds)
 	{
-	    close(fd);
+	    if (pfd.fd >= 0)
+	    {
+		close(pfd.fd);
+		pfd.fd = -1;
+	    }
 	}
     }
 
@@ -146,12 +398,18 @@ namespace storage
     {
 	// TODO the command handling could need a better concept
 
+	Stopwatch stopwatch;
+
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	{
 	    const Mockup::Command& mockup_command = Mockup::get_command(mockup_key());
-	    _outputLines[IDX_STDOUT] = mockup_command.stdout;
-	    _outputLines[IDX_STDERR] = mockup_command.stderr;
+	    setOutput(IDX_STDOUT, mockup_command.stdout);
+	    setOutput(IDX_STDERR, mockup_command.stderr);
 	    _cmdRet = mockup_command.exit_code;
+
+	    if (probe_statistics)
+		probe_statistics->add_command(command(), stopwatch.read());
+
 	    return 0;
 	}
 
@@ -160,8 +418,8 @@ namespace storage
 	if (get_remote_callbacks())
 	{
 	    const RemoteCommand remote_command = get_remote_callbacks()->get_command(command());
-	    _outputLines[IDX_STDOUT] = remote_command.stdout;
-	    _outputLines[IDX_STDERR] = remote_command.stderr;
+	    setOutput(IDX_STDOUT, remote_command.stdout);
+	    setOutput(IDX_STDERR, remote_command.stderr);
 	    _cmdRet = remote_command.exit_code;
 	    ret = 0;
 	}
@@ -172,6 +430,9 @@ namespace storage
 	    ret = doExecute();
 	}
 
+	if (probe_statistics)
+	    probe_statistics->add_command(command(), stopwatch.read());
+
 	if (Mockup::get_mode() == Mockup::Mode::RECORD)
 	{
 	    Mockup::set_command(mockup_key(), Mockup::Command(stdout(), stderr(), retcode()));
@@ -209,7 +470,7 @@ namespace storage
 	    }
 	    if ( maxLineOut>0 )
 	    {
-		ls = stdout().size() + stderr().size();
+		ls = _lineOffsets[IDX_STDOUT].size() + _lineOffsets[IDX_STDERR].size();
 		y2mil( "lines out:" << ls );
 	    }
 	    timeExceeded_ret = maxTimeSec>0 && ts>maxTimeSec;
@@ -264,24 +525,23 @@ namespace storage
 
 	Stopwatch stopwatch;
 
-        _childStdin = NULL;
-	_files[IDX_STDERR] = _files[IDX_STDOUT] = NULL;
+	closeFds();
 	invalidate();
-	int sin[2];
-	int sout[2];
-	int serr[2];
+	int sin[2] = { -1, -1 };
+	int sout[2] = { -1, -1 };
+	int serr[2] = { -1, -1 };
 	bool ok = true;
-	if ( !_testmode && pipe(sin)<0 )
+	if ( !_testmode && pipe2(sin, O_CLOEXEC)<0 )
 	{
 	    SYSCALL_FAILED( "pipe stdin creation failed" );
 	    ok = false;
 	}
-	if ( !_testmode && pipe(sout)<0 )
+	if ( !_testmode && ok && pipe2(sout, O_CLOEXEC)<0 )
 	{
 	    SYSCALL_FAILED( "pipe stdout creation failed" );
 	    ok = false;
 	}
-	if ( !_testmode && !_combineOutput && pipe(serr)<0 )
+	if ( !_testmode && ok && !_combineOutput && pipe2(serr, O_CLOEXEC)<0 )
 	{
 	    SYSCALL_FAILED( "pipe stderr creation failed" );
 	    ok = false;
@@ -307,102 +567,49 @@ namespace storage
 		}
 	    }
 	    y2deb("sout:" << _pfds[1].fd << " serr:" << (_combineOutput?-1:_pfds[2].fd));
-	    switch( (_cmdPid=fork()) )
-	    {
-		case 0: // child process
-		    setenv( "LC_ALL", "C", 1 );
-		    setenv( "LANGUAGE", "C", 1 );
 
-		    if ( dup2( sin[0], STDIN_FILENO )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "dup2 stdin failed in child process" );
-		    }
-		    if ( dup2( sout[1], STDOUT_FILENO )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "dup2 stdout failed in child process" );
-		    }
-		    if ( !_combineOutput && dup2( serr[1], STDERR_FILENO )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "dup2 stderr failed in child process" );
-		    }
-		    if ( _combineOutput && dup2( STDOUT_FILENO, STDERR_FILENO )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "dup2 stderr failed in child process" );
-		    }
-		    if ( close( sin[1] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdin ) failed in child process" );
-		    }
-		    if ( close( sout[0] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdout ) failed in child process" );
-		    }
-		    if ( !_combineOutput && close( serr[0] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stderr ) failed in child process" );
-		    }
-		    closeOpenFds();
-		    _cmdRet = execl(SHBIN, SHBIN, "-c", command().c_str(), nullptr);
-
-		    // execl() should not return. If we get here, it failed.
-		    // Throwing an exception here would not make any sense, however:
-		    // We are in the forked child process, and there is nothing
-		    // to return to that could make use of an exception.
-		    y2err("execl() failed: THIS SHOULD NOT HAPPEN \"SHBIN\" Ret:" <<
-			  _cmdRet << " errno: " << errno);
-		    y2err( "Exiting child process" );
-		    exit(127); // same as "command not found" in the shell
-		    break;
-
-		case -1:
-		    _cmdRet = -1;
-		    SYSCALL_FAILED( "fork() failed" );
-		    break;
-
-		default: // parent process
-		    if ( close( sin[0] ) < 0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdin ) in parent failed" );
-		    }
-		    if ( close( sout[1] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stdout ) in parent failed" );
-		    }
-		    if ( !_combineOutput && close( serr[1] )<0 )
-		    {
-			SYSCALL_FAILED_NOTHROW( "close( stderr ) in parent failed" );
-		    }
-		    _cmdRet = 0;
+	    int error = doSpawn(sin[0], sout[1], _combineOutput ? sout[1] : serr[1]);
 
-                    _childStdin = fdopen( sin[1], "a" );
-		    if ( _childStdin == NULL )
-		    {
-			SYSCALL_FAILED_NOTHROW( "fdopen( stdin ) failed" );
-		    }
+	    // The ends of the pipes for the child are not needed in the
+	    // parent.
+	    close(sin[0]);
+	    close(sout[1]);
+	    if ( !_combineOutput )
+		close(serr[1]);
 
-		    _files[IDX_STDOUT] = fdopen( sout[0], "r" );
-		    if ( _files[IDX_STDOUT] == NULL )
-		    {
-			SYSCALL_FAILED_NOTHROW( "fdopen( stdout ) failed" );
-		    }
-		    if ( !_combineOutput )
-		    {
-			_files[IDX_STDERR] = fdopen( serr[0], "r" );
-			if ( _files[IDX_STDERR] == NULL )
-			{
-			    SYSCALL_FAILED_NOTHROW( "fdopen( stderr ) failed" );
-			}
-		    }
-		    if ( !_execInBackground )
-		    {
-			doWait( true, _cmdRet );
-			y2mil("stopwatch " << stopwatch << " for \"" << command() << "\"");
-		    }
-		    break;
+	    if ( error == 0 )
+	    {
+		_cmdRet = 0;
+		if ( !_execInBackground )
+		{
+		    doWait( true, _cmdRet );
+		    y2mil("stopwatch " << stopwatch << " for \"" << command() << "\"");
+		}
+	    }
+	    else if ( error == ENOENT || error == EACCES || error == ENOEXEC )
+	    {
+		// Report the same exit code as the shell would do.
+		y2err("spawn failed: " << strerror(error));
+		_cmdPid = 0;
+		doFinish( W_EXITCODE( error == ENOENT ? SHELL_RET_COMMAND_NOT_FOUND :
+				      SHELL_RET_COMMAND_NOT_EXECUTABLE, 0 ), _cmdRet );
+	    }
+	    else
+	    {
+		closeFds();
+		_cmdPid = 0;
+		_cmdRet = -1;
+		errno = error;
+		SYSCALL_FAILED( "posix_spawn() failed" );
 	    }
 	}
 	else if ( !_testmode )
 	{
+	    for ( int fd : { sin[0], sin[1], sout[0], sout[1], serr[0], serr[1] } )
+	    {
+		if ( fd >= 0 )
+		    close( fd );
+	    }
 	    _cmdRet = -1;
 	}
 	else
@@ -423,6 +630,56 @@ namespace storage
     }
 
 
+    int
+    SystemCmd::doSpawn(int sin, int sout, int serr)
+    {
+	// The pipes are created with O_CLOEXEC so only the duplicates on
+	// stdin, stdout and stderr survive the exec. Other file descriptors
+	// without O_CLOEXEC are closed explicitly.
+
+	vector<string> env = child_environment();
+	vector<char*> envp = to_pointers(env);
+
+	// Without a shell the program is started directly, the arguments
+	// need no quoting.
+
+	vector<string> args = options.args;
+	if (args.empty())
+	    args = { SHBIN, "-c", command() };
+
+	vector<char*> argv = to_pointers(args);
+
+#ifdef HAVE_POSIX_SPAWN_ADDCLOSEFROM
+
+	posix_spawn_file_actions_t file_actions;
+	posix_spawn_file_actions_init(&file_actions);
+	posix_spawn_file_actions_adddup2(&file_actions, sin, STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, sout, STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, serr, STDERR_FILENO);
+	posix_spawn_file_actions_addclosefrom_np(&file_actions, 3);
+
+	int error;
+
+	if (options.args.empty())
+	    error = posix_spawn(&_cmdPid, SHBIN, &file_actions, nullptr, argv.data(), envp.data());
+	else
+	    error = posix_spawnp(&_cmdPid, argv[0], &file_actions, nullptr, argv.data(), envp.data());
+
+	posix_spawn_file_actions_destroy(&file_actions);
+
+	return error;
+
+#else
+
+	// posix_spawn cannot close the other file descriptors with older
+	// glibc versions, so fork and exec are used.
+
+	return fork_exec(_cmdPid, !options.args.empty(), argv.data(), envp.data(), sin, sout, serr);
+
+#endif
+    }
+
+
     bool
     SystemCmd::doWait( bool hang, int& cmdRet_ret )
     {
@@ -433,7 +690,20 @@ namespace storage
 	{
 	    y2deb("[0] id:" <<	_pfds[1].fd << " ev:" << hex << (unsigned)_pfds[1].events << dec << " [1] fs:" <<
 		  (_combineOutput?-1:_pfds[2].fd) << " ev:" << hex << (_combineOutput?0:(unsigned)_pfds[2].events));
-	    int sel = poll( _pfds, _combineOutput?2:3, 1000 );
+
+	    // Once all pipes are closed only the termination of the command
+	    // is left to wait for.
+	    bool pipes_open = _pfds[0].fd >= 0 || _pfds[1].fd >= 0 || _pfds[2].fd >= 0;
+
+	    if ( wait_lock )
+		wait_lock->unlock();
+	    int sel = pipes_open ? poll( _pfds, _combineOutput?2:3, 1000 ) : 0;
+	    int poll_errno = errno;
+	    if ( !pipes_open )
+		waitpidRet = waitpid( _cmdPid, &cmdStatus, hang ? 0 : WNOHANG );
+	    if ( wait_lock )
+		wait_lock->lock();
+	    errno = poll_errno;
 	    if (sel < 0)
 	    {
 		SYSCALL_FAILED_NOTHROW( "poll() failed" );
@@ -446,50 +716,14 @@ namespace storage
                 if ( _pfds[1].revents || _pfds[2].revents )
                     checkOutput();
 	    }
-	    waitpidRet = waitpid( _cmdPid, &cmdStatus, WNOHANG );
+	    if ( pipes_open )
+		waitpidRet = waitpid( _cmdPid, &cmdStatus, WNOHANG );
 	    y2deb("Wait ret:" << waitpidRet);
 	}
 	while ( hang && waitpidRet == 0 );
 
 	if ( waitpidRet != 0 )
-	{
-	    checkOutput();
-            if ( _childStdin )
-            {
-                fclose( _childStdin );
-                _childStdin = NULL;
-            }
-	    fclose( _files[IDX_STDOUT] );
-	    _files[IDX_STDOUT] = NULL;
-	    if ( !_combineOutput )
-	    {
-		fclose( _files[IDX_STDERR] );
-		_files[IDX_STDERR] = NULL;
-	    }
-	    if (WIFEXITED(cmdStatus))
-	    {
-		cmdRet_ret = WEXITSTATUS(cmdStatus);
-		if ( cmdRet_ret == SHELL_RET_COMMAND_NOT_EXECUTABLE )
-		    ST_MAYBE_THROW(SystemCmdException(this, "Command not executable"), do_throw());
-		else if ( cmdRet_ret == SHELL_RET_COMMAND_NOT_FOUND )
-		    ST_MAYBE_THROW(CommandNotFoundException(this), do_throw());
-		else if ( cmdRet_ret > SHELL_RET_SIGNAL )
-		{
-		    std::stringstream msg;
-		    msg << "Caught signal #" << ( cmdRet_ret - SHELL_RET_SIGNAL );
-		    ST_MAYBE_THROW( SystemCmdException(this, msg.str()), do_throw());
-		}
-	    }
-	    else
-	    {
-		cmdRet_ret = -127;
-		ST_MAYBE_THROW(SystemCmdException(this, "Command failed"), do_throw());
-	    }
-	    if ( _outputProc )
-	    {
-		_outputProc->finish();
-	    }
-	}
+	    doFinish( cmdStatus, cmdRet_ret );
 
 	y2deb("Wait:" << waitpidRet << " pid:" << _cmdPid << " stat:" << cmdStatus <<
 	      " Hang:" << hang << " Ret:" << cmdRet_ret);
@@ -497,13 +731,46 @@ namespace storage
     }
 
 
+    void
+    SystemCmd::doFinish( int cmdStatus, int& cmdRet_ret )
+    {
+	checkOutput();
+	closeFds();
+	if (WIFEXITED(cmdStatus))
+	{
+	    cmdRet_ret = WEXITSTATUS(cmdStatus);
+	    if ( cmdRet_ret == SHELL_RET_COMMAND_NOT_EXECUTABLE )
+		ST_MAYBE_THROW(SystemCmdException(this, "Command not executable"), do_throw());
+	    else if ( cmdRet_ret == SHELL_RET_COMMAND_NOT_FOUND )
+		ST_MAYBE_THROW(CommandNotFoundException(this), do_throw());
+	    else if ( cmdRet_ret > SHELL_RET_SIGNAL )
+	    {
+		std::stringstream msg;
+		msg << "Caught signal #" << ( cmdRet_ret - SHELL_RET_SIGNAL );
+		ST_MAYBE_THROW( SystemCmdException(this, msg.str()), do_throw());
+	    }
+	}
+	else
+	{
+	    cmdRet_ret = -127;
+	    ST_MAYBE_THROW(SystemCmdException(this, "Command failed"), do_throw());
+	}
+	if ( _outputProc )
+	{
+	    _outputProc->finish();
+	}
+    }
+
+
     void
     SystemCmd::invalidate()
     {
 	for (int streamIndex = 0; streamIndex < 2; streamIndex++)
 	{
+	    _output[streamIndex].clear();
+	    _lineOffsets[streamIndex].clear();
 	    _outputLines[streamIndex].clear();
-	    _newLineSeen[streamIndex] = true;
+	    _outputLinesValid[streamIndex] = true;
 	}
     }
 
@@ -511,143 +778,195 @@ namespace storage
     void
     SystemCmd::checkOutput()
     {
-	y2deb("NewLine out:" << _newLineSeen[IDX_STDOUT] << " err:" << _newLineSeen[IDX_STDERR]);
-	if (_files[IDX_STDOUT])
-	    getUntilEOF(_files[IDX_STDOUT], _outputLines[IDX_STDOUT], _newLineSeen[IDX_STDOUT], false);
-	if (_files[IDX_STDERR])
-	    getUntilEOF(_files[IDX_STDERR], _outputLines[IDX_STDERR], _newLineSeen[IDX_STDERR], true);
-	y2deb("NewLine out:" << _newLineSeen[IDX_STDOUT] << " err:" << _newLineSeen[IDX_STDERR]);
+	if (_pfds[1].fd >= 0)
+	    readUntilEAGAIN(IDX_STDOUT);
+	if (!_combineOutput && _pfds[2].fd >= 0)
+	    readUntilEAGAIN(IDX_STDERR);
     }
 
 
     void
     SystemCmd::sendStdin()
     {
-        if ( ! _childStdin )
-            return;
+	if (_pfds[0].fd < 0)
+	    return;
 
-        if (!options.stdin_text.empty())
-        {
-            string::size_type count = 0;
-            string::size_type len   = options.stdin_text.size();
-            int result = 1;
+	while (!options.stdin_text.empty())
+	{
+	    ssize_t count = write(_pfds[0].fd, options.stdin_text.data(), options.stdin_text.size());
+	    if (count < 0)
+	    {
+		if (errno == EINTR)
+		    continue;
 
-            while ( count < len && result > 0 )
-                result = fputc( options.stdin_text[ count++ ], _childStdin );
+		if (errno == EAGAIN)
+		    return;
 
-            options.stdin_text.erase( 0, count );
-            // y2deb( count << " characters written; left over: \"" << _stdinText << "\"" );
-        }
+		SYSCALL_FAILED_NOTHROW( "write( stdin ) failed" );
+		options.stdin_text.clear();
+		break;
+	    }
 
-        if (options.stdin_text.empty())
-        {
-            fclose( _childStdin );
-            _childStdin = NULL;
-            _pfds[0].fd = -1; // ignore for poll() from now on
-        }
-    }
+	    options.stdin_text.erase(0, count);
+	}
 
+	close(_pfds[0].fd);
+	_pfds[0].fd = -1; // ignore for poll() from now on
+    }
 
-#define BUF_LEN 256
 
     void
-    SystemCmd::getUntilEOF( FILE* file, vector<string>& lines,
-			    bool& newLineSeen_ret, bool isStderr ) const
-    {
-	size_t oldSize = lines.size();
-	char buffer[BUF_LEN];
-	int count;
-	int c;
-	string text;
-
-	clearerr( file );
-	count = 0;
-	c = EOF;
-	while ( (c=fgetc(file)) != EOF )
-	{
-	    buffer[count++] = c;
-	    if ( count==sizeof(buffer)-1 )
+    SystemCmd::readUntilEAGAIN(OutputStream streamIndex)
+    {
+	int& fd = _pfds[streamIndex + 1].fd;
+	bool isStderr = streamIndex == IDX_STDERR;
+	size_t oldSize = _lineOffsets[streamIndex].size();
+
+	char buffer[4096];
+
+	while (true)
+	{
+	    ssize_t count = read(fd, buffer, sizeof(buffer));
+
+	    if (count > 0)
 	    {
-		buffer[count] = 0;
-		extractNewline( buffer, count, newLineSeen_ret, text, lines );
-		count = 0;
+		appendOutput(streamIndex, buffer, count);
 		if ( _outputProc )
 		{
-		    _outputProc->process( buffer, isStderr );
+		    _outputProc->process(string(buffer, count), isStderr);
 		}
+		continue;
 	    }
-	    c = EOF;
+
+	    if (count < 0 && errno == EINTR)
+		continue;
+
+	    if (count < 0 && errno == EAGAIN)
+		break;
+
+	    if (count < 0)
+		SYSCALL_FAILED_NOTHROW( "read() failed" );
+
+	    // EOF, the last line is complete now.
+
+	    if (!_lineOffsets[streamIndex].empty())
+		logLine(streamIndex, _lineOffsets[streamIndex].size() - 1);
+
+	    close(fd);
+	    fd = -1;
+	    break;
 	}
-	if ( count>0 )
+
+	if ( oldSize != _lineOffsets[streamIndex].size() )
 	{
-	    buffer[count] = 0;
-	    extractNewline( buffer, count, newLineSeen_ret, text, lines );
-	    if ( _outputProc )
-	    {
-		_outputProc->process( buffer, isStderr );
-	    }
+	    y2mil("pid:" << _cmdPid << " added lines:" << _lineOffsets[streamIndex].size() - oldSize <<
+		  " stderr:" << isStderr);
 	}
-	if ( text.length() > 0 )
+    }
+
+
+    void
+    SystemCmd::appendOutput(OutputStream streamIndex, const char* buffer, size_t count)
+    {
+	string& output = _output[streamIndex];
+	vector<string::size_type>& offsets = _lineOffsets[streamIndex];
+
+	string::size_type pos = output.size();
+	output.append(buffer, count);
+
+	// A line starts at the beginning of the output and after every
+	// newline that is followed by more output.
+
+	while (pos < output.size())
 	{
-	    if ( newLineSeen_ret )
+	    if (pos == 0 || output[pos - 1] == '\n')
 	    {
-		addLine( text, lines );
+		if (!offsets.empty())
+		    logLine(streamIndex, offsets.size() - 1);
+		offsets.push_back(pos);
 	    }
-	    else
-	    {
-		lines[lines.size()-1] += text;
-	    }
-	    newLineSeen_ret = false;
+
+	    const char* p = (const char*) memchr(output.data() + pos, '\n', output.size() - pos);
+	    if (!p)
+		break;
+
+	    pos = p - output.data() + 1;
 	}
-	else
+
+	_outputLinesValid[streamIndex] = false;
+    }
+
+
+    void
+    SystemCmd::logLine(OutputStream streamIndex, size_t lineIndex) const
+    {
+	if (lineIndex < LINE_LIMIT)
 	{
-	    newLineSeen_ret = true;
+	    y2mil("Adding Line " << lineIndex + 1 << " \"" << line(streamIndex, lineIndex) << "\"");
 	}
-	y2deb("text:" << text << " NewLine:" << newLineSeen_ret);
-	if ( oldSize != lines.size() )
+	else
 	{
-	    y2mil("pid:" << _cmdPid << " added lines:" << lines.size() - oldSize << " stderr:" << isStderr);
+	    y2deb("Adding Line " << lineIndex + 1 << " \"" << line(streamIndex, lineIndex) << "\"");
 	}
     }
 
 
-    void
-    SystemCmd::extractNewline(const string& buffer, int count, bool& newLineSeen_ret,
-			      string& text, vector<string>& lines) const
+    string
+    SystemCmd::line(OutputStream streamIndex, size_t lineIndex) const
     {
-	string::size_type index;
+	const string& output = _output[streamIndex];
+	const vector<string::size_type>& offsets = _lineOffsets[streamIndex];
+
+	string::size_type begin = offsets[lineIndex];
+	string::size_type end = output.size();
 
-	text += buffer;
-	while ( (index=text.find( '\n' )) != string::npos )
+	if (lineIndex + 1 < offsets.size())
+	    end = offsets[lineIndex + 1] - 1;
+	else if (output.back() == '\n')
+	    --end;
+
+	return output.substr(begin, end - begin);
+    }
+
+
+    const vector<string>&
+    SystemCmd::lines(OutputStream streamIndex) const
+    {
+	vector<string>& lines = _outputLines[streamIndex];
+
+	if (!_outputLinesValid[streamIndex])
 	{
-	    if ( !newLineSeen_ret )
-	    {
-		lines[lines.size()-1] += text.substr( 0, index );
-	    }
-	    else
-	    {
-		addLine( text.substr( 0, index ), lines );
-	    }
-	    text.erase( 0, index+1 );
-	    newLineSeen_ret = true;
+	    // The last line created so far might have been incomplete.
+	    if (!lines.empty())
+		lines.pop_back();
+
+	    for (size_t i = lines.size(); i < _lineOffsets[streamIndex].size(); ++i)
+		lines.push_back(line(streamIndex, i));
+
+	    _outputLinesValid[streamIndex] = true;
 	}
-	y2deb("text: \"" << text << "\" newLineSeen: " << newLineSeen_ret);
+
+	return lines;
     }
 
 
     void
-    SystemCmd::addLine(const string& text, vector<string>& lines) const
+    SystemCmd::setOutput(OutputStream streamIndex, const vector<string>& lines)
     {
-	if (lines.size() < LINE_LIMIT)
-	{
-	    y2mil("Adding Line " << lines.size() + 1 << " \"" << text << "\"");
-	}
-	else
+	string& output = _output[streamIndex];
+	vector<string::size_type>& offsets = _lineOffsets[streamIndex];
+
+	output.clear();
+	offsets.clear();
+
+	for (const string& line : lines)
 	{
-	    y2deb("Adding Line " << lines.size() + 1 << " \"" << text << "\"");
+	    offsets.push_back(output.size());
+	    output.append(line).append(1, '\n');
 	}
 
-	lines.push_back(text);
+	_outputLines[streamIndex] = lines;
+	_outputLinesValid[streamIndex] = true;
     }
 
 
@@ -713,6 +1032,415 @@ namespace storage
     }
 
 
+    struct SystemCmd::Async
+    {
+	Async() : cmd(), stopwatch(), finished(false), exception(), pidfd(-1) {}
+
+	std::unique_ptr<SystemCmd> cmd;
+	Stopwatch stopwatch;
+	bool finished;
+	std::exception_ptr exception;
+	int pidfd;
+    };
+
+
+    /**
+     * Event loop for the commands started with SystemCmd::start(). Waits
+     * with epoll for the pipes of all commands and for their termination
+     * via pidfds. Without pidfds (kernel older than 5.3) the commands are
+     * checked for termination after every wakeup, which happens at least
+     * every 100 ms.
+     *
+     * A signalfd for SIGCHLD is not used since that requires blocking
+     * the signal in all threads of the program.
+     */
+    class SystemCmd::EventLoop : private boost::noncopyable
+    {
+    public:
+
+	EventLoop();
+	~EventLoop();
+
+	static EventLoop& instance();
+
+	void add(const shared_ptr<Async>& async);
+
+	/**
+	 * Waits for events once and handles them. If block is false
+	 * only pending events are handled.
+	 */
+	void run_once(bool block);
+
+	/**
+	 * Logs and records a finished command.
+	 */
+	static void complete(Async& async);
+
+    private:
+
+	bool reap(Async& async);
+
+	int epoll_fd;
+
+	uint64_t next_id;
+
+	map<uint64_t, shared_ptr<Async>> running;
+
+    };
+
+
+    SystemCmd::EventLoop::EventLoop()
+	: epoll_fd(epoll_create1(EPOLL_CLOEXEC)), next_id(0)
+    {
+	if (epoll_fd < 0)
+	    ST_THROW(Exception(Exception::strErrno(errno, "epoll_create1() failed")));
+    }
+
+
+    SystemCmd::EventLoop::~EventLoop()
+    {
+	close(epoll_fd);
+    }
+
+
+    SystemCmd::EventLoop&
+    SystemCmd::EventLoop::instance()
+    {
+	static thread_local EventLoop event_loop;
+
+	return event_loop;
+    }
+
+
+    void
+    SystemCmd::EventLoop::add(const shared_ptr<Async>& async)
+    {
+	SystemCmd& cmd = *async->cmd;
+
+	// The event data holds the id of the command and the index of the
+	// file descriptor: 0 to 2 for the pipes and 3 for the pidfd.
+
+	uint64_t id = next_id++;
+
+	vector<int> added_fds;
+
+	try
+	{
+	    for (unsigned int i = 0; i < 3; ++i)
+	    {
+		if (cmd._pfds[i].fd < 0)
+		    continue;
+
+		struct epoll_event event;
+		event.events = i == 0 ? EPOLLOUT : EPOLLIN;
+		event.data.u64 = 4 * id + i;
+
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, cmd._pfds[i].fd, &event) < 0)
+		    ST_THROW(Exception(Exception::strErrno(errno, "epoll_ctl() failed")));
+
+		added_fds.push_back(cmd._pfds[i].fd);
+	    }
+
+#ifdef SYS_pidfd_open
+	    async->pidfd = syscall(SYS_pidfd_open, cmd._cmdPid, 0);
+	    if (async->pidfd >= 0)
+	    {
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u64 = 4 * id + 3;
+
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, async->pidfd, &event) < 0)
+		    ST_THROW(Exception(Exception::strErrno(errno, "epoll_ctl() failed")));
+	    }
+#endif
+	}
+	catch (const Exception&)
+	{
+	    // Leave nothing of the command behind in the event loop.
+
+	    for (int fd : added_fds)
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+
+	    if (async->pidfd >= 0)
+	    {
+		close(async->pidfd);
+		async->pidfd = -1;
+	    }
+
+	    throw;
+	}
+
+	running[id] = async;
+    }
+
+
+    void
+    SystemCmd::EventLoop::run_once(bool block)
+    {
+	if (running.empty())
+	    return;
+
+	bool all_pidfds = all_of(running.begin(), running.end(),
+				 [](const pair<const uint64_t, shared_ptr<Async>>& tmp) {
+				     return tmp.second->pidfd >= 0;
+				 });
+
+	int timeout = !block ? 0 : all_pidfds ? 1000 : 100;
+
+	struct epoll_event events[32];
+
+	if (wait_lock)
+	    wait_lock->unlock();
+	int n = epoll_wait(epoll_fd, events, 32, timeout);
+	int epoll_errno = errno;
+	if (wait_lock)
+	    wait_lock->lock();
+
+	if (n < 0)
+	{
+	    if (epoll_errno != EINTR)
+		ST_THROW(Exception(Exception::strErrno(epoll_errno, "epoll_wait() failed")));
+	    n = 0;
+	}
+
+	set<uint64_t> terminated;
+
+	for (int i = 0; i < n; ++i)
+	{
+	    uint64_t id = events[i].data.u64 / 4;
+	    unsigned int index = events[i].data.u64 % 4;
+
+	    map<uint64_t, shared_ptr<Async>>::iterator it = running.find(id);
+	    if (it == running.end())
+		continue;
+
+	    // Closed file descriptors are removed from epoll by the
+	    // kernel.
+
+	    SystemCmd& cmd = *it->second->cmd;
+
+	    if (index == 0)
+		cmd.sendStdin();
+	    else if (index == 3)
+		terminated.insert(id);
+	    else
+		cmd.checkOutput();
+	}
+
+	for (map<uint64_t, shared_ptr<Async>>::iterator it = running.begin(); it != running.end();)
+	{
+	    Async& async = *it->second;
+
+	    if ((async.pidfd < 0 || terminated.count(it->first)) && reap(async))
+		it = running.erase(it);
+	    else
+		++it;
+	}
+    }
+
+
+    bool
+    SystemCmd::EventLoop::reap(Async& async)
+    {
+	SystemCmd& cmd = *async.cmd;
+
+	int cmd_status;
+	if (waitpid(cmd._cmdPid, &cmd_status, WNOHANG) == 0)
+	    return false;
+
+	if (async.pidfd >= 0)
+	{
+	    close(async.pidfd);
+	    async.pidfd = -1;
+	}
+
+	try
+	{
+	    cmd.doFinish(cmd_status, cmd._cmdRet);
+	    complete(async);
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	    async.exception = current_exception();
+	}
+
+	async.finished = true;
+
+	return true;
+    }
+
+
+    void
+    SystemCmd::EventLoop::complete(Async& async)
+    {
+	const SystemCmd& cmd = *async.cmd;
+
+	y2mil("system() Returns:" << cmd._cmdRet << " for \"" << cmd.command() << "\"");
+	if (cmd._cmdRet != 0)
+	    cmd.logOutput();
+
+	y2mil("stopwatch " << async.stopwatch << " for \"" << cmd.command() << "\"");
+
+	if (probe_statistics)
+	    probe_statistics->add_command(cmd.command(), async.stopwatch.read());
+
+	if (Mockup::get_mode() == Mockup::Mode::RECORD)
+	{
+	    Mockup::set_command(cmd.mockup_key(), Mockup::Command(cmd.stdout(), cmd.stderr(),
+								   cmd.retcode()));
+	}
+    }
+
+
+    bool
+    SystemCmd::Future::ready() const
+    {
+	if (!async->finished)
+	    EventLoop::instance().run_once(false);
+
+	return async->finished;
+    }
+
+
+    const SystemCmd&
+    SystemCmd::Future::get() const
+    {
+	while (!async->finished)
+	    EventLoop::instance().run_once(true);
+
+	if (async->exception)
+	    rethrow_exception(async->exception);
+
+	return *async->cmd;
+    }
+
+
+    SystemCmd::Future
+    SystemCmd::start(const Options& options)
+    {
+	bool immediately = Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks() ||
+	    _testmode;
+
+	if (!immediately)
+	    return start_background(options);
+
+	shared_ptr<Async> async = make_shared<Async>();
+
+	try
+	{
+	    async->cmd.reset(new SystemCmd(options));
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	    async->exception = current_exception();
+	}
+
+	async->finished = true;
+
+	return Future(async);
+    }
+
+
+    SystemCmd::Future
+    SystemCmd::start_background(const Options& options)
+    {
+	if (options.command.empty())
+            ST_THROW(SystemCmdException(nullptr, "No command specified"));
+
+	shared_ptr<Async> async = make_shared<Async>();
+
+	try
+	{
+	    async->cmd.reset(new SystemCmd(options, Background()));
+
+	    SystemCmd& cmd = *async->cmd;
+
+	    if (cmd._cmdPid > 0)
+	    {
+		// closes stdin of the child if there is no stdin text
+		cmd.sendStdin();
+
+		try
+		{
+		    EventLoop::instance().add(async);
+
+		    return Future(async);
+		}
+		catch (const Exception& exception)
+		{
+		    ST_CAUGHT(exception);
+
+		    // Without the event loop the command is waited for here,
+		    // the child must be reaped in any case.
+
+		    cmd.doWait(true, cmd._cmdRet);
+		}
+	    }
+
+	    // Either the command could not be started and doExecute() has
+	    // already finished it or it was waited for above.
+
+	    EventLoop::complete(*async);
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	    async->exception = current_exception();
+	}
+
+	async->finished = true;
+
+	return Future(async);
+    }
+
+
+    void
+    SystemCmd::wait_any(const vector<Future>& futures)
+    {
+	if (futures.empty())
+	    return;
+
+	while (none_of(futures.begin(), futures.end(), [](const Future& future) {
+	    return future.async->finished;
+	}))
+	{
+	    EventLoop::instance().run_once(true);
+	}
+    }
+
+
     bool SystemCmd::_testmode = false;
 
+    SystemCmd::UnlockWhileWaiting::UnlockWhileWaiting(std::unique_lock<std::mutex>& lock)
+	: previous(wait_lock)
+    {
+	wait_lock = &lock;
+    }
+
+
+    SystemCmd::UnlockWhileWaiting::~UnlockWhileWaiting()
+    {
+	wait_lock = previous;
+    }
+
+
+    SystemCmd::KeepLockWhileWaiting::KeepLockWhileWaiting()
+	: previous(wait_lock)
+    {
+	wait_lock = nullptr;
+    }
+
+
+    SystemCmd::KeepLockWhileWaiting::~KeepLockWhileWaiting()
+    {
+	wait_lock = previous;
+    }
+
+
+    thread_local std::unique_lock<std::mutex>* SystemCmd::wait_lock = nullptr;
+
+    ProbeStatistics* SystemCmd::probe_statistics = nullptr;
+
 }
@@ -26,13 +26,16 @@
 
 
 #include <sys/poll.h>
-#include <stdio.h>
 
 #include <string>
 #include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <boost/noncopyable.hpp>
 
 #include "storage/Utils/Exception.h"
+#include "storage/Utils/Remote.h"
 
 
 namespace storage
@@ -41,6 +44,7 @@ namespace storage
     using std::vector;
 
     class OutputProcessor;
+    class ProbeStatistics;
 
 
     /**
@@ -59,14 +63,29 @@ namespace storage
 	struct Options
 	{
 	    Options(const string& command, ThrowBehaviour throw_behaviour = NoThrow)
-		: command(command), throw_behaviour(throw_behaviour), stdin_text(),
+		: command(command), args(), throw_behaviour(throw_behaviour), stdin_text(),
 		  mockup_key() {}
 
+	    /**
+	     * Constructor for running a program with the arguments directly,
+	     * without a shell. args[0] is the program, searched in PATH if
+	     * it does not contain a slash. The command is set to the
+	     * arguments, quoted where needed, and used for logging and as
+	     * mockup key.
+	     */
+	    Options(const vector<string>& args, ThrowBehaviour throw_behaviour = NoThrow);
+
 	    /**
 	     * The command to be executed.
 	     */
 	    string command;
 
+	    /**
+	     * If not empty the program and its arguments executed instead
+	     * of running the command via the shell.
+	     */
+	    vector<string> args;
+
 	    /**
 	     * Should exceptions be thrown or not?
 	     */
@@ -144,12 +163,26 @@ namespace storage
 	/**
 	 * Return the output lines collected on stdout so far.
 	 */
-	const vector<string>& stdout() const { return _outputLines[IDX_STDOUT]; }
+	const vector<string>& stdout() const { return lines(IDX_STDOUT); }
 
 	/**
 	 * Return the output lines collected on stderr so far.
 	 */
-	const vector<string>& stderr() const { return _outputLines[IDX_STDERR]; }
+	const vector<string>& stderr() const { return lines(IDX_STDERR); }
+
+	/**
+	 * Return the output collected on stdout so far as one buffer. This
+	 * avoids splitting the output into lines for parsers that do not
+	 * need that.
+	 */
+	const string& stdout_buffer() const { return _output[IDX_STDOUT]; }
+
+	/**
+	 * Return the offsets of the lines in stdout_buffer(). A line ends
+	 * before the newline preceding the next offset or, for the last
+	 * line, at the end of the buffer without a trailing newline.
+	 */
+	const vector<string::size_type>& stdout_line_offsets() const { return _lineOffsets[IDX_STDOUT]; }
 
 	/**
 	 * Return the command executed.
@@ -173,26 +206,137 @@ namespace storage
 	 */
 	static string quote(const vector<string>& strs);
 
+	/**
+	 * While an object of this class exists the lock is released in
+	 * the current thread whenever SystemCmd waits for output or
+	 * termination of a command. Used by the parallel commit of
+	 * actions so that other actions can proceed meanwhile.
+	 */
+	class UnlockWhileWaiting : private boost::noncopyable
+	{
+	public:
+
+	    UnlockWhileWaiting(std::unique_lock<std::mutex>& lock);
+	    ~UnlockWhileWaiting();
+
+	private:
+
+	    std::unique_lock<std::mutex>* previous;
+
+	};
+
+	/**
+	 * While an object of this class exists the lock set by
+	 * UnlockWhileWaiting is kept while SystemCmd waits for a command
+	 * in the current thread. Used where other threads must not see an
+	 * intermediate state, e.g. while a temporary mount is created.
+	 */
+	class KeepLockWhileWaiting : private boost::noncopyable
+	{
+	public:
+
+	    KeepLockWhileWaiting();
+	    ~KeepLockWhileWaiting();
+
+	private:
+
+	    std::unique_lock<std::mutex>* previous;
+
+	};
+
+	/**
+	 * If set every command run is recorded there. Set during probing,
+	 * see Prober.
+	 */
+	static ProbeStatistics* probe_statistics;
+
+    protected:
+
+	struct Async;
+	class EventLoop;
+
+    public:
+
+	/**
+	 * Handle for a command started with start().
+	 */
+	class Future
+	{
+	public:
+
+	    /**
+	     * Returns whether the command has finished. Pending events of
+	     * the event loop are handled but there is no waiting.
+	     */
+	    bool ready() const;
+
+	    /**
+	     * Waits for the command to finish and returns it. If the
+	     * command failed and the throw behaviour is DoThrow the
+	     * exception is thrown here.
+	     */
+	    const SystemCmd& get() const;
+
+	private:
+
+	    friend class SystemCmd;
+
+	    Future(const std::shared_ptr<Async>& async) : async(async) {}
+
+	    std::shared_ptr<Async> async;
+
+	};
+
+	/**
+	 * Starts the command and returns immediately. The commands started
+	 * this way are handled by one event loop per thread. It runs while
+	 * waiting for any of the commands, so many commands can run at the
+	 * same time without a thread per command. The future must be
+	 * waited for in the thread that started the command.
+	 *
+	 * During mockup playback or with remote callbacks the command is
+	 * run immediately and the returned future is ready.
+	 */
+	static Future start(const Options& options);
+
+	/**
+	 * Waits until at least one of the futures is ready.
+	 */
+	static void wait_any(const vector<Future>& futures);
+
     protected:
 
 	enum OutputStream { IDX_STDOUT, IDX_STDERR };
 
+	struct Background {};
+
+	/**
+	 * Constructor used by start(). The command is started in the
+	 * background.
+	 */
+	SystemCmd(const Options& options, Background);
+
 	void init();
 	void cleanup();
 	void invalidate();
-	void closeOpenFds() const;
+	void closeFds();
 	int doExecute();
+	int doSpawn(int sin, int sout, int serr);
 	bool doWait(bool hang, int& cmdRet_ret);
+	void doFinish(int cmdStatus, int& cmdRet_ret);
 	void checkOutput();
         void sendStdin();
-	void getUntilEOF(FILE* file, std::vector<string>& lines,
-			 bool& newLineSeen_ret, bool isStderr) const;
-	void extractNewline(const string& buffer, int count, bool& newLineSeen_ret,
-			    string& text, std::vector<string>& lines) const;
-	void addLine(const string& text, std::vector<string>& lines) const;
+	void readUntilEAGAIN(OutputStream streamIndex);
+	void appendOutput(OutputStream streamIndex, const char* buffer, size_t count);
+	void logLine(OutputStream streamIndex, size_t lineIndex) const;
+	string line(OutputStream streamIndex, size_t lineIndex) const;
+	const vector<string>& lines(OutputStream streamIndex) const;
+	void setOutput(OutputStream streamIndex, const vector<string>& lines);
 
 	void logOutput() const;
 
+	static Future start_background(const Options& options);
+
 	bool do_throw() const { return options.throw_behaviour == DoThrow; }
 
 	const string& mockup_key() const
@@ -204,10 +348,15 @@ namespace storage
 
 	Options options;
 
-	FILE* _files[2];
-        FILE* _childStdin;
-	std::vector<string> _outputLines[2];
-	bool _newLineSeen[2];
+	// The output of stdout and stderr is collected in one buffer per
+	// stream together with the offsets of the lines. The vectors of
+	// lines returned by stdout() and stderr() are only created when
+	// requested.
+
+	string _output[2];
+	std::vector<string::size_type> _lineOffsets[2];
+	mutable std::vector<string> _outputLines[2];
+	mutable bool _outputLinesValid[2];
 	bool _combineOutput;
 	bool _execInBackground;
 	int _cmdRet;
@@ -217,6 +366,15 @@ namespace storage
 
 	static bool _testmode;
 
+    public:
+
+	static bool get_testmode() { return _testmode; }
+
+    private:
+
+	// the lock set by UnlockWhileWaiting
+	static thread_local std::unique_lock<std::mutex>* wait_lock;
+
 	static const unsigned LINE_LIMIT = 50;
 
     };
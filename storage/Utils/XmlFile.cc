@@ -51,6 +51,56 @@ namespace storage
     }
 
 
+    XmlReader::XmlReader(const string& filename)
+	: filename(filename), reader(xmlReaderForFile(filename.c_str(), NULL, XML_PARSE_NOBLANKS |
+						      XML_PARSE_NONET))
+    {
+	if (!reader)
+	    ST_THROW(Exception("failed to open xml document " + filename));
+    }
+
+
+    XmlReader::~XmlReader()
+    {
+	xmlFreeTextReader(reader);
+    }
+
+
+    bool
+    XmlReader::check(int ret) const
+    {
+	if (ret < 0)
+	    ST_THROW(Exception("failed to read xml document " + filename));
+
+	return ret == 1;
+    }
+
+
+    bool
+    XmlReader::read()
+    {
+	return check(xmlTextReaderRead(reader));
+    }
+
+
+    bool
+    XmlReader::next()
+    {
+	return check(xmlTextReaderNext(reader));
+    }
+
+
+    const xmlNode*
+    XmlReader::expand()
+    {
+	const xmlNode* node = xmlTextReaderExpand(reader);
+	if (!node)
+	    ST_THROW(Exception("failed to read xml document " + filename));
+
+	return node;
+    }
+
+
     xmlNode*
     xmlNewNode(const char* name)
     {
@@ -25,6 +25,7 @@
 
 
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -64,6 +65,59 @@ namespace storage
     };
 
 
+    /**
+     * Forward-only reader for large xml files. Unlike XmlFile the complete
+     * document is never kept in memory. Instead single elements can be
+     * expanded to a subtree which is valid until the reader moves on.
+     */
+    class XmlReader : private boost::noncopyable
+    {
+
+    public:
+
+	XmlReader(const string& filename);
+
+	~XmlReader();
+
+	/**
+	 * Moves to the next node in document order. Returns false at the
+	 * end of the document.
+	 */
+	bool read();
+
+	/**
+	 * Moves to the next sibling of the current node skipping all its
+	 * children. Returns false at the end of the document.
+	 */
+	bool next();
+
+	bool is_element() const
+	    { return xmlTextReaderNodeType(reader) == XML_READER_TYPE_ELEMENT; }
+
+	int depth() const
+	    { return xmlTextReaderDepth(reader); }
+
+	const char* name() const
+	    { return (const char*) xmlTextReaderConstName(reader); }
+
+	/**
+	 * Expands the current element including all its children. The
+	 * returned node is only valid until the next call to read() or
+	 * next().
+	 */
+	const xmlNode* expand();
+
+    private:
+
+	bool check(int ret) const;
+
+	const string filename;
+
+	xmlTextReader* reader;
+
+    };
+
+
     xmlNode* xmlNewNode(const char* name);
     xmlNode* xmlNewComment(const char* content);
 
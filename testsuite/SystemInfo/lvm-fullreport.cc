@@ -0,0 +1,129 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/SystemInfo/CmdLvm.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/StorageDefines.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+template <typename Type>
+string
+to_string(const Type& cmd)
+{
+    ostringstream parsed;
+    parsed.setf(std::ios::boolalpha);
+    parsed << cmd;
+
+    return parsed.str();
+}
+
+
+void
+check(const vector<string>& input, const vector<string>& output_pvs,
+      const vector<string>& output_vgs, const vector<string>& output_lvs)
+{
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(LVMBIN " fullreport --reportformat json --units b --nosuffix --all "
+			"--configreport pv --options pv_name,pv_uuid,vg_name,vg_uuid,pv_attr "
+			"--configreport vg --options vg_name,vg_uuid,vg_attr,vg_extent_size,"
+			"vg_extent_count,vg_free_count --configreport lv --options lv_name,lv_uuid,"
+			"vg_name,vg_uuid,lv_role,lv_attr,lv_size,stripes,stripe_size,chunk_size,"
+			"pool_lv,pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid "
+			"--configreport pvseg --options pvseg_start --configreport seg --options "
+			"seg_start", input);
+
+    CmdLvmFullreport cmd_lvm_fullreport;
+
+    BOOST_CHECK_EQUAL(to_string(*cmd_lvm_fullreport.get_cmd_pvs()), boost::join(output_pvs, "\n") + "\n");
+    BOOST_CHECK_EQUAL(to_string(*cmd_lvm_fullreport.get_cmd_vgs()), boost::join(output_vgs, "\n") + "\n");
+    BOOST_CHECK_EQUAL(to_string(*cmd_lvm_fullreport.get_cmd_lvs()), boost::join(output_lvs, "\n") + "\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(parse1)
+{
+    vector<string> input = {
+	"  {",
+	"      \"report\": [",
+	"          {",
+	"              \"vg\": [",
+	"                  {\"vg_name\":\"test\", \"vg_uuid\":\"Fk8Mxz-2XQq-RbyS-Sr0C-fP47-pGmr-Wo8qcy\", \"vg_attr\":\"wz--n-\", \"vg_extent_size\":\"4194304\", \"vg_extent_count\":\"2558\", \"vg_free_count\":\"1278\"}",
+	"              ]",
+	"              ,",
+	"              \"pv\": [",
+	"                  {\"pv_name\":\"/dev/sdb1\", \"pv_uuid\":\"qJXDas-uHxk-1ROq-EjhI-VEg1-zRsj-rUfJ3S\", \"vg_name\":\"test\", \"vg_uuid\":\"Fk8Mxz-2XQq-RbyS-Sr0C-fP47-pGmr-Wo8qcy\", \"pv_attr\":\"a--\"}",
+	"              ]",
+	"              ,",
+	"              \"lv\": [",
+	"                  {\"lv_name\":\"normal\", \"lv_uuid\":\"pj2ujN-ZgCx-M4xx-TVTQ-0xkD-NMSG-ZlFBL3\", \"vg_name\":\"test\", \"vg_uuid\":\"Fk8Mxz-2XQq-RbyS-Sr0C-fP47-pGmr-Wo8qcy\", \"lv_role\":\"public\", \"lv_attr\":\"-wi-a-----\", \"lv_size\":\"5368709120\", \"stripes\":\"1\", \"stripe_size\":\"0\", \"chunk_size\":\"0\", \"pool_lv\":\"\", \"pool_lv_uuid\":\"\", \"data_lv\":\"\", \"data_lv_uuid\":\"\", \"metadata_lv\":\"\", \"metadata_lv_uuid\":\"\"}",
+	"              ]",
+	"              ,",
+	"              \"pvseg\": [",
+	"                  {\"pvseg_start\":\"0\"}",
+	"              ]",
+	"              ,",
+	"              \"seg\": [",
+	"                  {\"seg_start\":\"0\"}",
+	"              ]",
+	"          }",
+	"          ,",
+	"          {",
+	"              \"vg\": [",
+	"              ]",
+	"              ,",
+	"              \"pv\": [",
+	"                  {\"pv_name\":\"/dev/sda2\", \"pv_uuid\":\"5Lddxt-YP8W-cAyr-9A4n-uZQl-pQqX-WhhiJJ\", \"vg_name\":\"\", \"vg_uuid\":\"\", \"pv_attr\":\"---\"}",
+	"              ]",
+	"              ,",
+	"              \"lv\": [",
+	"              ]",
+	"              ,",
+	"              \"pvseg\": [",
+	"              ]",
+	"              ,",
+	"              \"seg\": [",
+	"              ]",
+	"          }",
+	"      ]",
+	"  }"
+    };
+
+    vector<string> output_pvs = {
+	"pv:{ pv-name:/dev/sda2 pv-uuid:5Lddxt-YP8W-cAyr-9A4n-uZQl-pQqX-WhhiJJ vg-name: vg-uuid: }",
+	"pv:{ pv-name:/dev/sdb1 pv-uuid:qJXDas-uHxk-1ROq-EjhI-VEg1-zRsj-rUfJ3S vg-name:test vg-uuid:Fk8Mxz-2XQq-RbyS-Sr0C-fP47-pGmr-Wo8qcy }"
+    };
+
+    vector<string> output_vgs = {
+	"vg:{ vg-name:test vg-uuid:Fk8Mxz-2XQq-RbyS-Sr0C-fP47-pGmr-Wo8qcy extent-size:4194304 extent-count:2558 free-extent-count:1278 }"
+    };
+
+    vector<string> output_lvs = {
+	"lv:{ lv-name:normal lv-uuid:pj2ujN-ZgCx-M4xx-TVTQ-0xkD-NMSG-ZlFBL3 vg-name:test vg-uuid:Fk8Mxz-2XQq-RbyS-Sr0C-fP47-pGmr-Wo8qcy lv-type:normal active:true size:5368709120 stripes:1 }"
+    };
+
+    check(input, output_pvs, output_vgs, output_lvs);
+}
+
+
+BOOST_AUTO_TEST_CASE(not_supported)
+{
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(LVMBIN " fullreport --reportformat json --units b --nosuffix --all "
+			"--configreport pv --options pv_name,pv_uuid,vg_name,vg_uuid,pv_attr "
+			"--configreport vg --options vg_name,vg_uuid,vg_attr,vg_extent_size,"
+			"vg_extent_count,vg_free_count --configreport lv --options lv_name,lv_uuid,"
+			"vg_name,vg_uuid,lv_role,lv_attr,lv_size,stripes,stripe_size,chunk_size,"
+			"pool_lv,pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid "
+			"--configreport pvseg --options pvseg_start --configreport seg --options "
+			"seg_start", Mockup::Command({}, { "  No such command 'fullreport'." }, 3));
+
+    BOOST_CHECK_THROW(CmdLvmFullreport(), Exception);
+}
@@ -2,8 +2,12 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE libstorage
 
+#include <unistd.h>
+#include <string.h>
 #include <boost/test/unit_test.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/crc.hpp>
+#include <fstream>
 
 #include "storage/SystemInfo/CmdParted.h"
 #include "storage/Utils/Mockup.h"
@@ -317,3 +321,227 @@ BOOST_AUTO_TEST_CASE(parse_missing_semicolon)
 
     check_exception("/dev/sdc", input);
 }
+
+
+// Helpers to create image files with partition tables for reading them
+// directly. Numbers are stored little-endian.
+
+
+class Image
+{
+public:
+
+    Image(unsigned long long num_sectors)
+	: data(512 * num_sectors, 0) {}
+
+    ~Image() { unlink(name); }
+
+    void set(unsigned long long offset, unsigned long long value, unsigned int bytes)
+    {
+	for (unsigned int i = 0; i < bytes; ++i)
+	    data[offset + i] = (value >> (8 * i)) & 0xff;
+    }
+
+    void set_guid(unsigned long long offset, const string& guid)
+    {
+	vector<string> tmp;
+	boost::split(tmp, guid, boost::is_any_of("-"));
+
+	set(offset, stoul(tmp[0], nullptr, 16), 4);
+	set(offset + 4, stoul(tmp[1], nullptr, 16), 2);
+	set(offset + 6, stoul(tmp[2], nullptr, 16), 2);
+
+	string rest = tmp[3] + tmp[4];
+	for (unsigned int i = 0; i < 8; ++i)
+	    data[offset + 8 + i] = stoul(rest.substr(2 * i, 2), nullptr, 16);
+    }
+
+    void set_mbr_entry(unsigned long long sector, unsigned int i, bool boot, unsigned int type,
+		       unsigned long long start, unsigned long long size)
+    {
+	unsigned long long offset = 512 * sector + 446 + 16 * i;
+	data[offset] = boot ? 0x80 : 0x00;
+	data[offset + 4] = type;
+	set(offset + 8, start, 4);
+	set(offset + 12, size, 4);
+	set(512 * sector + 510, 0xaa55, 2);
+    }
+
+    uint32_t crc(unsigned long long offset, unsigned long long size) const
+    {
+	boost::crc_32_type crc;
+	crc.process_bytes(&data[offset], size);
+	return crc.checksum();
+    }
+
+    void set_gpt_header(unsigned long long lba, unsigned long long alternate_lba,
+			unsigned long long entries_lba, unsigned long long num_sectors)
+    {
+	unsigned long long offset = 512 * lba;
+	memcpy(&data[offset], "EFI PART", 8);
+	set(offset + 8, 0x00010000, 4);
+	set(offset + 12, 92, 4);
+	set(offset + 24, lba, 8);
+	set(offset + 32, alternate_lba, 8);
+	set(offset + 40, 34, 8);
+	set(offset + 48, num_sectors - 34, 8);
+	set(offset + 72, entries_lba, 8);
+	set(offset + 80, 128, 4);
+	set(offset + 84, 128, 4);
+	set(offset + 88, crc(512 * entries_lba, 128 * 128), 4);
+	set(offset + 16, crc(offset, 92), 4);
+    }
+
+    void set_gpt_entry(unsigned long long entries_lba, unsigned int i, const string& type,
+		       unsigned long long first, unsigned long long last, unsigned long long attributes)
+    {
+	unsigned long long offset = 512 * entries_lba + 128 * i;
+	set_guid(offset, type);
+	set(offset + 32, first, 8);
+	set(offset + 40, last, 8);
+	set(offset + 48, attributes, 8);
+    }
+
+    void write() const
+    {
+	ofstream file(name, ios::binary);
+	file.write((const char*) data.data(), data.size());
+    }
+
+    static const char* name;
+
+    vector<unsigned char> data;
+
+};
+
+
+const char* Image::name = "parted-test.img";
+
+
+string
+read_directly(const Image& image)
+{
+    Mockup::set_mode(Mockup::Mode::NONE);
+
+    image.write();
+
+    shared_ptr<Parted> parted = Parted::read_directly(Image::name);
+    if (!parted)
+	return "not possible";
+
+    ostringstream parsed;
+    parsed << *parted;
+
+    return parsed.str();
+}
+
+
+Image
+gpt_image()
+{
+    const unsigned long long num_sectors = 204800;
+
+    Image image(num_sectors);
+    image.set_mbr_entry(0, 0, false, 0xee, 1, num_sectors - 1);
+
+    for (unsigned long long entries_lba : { 2ULL, num_sectors - 33 })
+    {
+	image.set_gpt_entry(entries_lba, 0, "C12A7328-F81F-11D2-BA4B-00A0C93EC93B", 2048, 4095, 0);
+	image.set_gpt_entry(entries_lba, 1, "0FC63DAF-8483-4772-8E79-3D69D8477DE4", 4096, 100000, 1ULL << 2);
+	image.set_gpt_entry(entries_lba, 3, "E6D6D379-F507-44C2-A23C-238F2A3DF928", 100001, 204766, 0);
+    }
+
+    image.set_gpt_header(1, num_sectors - 1, 2, num_sectors);
+    image.set_gpt_header(num_sectors - 1, 1, num_sectors - 33, num_sectors);
+
+    return image;
+}
+
+
+BOOST_AUTO_TEST_CASE(read_directly_msdos)
+{
+    Image image(204800);
+    image.set_mbr_entry(0, 0, true, 0x83, 2048, 100000);
+    image.set_mbr_entry(0, 1, false, 0x0f, 102048, 100000);
+    image.set_mbr_entry(102048, 0, false, 0x82, 2048, 40000);
+    image.set_mbr_entry(102048, 1, false, 0x05, 50000, 50000);
+    image.set_mbr_entry(152048, 0, false, 0x8e, 2048, 40000);
+
+    vector<string> output = {
+	"device:parted-test.img label:MS-DOS region:[0, 204800, 512 B]",
+	"number:1 region:[2048, 100000, 512 B] type:primary id:0x83 boot",
+	"number:2 region:[102048, 100000, 512 B] type:extended id:0x0F",
+	"number:5 region:[104096, 40000, 512 B] type:logical id:0x82",
+	"number:6 region:[154096, 40000, 512 B] type:logical id:0x8E"
+    };
+
+    BOOST_CHECK_EQUAL(read_directly(image), boost::join(output, "\n") + "\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(read_directly_gpt)
+{
+    Image image = gpt_image();
+
+    vector<string> output = {
+	"device:parted-test.img label:GPT region:[0, 204800, 512 B]",
+	"number:1 region:[2048, 2048, 512 B] type:primary id:0xEF",
+	"number:2 region:[4096, 95905, 512 B] type:primary id:0x83 legacy-boot",
+	"number:4 region:[100001, 104766, 512 B] type:primary id:0x8E"
+    };
+
+    BOOST_CHECK_EQUAL(read_directly(image), boost::join(output, "\n") + "\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(read_directly_gpt_broken_backup)
+{
+    // parted must report the broken backup
+
+    Image image = gpt_image();
+    image.data[512 * (204800 - 1) + 40] ^= 0xff;
+
+    BOOST_CHECK_EQUAL(read_directly(image), "not possible");
+}
+
+
+BOOST_AUTO_TEST_CASE(read_directly_no_partition_table)
+{
+    Image image(2048);
+
+    BOOST_CHECK_EQUAL(read_directly(image), "not possible");
+}
+
+
+BOOST_AUTO_TEST_CASE(parse_finished_command)
+{
+    // the constructor used for results of prefetch parses a command that
+    // was already run
+
+    vector<string> input = {
+	"BYT;",
+	"/dev/sdb:160086528s:scsi:512:512:msdos:Maxtor 6 Y080L0:;",
+	"1:2048s:32016383s:32014336s:ext4::type=83;"
+    };
+
+    vector<string> output = {
+	"device:/dev/sdb label:MS-DOS region:[0, 160086528, 512 B]",
+	"number:1 region:[2048, 32014336, 512 B] type:primary id:0x83"
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(Parted::command("/dev/sdb"), input);
+    Mockup::set_command(Parted::command("/dev/sdc"), RemoteCommand({}, { "Error: Could not stat device /dev/sdc" }, 1));
+
+    SystemCmd cmd1(Parted::command("/dev/sdb"));
+    Parted parted("/dev/sdb", cmd1);
+
+    ostringstream parsed;
+    parsed.setf(std::ios::boolalpha);
+    parsed << parted;
+
+    BOOST_CHECK_EQUAL(parsed.str(), boost::join(output, "\n") + "\n");
+
+    SystemCmd cmd2(Parted::command("/dev/sdc"));
+    BOOST_CHECK_THROW({ Parted parted("/dev/sdc", cmd2); }, SystemCmdException);
+}
@@ -2,6 +2,7 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE libstorage
 
+#include <sys/sysmacros.h>
 #include <boost/test/unit_test.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -115,3 +116,120 @@ BOOST_AUTO_TEST_CASE(parse1)
 
     check("/dev/sda1", input, output);
 }
+
+
+BOOST_AUTO_TEST_CASE(parse_export_db)
+{
+    vector<string> input = {
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda",
+	"N: sda",
+	"S: disk/by-id/wwn-0x50014ee203733bb5",
+	"S: disk/by-path/pci-0000:00:1f.2-ata-1.0",
+	"E: MAJOR=8",
+	"E: MINOR=0",
+	"",
+	"P: /devices/virtual/net/lo",
+	"E: INTERFACE=lo",
+	"",
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1",
+	"N: sda1",
+	"S: disk/by-id/wwn-0x50014ee203733bb5-part1",
+	"S: disk/by-label/BOOT",
+	"S: disk/by-path/pci-0000:00:1f.2-ata-1.0-part1",
+	"E: MAJOR=8",
+	"E: MINOR=1",
+	""
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(UDEVADMBIN_SETTLE, {});
+    Mockup::set_command(UDEVADMBIN " info --export-db", input);
+
+    CmdUdevadmExportDb cmdudevadmexportdb;
+
+    // no 'udevadm info' mockup is present so the lookup must be done in
+    // the database
+
+    CmdUdevadmInfo cmdudevadminfo1("/dev/disk/by-label/BOOT", &cmdudevadmexportdb);
+
+    ostringstream parsed1;
+    parsed1 << cmdudevadminfo1;
+
+    BOOST_CHECK_EQUAL(parsed1.str(), "file:/dev/disk/by-label/BOOT path:/devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1 "
+		      "name:sda1 majorminor:8:1 by-path-links:<pci-0000:00:1f.2-ata-1.0-part1> by-id-links:<wwn-0x50014ee203733bb5-part1>\n");
+
+    CmdUdevadmInfo cmdudevadminfo2("/dev/sda", &cmdudevadmexportdb);
+
+    ostringstream parsed2;
+    parsed2 << cmdudevadminfo2;
+
+    BOOST_CHECK_EQUAL(parsed2.str(), "file:/dev/sda path:/devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda "
+		      "name:sda majorminor:8:0 by-path-links:<pci-0000:00:1f.2-ata-1.0> by-id-links:<wwn-0x50014ee203733bb5>\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(export_db_find_by_majorminor)
+{
+    vector<string> input = {
+	"P: /devices/virtual/block/dm-0",
+	"N: dm-0",
+	"S: mapper/system-root",
+	"S: system/root",
+	"E: MAJOR=254",
+	"E: MINOR=0",
+	"",
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda",
+	"N: sda",
+	"E: MAJOR=8",
+	"E: MINOR=0",
+	""
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(UDEVADMBIN_SETTLE, {});
+    Mockup::set_command(UDEVADMBIN " info --export-db", input);
+
+    CmdUdevadmExportDb cmdudevadmexportdb;
+
+    vector<string> files = { "/dev/dm-0", "/dev/mapper/system-root", "/dev/system/root" };
+    BOOST_CHECK(cmdudevadmexportdb.find_by_majorminor(makedev(254, 0)) == files);
+
+    BOOST_CHECK_EQUAL(cmdudevadmexportdb.find_by_majorminor(makedev(8, 0)).size(), 1);
+    BOOST_CHECK(cmdudevadmexportdb.find_by_majorminor(makedev(8, 1)).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(export_db_without_majorminor)
+{
+    vector<string> input = {
+	"P: /devices/virtual/misc/foo",
+	"N: foo",
+	"",
+	"P: /devices/virtual/misc/bar",
+	"N: bar",
+	"S: bar-link",
+	"",
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda",
+	"N: sda",
+	"E: MAJOR=8",
+	"E: MINOR=0",
+	""
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(UDEVADMBIN_SETTLE, {});
+    Mockup::set_command(UDEVADMBIN " info --export-db", input);
+
+    CmdUdevadmExportDb cmdudevadmexportdb;
+
+    // records without major and minor number must not collide on 0:0
+
+    BOOST_CHECK(cmdudevadmexportdb.find_by_majorminor(makedev(0, 0)).empty());
+    BOOST_CHECK_EQUAL(cmdudevadmexportdb.find_by_majorminor(makedev(8, 0)).size(), 1);
+
+    // but can still be found by name
+
+    vector<string>::const_iterator begin, end;
+    BOOST_CHECK(cmdudevadmexportdb.find("/dev/bar-link", begin, end));
+    BOOST_CHECK_EQUAL(*begin, "P: /devices/virtual/misc/bar");
+}
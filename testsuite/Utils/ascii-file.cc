@@ -0,0 +1,72 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <unistd.h>
+
+#include "storage/Utils/AsciiFile.h"
+#include "storage/Utils/AppUtil.h"
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(test_extract_nth_word)
+{
+    BOOST_CHECK_EQUAL(extract_nth_word(0, "  hello  world "), "hello");
+    BOOST_CHECK_EQUAL(extract_nth_word(1, "  hello  world "), "world");
+    BOOST_CHECK_EQUAL(extract_nth_word(2, "  hello  world "), "");
+    BOOST_CHECK_EQUAL(extract_nth_word(0, "hello\tworld", true), "hello\tworld");
+    BOOST_CHECK_EQUAL(extract_nth_word(0, ""), "");
+
+    for (const string line : { "  8  0  976762584 sda", "a b", "", " " })
+	for (int i = 0; i < 5; ++i)
+	    BOOST_CHECK_EQUAL(extract_nth_word(i, line), extractNthWord(i, line));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_line_buffer)
+{
+    LineBuffer buffer;
+
+    buffer.assign({ "hello", "", "world" });
+
+    BOOST_CHECK_EQUAL(buffer.size(), 3);
+    BOOST_CHECK_EQUAL(buffer[0], "hello");
+    BOOST_CHECK_EQUAL(buffer[1], "");
+    BOOST_CHECK_EQUAL(buffer[2], "world");
+    BOOST_CHECK_EQUAL(buffer.get_content(), "hello\n\nworld\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_ascii_file)
+{
+    {
+	ofstream fout("ascii-file.txt");
+	fout << "first\nsecond\nno newline";
+    }
+
+    AsciiFile file("ascii-file.txt");
+
+    const LineBuffer& buffer = file.get_line_buffer();
+    BOOST_CHECK_EQUAL(buffer.size(), 3);
+    BOOST_CHECK_EQUAL(buffer[2], "no newline");
+
+    file.get_lines()[1] = "changed";
+
+    // the buffer is rebuilt only once after the modification
+
+    boost::string_ref line = file.get_line_buffer()[1];
+    BOOST_CHECK_EQUAL(line, "changed");
+    BOOST_CHECK(file.get_line_buffer()[1].data() == line.data());
+
+    BOOST_CHECK(file.save());
+
+    AsciiFile reloaded("ascii-file.txt");
+    BOOST_CHECK_EQUAL(reloaded.get_line_buffer().get_content(), "first\nchanged\nno newline\n");
+
+    BOOST_CHECK(!LineBuffer().read("ascii-file.does-not-exist"));
+
+    unlink("ascii-file.txt");
+}
@@ -0,0 +1,235 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <string.h>
+#include <endian.h>
+#include <linux/btrfs_tree.h>
+#include <map>
+
+#include "storage/Utils/BtrfsUtils.h"
+#include "storage/Utils/Exception.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Returns the results of the ioctls from buffers in the layout the kernel
+ * uses instead of calling the ioctls. Each call of tree_search returns
+ * the next result, afterwards no items.
+ */
+class CapturedSearch : public BtrfsSearch
+{
+public:
+
+    void add_result(const string& buf, __u32 nr_items)
+    {
+	results.emplace_back(buf, nr_items);
+    }
+
+    void add_lookup(__u64 treeid, __u64 objectid, const string& name)
+    {
+	lookups[make_pair(treeid, objectid)] = name;
+    }
+
+    void tree_search(struct btrfs_ioctl_search_args& args) const override
+    {
+	keys.push_back(args.key);
+
+	if (keys.size() > results.size())
+	{
+	    args.key.nr_items = 0;
+	    return;
+	}
+
+	const pair<string, __u32>& result = results[keys.size() - 1];
+
+	BOOST_REQUIRE(result.first.size() <= sizeof(args.buf));
+	BOOST_REQUIRE(result.second <= args.key.nr_items);
+
+	memset(args.buf, 0, sizeof(args.buf));
+	memcpy(args.buf, result.first.data(), result.first.size());
+	args.key.nr_items = result.second;
+    }
+
+    void ino_lookup(struct btrfs_ioctl_ino_lookup_args& args) const override
+    {
+	map<pair<__u64, __u64>, string>::const_iterator it = lookups.find(make_pair(args.treeid, args.objectid));
+	if (it == lookups.end())
+	    throw Exception("unexpected lookup");
+
+	strncpy(args.name, it->second.c_str(), sizeof(args.name));
+    }
+
+    mutable vector<struct btrfs_ioctl_search_key> keys;
+
+private:
+
+    vector<pair<string, __u32>> results;
+
+    map<pair<__u64, __u64>, string> lookups;
+
+};
+
+
+string
+item(__u64 objectid, __u32 type, __u64 offset, const string& data)
+{
+    // The search header is in host byte order.
+
+    struct btrfs_ioctl_search_header header;
+    memset(&header, 0, sizeof(header));
+    header.transid = 7;
+    header.objectid = objectid;
+    header.offset = offset;
+    header.type = type;
+    header.len = data.size();
+
+    return string((const char*)(&header), sizeof(header)) + data;
+}
+
+
+string
+root_ref(__u64 dirid, const string& name)
+{
+    // The items are in little endian byte order.
+
+    struct btrfs_root_ref root_ref;
+    memset(&root_ref, 0, sizeof(root_ref));
+    root_ref.dirid = htole64(dirid);
+    root_ref.sequence = htole64(2);
+    root_ref.name_len = htole16(name.size());
+
+    return string((const char*)(&root_ref), sizeof(root_ref)) + name;
+}
+
+
+string
+dir_item(__u64 location, const string& name)
+{
+    struct btrfs_dir_item dir_item;
+    memset(&dir_item, 0, sizeof(dir_item));
+    dir_item.location.objectid = htole64(location);
+    dir_item.location.type = BTRFS_ROOT_ITEM_KEY;
+    dir_item.location.offset = htole64(-1);
+    dir_item.transid = htole64(7);
+    dir_item.name_len = htole16(name.size());
+    dir_item.type = BTRFS_FT_DIR;
+
+    return string((const char*)(&dir_item), sizeof(dir_item)) + name;
+}
+
+
+BOOST_AUTO_TEST_CASE(list_subvolumes)
+{
+    // Subvolumes @, @/home and @/var/log where var is a directory in @
+    // with inode 260. The results are split in two calls and contain an
+    // item of another type that must be skipped.
+
+    CapturedSearch search;
+
+    search.add_result(item(256, BTRFS_ROOT_BACKREF_KEY, 5, root_ref(256, "@")) +
+		      item(257, BTRFS_ROOT_ITEM_KEY, 0, string(439, '\0')) +
+		      item(257, BTRFS_ROOT_BACKREF_KEY, 256, root_ref(256, "home")), 3);
+    search.add_result(item(258, BTRFS_ROOT_BACKREF_KEY, 256, root_ref(260, "log")), 1);
+
+    search.add_lookup(5, 256, "");
+    search.add_lookup(256, 256, "");
+    search.add_lookup(256, 260, "var/");
+
+    vector<BtrfsSubvolumeEntry> entries = btrfs_list_subvolumes(search);
+
+    BOOST_REQUIRE_EQUAL(entries.size(), 3);
+
+    BOOST_CHECK_EQUAL(entries[0].id, 256);
+    BOOST_CHECK_EQUAL(entries[0].parent_id, 5);
+    BOOST_CHECK_EQUAL(entries[0].path, "@");
+
+    BOOST_CHECK_EQUAL(entries[1].id, 257);
+    BOOST_CHECK_EQUAL(entries[1].parent_id, 256);
+    BOOST_CHECK_EQUAL(entries[1].path, "@/home");
+
+    BOOST_CHECK_EQUAL(entries[2].id, 258);
+    BOOST_CHECK_EQUAL(entries[2].parent_id, 256);
+    BOOST_CHECK_EQUAL(entries[2].path, "@/var/log");
+
+    // The second and third search continue after the last item found.
+
+    BOOST_REQUIRE_EQUAL(search.keys.size(), 3);
+
+    BOOST_CHECK_EQUAL(search.keys[0].tree_id, BTRFS_ROOT_TREE_OBJECTID);
+    BOOST_CHECK_EQUAL(search.keys[0].min_objectid, BTRFS_FIRST_FREE_OBJECTID);
+    BOOST_CHECK_EQUAL(search.keys[0].min_type, BTRFS_ROOT_BACKREF_KEY);
+    BOOST_CHECK_EQUAL(search.keys[0].min_offset, 0);
+
+    BOOST_CHECK_EQUAL(search.keys[1].min_objectid, 257);
+    BOOST_CHECK_EQUAL(search.keys[1].min_offset, 257);
+
+    BOOST_CHECK_EQUAL(search.keys[2].min_objectid, 258);
+    BOOST_CHECK_EQUAL(search.keys[2].min_offset, 257);
+}
+
+
+BOOST_AUTO_TEST_CASE(list_subvolumes_empty)
+{
+    CapturedSearch search;
+
+    BOOST_CHECK(btrfs_list_subvolumes(search).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(list_subvolumes_invalid)
+{
+    // The length of the item exceeds the buffer.
+
+    string buf = item(256, BTRFS_ROOT_BACKREF_KEY, 5, root_ref(256, "@"));
+
+    struct btrfs_ioctl_search_header header;
+    memcpy(&header, buf.data(), sizeof(header));
+    header.len = BTRFS_SEARCH_ARGS_BUFSIZE;
+    buf.replace(0, sizeof(header), (const char*)(&header), sizeof(header));
+
+    CapturedSearch search;
+    search.add_result(buf, 1);
+
+    BOOST_CHECK_THROW(btrfs_list_subvolumes(search), Exception);
+
+    // The name exceeds the item.
+
+    CapturedSearch search2;
+    search2.add_result(item(256, BTRFS_ROOT_BACKREF_KEY, 5, root_ref(256, "@").substr(0, 10)), 1);
+
+    BOOST_CHECK_THROW(btrfs_list_subvolumes(search2), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(default_subvolume_id)
+{
+    // The root tree directory contains the dir item "default". Another
+    // dir item must be ignored.
+
+    CapturedSearch search;
+
+    search.add_result(item(BTRFS_ROOT_TREE_DIR_OBJECTID, BTRFS_DIR_ITEM_KEY, 1234, dir_item(300, "other")) +
+		      item(BTRFS_ROOT_TREE_DIR_OBJECTID, BTRFS_DIR_ITEM_KEY, 2378154706, dir_item(258, "default")), 2);
+
+    BOOST_CHECK_EQUAL(btrfs_default_subvolume_id(search), 258);
+
+    BOOST_REQUIRE(!search.keys.empty());
+    BOOST_CHECK_EQUAL(search.keys[0].min_objectid, BTRFS_ROOT_TREE_DIR_OBJECTID);
+    BOOST_CHECK_EQUAL(search.keys[0].max_objectid, BTRFS_ROOT_TREE_DIR_OBJECTID);
+    BOOST_CHECK_EQUAL(search.keys[0].min_type, BTRFS_DIR_ITEM_KEY);
+}
+
+
+BOOST_AUTO_TEST_CASE(default_subvolume_id_top_level)
+{
+    // Without the dir item the top-level subvolume is the default.
+
+    CapturedSearch search;
+
+    BOOST_CHECK_EQUAL(btrfs_default_subvolume_id(search), BTRFS_FS_TREE_OBJECTID);
+}
@@ -0,0 +1,134 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/JsonFile.h"
+#include "storage/Utils/Exception.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+string
+tokens(const string& text)
+{
+    JsonReader reader(text);
+
+    string ret;
+
+    while (true)
+    {
+	JsonReader::Token token = reader.next();
+
+	switch (token)
+	{
+	    case JsonReader::Token::BEGIN_OBJECT: ret += "{ "; break;
+	    case JsonReader::Token::END_OBJECT: ret += "} "; break;
+	    case JsonReader::Token::BEGIN_ARRAY: ret += "[ "; break;
+	    case JsonReader::Token::END_ARRAY: ret += "] "; break;
+	    case JsonReader::Token::KEY: ret += "key:" + reader.get_value().to_string() + " "; break;
+	    case JsonReader::Token::STRING: ret += "string:" + reader.get_value().to_string() + " "; break;
+	    case JsonReader::Token::NUMBER: ret += "number:" + reader.get_value().to_string() + " "; break;
+	    case JsonReader::Token::TRUE: ret += "true "; break;
+	    case JsonReader::Token::FALSE: ret += "false "; break;
+	    case JsonReader::Token::NULL_VALUE: ret += "null "; break;
+	    case JsonReader::Token::END: return ret + "end";
+	}
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_tokens)
+{
+    BOOST_CHECK_EQUAL(tokens("{ }"), "{ } end");
+    BOOST_CHECK_EQUAL(tokens("[]"), "[ ] end");
+    BOOST_CHECK_EQUAL(tokens("42"), "number:42 end");
+    BOOST_CHECK_EQUAL(tokens("[1, {\"a\": 2,},]"), "[ number:1 { key:a number:2 } ] end");
+
+    BOOST_CHECK_EQUAL(tokens("{\"a\": [1, -2.5e3, \"x\", true, false, null, {}, []], \"b\" : {\"c\":\"d\"}}\n"),
+		      "{ key:a [ number:1 number:-2.5e3 string:x true false null { } [ ] ] key:b { key:c "
+		      "string:d } } end");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_escapes)
+{
+    BOOST_CHECK_EQUAL(tokens("\"a\\\"b\\\\c\\/d\\te\\n\""), "string:a\"b\\c/d\te\n end");
+    BOOST_CHECK_EQUAL(tokens("\"\\u00e4\\u20ac\\ud83d\\ude00\""), "string:\xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80 end");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_errors)
+{
+    BOOST_CHECK_THROW(tokens(""), Exception);
+    BOOST_CHECK_THROW(tokens("{"), Exception);
+    BOOST_CHECK_THROW(tokens("[,]"), Exception);
+    BOOST_CHECK_THROW(tokens("[1,,]"), Exception);
+    BOOST_CHECK_THROW(tokens("[1 2]"), Exception);
+    BOOST_CHECK_THROW(tokens("{\"a\" 1}"), Exception);
+    BOOST_CHECK_THROW(tokens("{\"a\": 1]"), Exception);
+    BOOST_CHECK_THROW(tokens("[tru]"), Exception);
+    BOOST_CHECK_THROW(tokens("\"abc"), Exception);
+    BOOST_CHECK_THROW(tokens("\"\\x\""), Exception);
+    BOOST_CHECK_THROW(tokens("{} {}"), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_record)
+{
+    string text = "[ { \"name\": \"sda\", \"size\": \"1024\", \"ro\": false, \"children\": [ { \"name\": \"sda1\" } ], "
+	"\"label\": null }, 1, { \"name\": \"a\\\"b\" } ]";
+
+    JsonReader reader(text);
+    JsonRecord record;
+
+    reader.expect(JsonReader::Token::BEGIN_ARRAY);
+
+    BOOST_REQUIRE(reader.next_object());
+    reader.read_record(record);
+
+    string name;
+    BOOST_CHECK(get_child_value(record, "name", name));
+    BOOST_CHECK_EQUAL(name, "sda");
+
+    unsigned long long size = 0;
+    BOOST_CHECK(get_child_value(record, "size", size));
+    BOOST_CHECK_EQUAL(size, 1024);
+
+    string ro;
+    BOOST_CHECK(get_child_value(record, "ro", ro));
+    BOOST_CHECK_EQUAL(ro, "false");
+
+    BOOST_CHECK(!get_child_value(record, "children", name));
+    BOOST_CHECK(!get_child_value(record, "label", name));
+
+    BOOST_REQUIRE(reader.next_object());
+    reader.read_record(record);
+
+    BOOST_CHECK(get_child_value(record, "name", name));
+    BOOST_CHECK_EQUAL(name, "a\"b");
+
+    BOOST_CHECK(!reader.next_object());
+    BOOST_CHECK(reader.next() == JsonReader::Token::END);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_record_overflow)
+{
+    string text = "{ \"max\": \"18446744073709551615\", \"over\": \"18446744073709551616\" }";
+
+    JsonReader reader(text);
+    JsonRecord record;
+
+    reader.expect(JsonReader::Token::BEGIN_OBJECT);
+    reader.read_record(record);
+
+    unsigned long long value = 0;
+    BOOST_CHECK(get_child_value(record, "max", value));
+    BOOST_CHECK_EQUAL(value, 18446744073709551615ULL);
+
+    BOOST_CHECK_THROW(get_child_value(record, "over", value), ParseException);
+}
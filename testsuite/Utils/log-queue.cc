@@ -0,0 +1,76 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <thread>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/LoggerImpl.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Logger recording the lines and the threads calling it.
+ */
+class TestLogger : public Logger
+{
+public:
+
+    virtual bool test(LogLevel log_level, const string& component) override
+    {
+	threads.push_back(this_thread::get_id());
+	return log_level != LogLevel::DEBUG;
+    }
+
+    virtual void write(LogLevel log_level, const string& component, const string& file,
+		       int line, const string& function, const string& content) override
+    {
+	threads.push_back(this_thread::get_id());
+	lines.push_back(content);
+    }
+
+    vector<thread::id> threads;
+    vector<string> lines;
+
+};
+
+
+BOOST_AUTO_TEST_CASE(log_queue)
+{
+    TestLogger test_logger;
+    set_logger(&test_logger);
+
+    {
+	LogQueue log_queue;
+
+	thread worker([&log_queue]() {
+	    LogQueue::Redirect log_redirect(log_queue);
+
+	    y2mil("hello" << endl << "world");
+	    y2deb("not logged");
+	});
+
+	worker.join();
+
+	BOOST_CHECK(test_logger.lines.empty());
+
+	log_queue.flush();
+    }
+
+    y2mil("direct");
+
+    set_logger(nullptr);
+
+    BOOST_CHECK_EQUAL(test_logger.lines.size(), 3);
+    BOOST_CHECK_EQUAL(test_logger.lines[0], "hello");
+    BOOST_CHECK_EQUAL(test_logger.lines[1], "world");
+    BOOST_CHECK_EQUAL(test_logger.lines[2], "direct");
+
+    // the logger is only called from the main thread
+
+    for (const thread::id& id : test_logger.threads)
+	BOOST_CHECK(id == this_thread::get_id());
+}
@@ -0,0 +1,95 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/RegionIndex.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+namespace std
+{
+    ostream& operator<<(ostream& s, const vector<Region>& regions)
+    {
+	s << "{";
+	for (vector<Region>::const_iterator it = regions.begin(); it != regions.end(); ++it)
+	    s << (it == regions.begin() ? " " : ", ") << *it;
+	s << " }";
+
+	return s;
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_add_and_remove)
+{
+    Region region(0, 1000, 512);
+
+    RegionIndex region_index(region, { Region(100, 100, 512), Region(500, 100, 512) });
+
+    BOOST_CHECK_EQUAL(region_index.get_unused(), region.unused_regions({ Region(100, 100, 512), Region(500, 100, 512) }));
+
+    BOOST_CHECK(!region_index.add_used(Region(150, 100, 512)));
+    BOOST_CHECK(region_index.add_used(Region(200, 300, 512)));
+    BOOST_CHECK_EQUAL(region_index.num_used_before(600), 3);
+
+    BOOST_CHECK(!region_index.remove_used(Region(200, 200, 512)));
+    BOOST_CHECK(region_index.remove_used(Region(100, 100, 512)));
+
+    BOOST_CHECK_EQUAL(region_index.get_unused(), region.unused_regions({ Region(200, 300, 512), Region(500, 100, 512) }));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_random)
+{
+    Region region(34, 100000, 512);
+
+    vector<Region> used_regions;
+
+    RegionIndex region_index(region, used_regions);
+
+    srand(42);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+	if (used_regions.empty() || rand() % 3 != 0)
+	{
+	    Region used_region(34 + rand() % 100000, 1 + rand() % 1000, 512);
+	    if (!used_region.inside(region))
+		continue;
+
+	    bool free = none_of(used_regions.begin(), used_regions.end(), [&used_region](const Region& tmp) {
+		return tmp.intersect(used_region);
+	    });
+
+	    BOOST_CHECK_EQUAL(region_index.add_used(used_region), free);
+	    if (free)
+		used_regions.push_back(used_region);
+	}
+	else
+	{
+	    vector<Region>::iterator it = used_regions.begin() + rand() % used_regions.size();
+
+	    BOOST_CHECK(region_index.remove_used(*it));
+	    used_regions.erase(it);
+	}
+
+	vector<Region> unused_regions = region.unused_regions(used_regions);
+
+	BOOST_REQUIRE_EQUAL(region_index.get_unused(), unused_regions);
+
+	unsigned long long largest = 0;
+	for (const Region& unused_region : unused_regions)
+	    largest = max(largest, unused_region.get_length());
+
+	region_index.for_each_unused_by_length([largest](const Region::Impl& unused_region) {
+	    BOOST_CHECK_EQUAL(unused_region.get_length(), largest);
+	    return false;
+	});
+    }
+}
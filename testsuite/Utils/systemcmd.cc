@@ -9,6 +9,8 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "storage/Utils/Exception.h"
 #include "storage/Utils/Mockup.h"
@@ -105,6 +107,49 @@ BOOST_AUTO_TEST_CASE(pipe_stdin)
 }
 
 
+BOOST_AUTO_TEST_CASE(args_without_shell)
+{
+    vector<string> stdout = {
+	"stdout #1: hello world",
+	"stdout #2: it's",
+	"stdout #3: $HOME;|*"
+    };
+
+    SystemCmd cmd(SystemCmd::Options(vector<string>{ "../helpers/echoargs", "hello world", "it's", "$HOME;|*" }));
+
+    BOOST_CHECK_EQUAL(cmd.command(), "../helpers/echoargs 'hello world' 'it'\\''s' '$HOME;|*'");
+    BOOST_CHECK_EQUAL(join(cmd.stdout()), join(stdout));
+    BOOST_CHECK(cmd.stderr().empty());
+    BOOST_CHECK(cmd.retcode() == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(no_inherited_fds)
+{
+    // a file descriptor without O_CLOEXEC must not be inherited
+
+    int fd = open("/dev/null", O_RDONLY);
+    BOOST_REQUIRE(fd > 2);
+
+    SystemCmd cmd(SystemCmd::Options(vector<string>{ "ls", "/proc/self/fd" }));
+
+    close(fd);
+
+    BOOST_CHECK(cmd.retcode() == 0);
+    BOOST_CHECK_EQUAL(join(cmd.stdout()), join({ "0", "1", "2", "3" }));
+}
+
+
+BOOST_AUTO_TEST_CASE(stdout_buffer)
+{
+    SystemCmd cmd("printf 'one\\n\\nthree\\nfour'");
+
+    BOOST_CHECK_EQUAL(cmd.stdout_buffer(), "one\n\nthree\nfour");
+    BOOST_CHECK(cmd.stdout_line_offsets() == vector<string::size_type>({ 0, 4, 5, 11 }));
+    BOOST_CHECK_EQUAL(join(cmd.stdout()), join({ "one", "", "three", "four" }));
+}
+
+
 BOOST_AUTO_TEST_CASE(retcode_42)
 {
     SystemCmd cmd("../helpers/retcode 42");
@@ -129,6 +174,22 @@ BOOST_AUTO_TEST_CASE(non_existent_throw)
 }
 
 
+BOOST_AUTO_TEST_CASE(args_non_existent_no_throw)
+{
+    BOOST_CHECK_NO_THROW({
+	SystemCmd cmd(SystemCmd::Options(vector<string>{ "/bin/wrglbrmpf" }, SystemCmd::ThrowBehaviour::NoThrow));
+	BOOST_CHECK_EQUAL(cmd.retcode(), 127);
+    });
+}
+
+
+BOOST_AUTO_TEST_CASE(args_non_existent_throw)
+{
+    BOOST_CHECK_THROW({SystemCmd cmd(SystemCmd::Options(vector<string>{ "/bin/wrglbrmpf" }, SystemCmd::ThrowBehaviour::DoThrow));},
+		      CommandNotFoundException);
+}
+
+
 BOOST_AUTO_TEST_CASE(segfault_no_throw)
 {
     BOOST_CHECK_NO_THROW({
@@ -159,3 +220,32 @@ BOOST_AUTO_TEST_CASE(non_exec_throw)
     BOOST_CHECK_THROW({SystemCmd cmd( "/etc/fstab", SystemCmd::ThrowBehaviour::DoThrow);},
 		      SystemCmdException);
 }
+
+
+BOOST_AUTO_TEST_CASE(start)
+{
+    vector<SystemCmd::Future> futures;
+    for (const string& word : { "one", "two", "three", "four" })
+	futures.push_back(SystemCmd::start(SystemCmd::Options("sleep 1 ; echo " + word)));
+
+    SystemCmd::Options cmd_options("cat");
+    cmd_options.stdin_text = "Hello, cruel world\nI'm leaving you today";
+    SystemCmd::Future future = SystemCmd::start(cmd_options);
+
+    BOOST_CHECK_EQUAL(join(future.get().stdout()), join({ "Hello, cruel world", "I'm leaving you today" }));
+
+    BOOST_CHECK_EQUAL(join(futures[3].get().stdout()), join({ "four" }));
+    BOOST_CHECK_EQUAL(join(futures[0].get().stdout()), join({ "one" }));
+    BOOST_CHECK_EQUAL(futures[1].get().retcode(), 0);
+    BOOST_CHECK(futures[1].ready());
+}
+
+
+BOOST_AUTO_TEST_CASE(start_throw)
+{
+    SystemCmd::Future future1 = SystemCmd::start(SystemCmd::Options("../helpers/retcode 42"));
+    SystemCmd::Future future2 = SystemCmd::start(SystemCmd::Options("/bin/wrglbrmpf", SystemCmd::DoThrow));
+
+    BOOST_CHECK_THROW(future2.get(), CommandNotFoundException);
+    BOOST_CHECK_EQUAL(future1.get().retcode(), 42);
+}
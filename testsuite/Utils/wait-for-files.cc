@@ -0,0 +1,65 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <fstream>
+#include <thread>
+#include <sys/stat.h>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/FileUtils.h"
+#include "storage/Utils/Stopwatch.h"
+#include "storage/Utils/SystemCmd.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(existing)
+{
+    BOOST_CHECK(wait_for_files({ "/", "/tmp" }, 0));
+}
+
+
+BOOST_AUTO_TEST_CASE(timeout)
+{
+    TmpDir tmp_dir("wait-for-files-XXXXXX");
+
+    Stopwatch stopwatch;
+
+    BOOST_CHECK(!wait_for_files({ tmp_dir.get_fullname() + "/missing" }, 200));
+
+    BOOST_CHECK(stopwatch.read() >= 0.2);
+}
+
+
+BOOST_AUTO_TEST_CASE(created)
+{
+    // The files are created after waiting has started, the second one in
+    // a directory that does not exist when waiting starts. Since the files
+    // are checked a last time at the timeout a missed creation only shows
+    // as a call taking until the timeout.
+
+    TmpDir tmp_dir("wait-for-files-XXXXXX");
+
+    const string file1 = tmp_dir.get_fullname() + "/file1";
+    const string dir = tmp_dir.get_fullname() + "/dir";
+    const string file2 = dir + "/file2";
+
+    std::thread thread([&]() {
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	ofstream(file1.c_str());
+	mkdir(dir.c_str(), 0700);
+	ofstream(file2.c_str());
+    });
+
+    Stopwatch stopwatch;
+
+    BOOST_CHECK(wait_for_files({ file1, file2 }, 10000));
+
+    BOOST_CHECK(stopwatch.read() < 5.0);
+
+    thread.join();
+
+    SystemCmd("rm -rf " + SystemCmd::quote(tmp_dir.get_fullname()));
+}
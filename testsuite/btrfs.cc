@@ -5,10 +5,13 @@
 #include <boost/test/unit_test.hpp>
 
 #include "storage/Utils/HumanString.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/BtrfsUtils.h"
 #include "storage/Devices/Disk.h"
 #include "storage/Devices/Gpt.h"
 #include "storage/Filesystems/Btrfs.h"
-#include "storage/Filesystems/BtrfsSubvolume.h"
+#include "storage/Filesystems/BtrfsSubvolumeImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Devicegraph.h"
 #include "storage/Storage.h"
@@ -75,3 +78,85 @@ BOOST_AUTO_TEST_CASE(btrfs1)
     btrfs->set_uuid("dead-beef");
     BOOST_CHECK_EQUAL(mount_point1->get_impl().get_mount_by_name(), "UUID=dead-beef");
 }
+
+
+class TestRemoteCallbacks : public RemoteCallbacks
+{
+public:
+
+    RemoteCommand get_command(const string& name) const override { return RemoteCommand(); }
+    RemoteFile get_file(const string& name) const override { return RemoteFile(); }
+
+};
+
+
+BOOST_AUTO_TEST_CASE(use_ioctls)
+{
+    BOOST_CHECK(btrfs_use_ioctls());
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    BOOST_CHECK(!btrfs_use_ioctls());
+
+    Mockup::set_mode(Mockup::Mode::RECORD);
+    BOOST_CHECK(!btrfs_use_ioctls());
+
+    Mockup::set_mode(Mockup::Mode::NONE);
+
+    TestRemoteCallbacks remote_callbacks;
+    set_remote_callbacks(&remote_callbacks);
+    BOOST_CHECK(!btrfs_use_ioctls());
+
+    set_remote_callbacks(nullptr);
+    BOOST_CHECK(btrfs_use_ioctls());
+}
+
+
+BOOST_AUTO_TEST_CASE(subvolume_actions_with_commands)
+{
+    // With mockup the subvolume actions must run the commands instead of
+    // using the ioctls. The btrfs is mounted at /tmp so no temporary
+    // mount is needed.
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda", 16 * GiB);
+
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 10000000, 512), PartitionType::PRIMARY);
+
+    Btrfs* btrfs = to_btrfs(sda1->create_blk_filesystem(FsType::BTRFS));
+
+    BtrfsSubvolume* top_level = btrfs->get_top_level_btrfs_subvolume();
+    top_level->create_mount_point("/tmp");
+
+    storage.remove_devicegraph("probed");
+    storage.copy_devicegraph("staging", "probed");
+
+    BtrfsSubvolume* subvolume = top_level->create_btrfs_subvolume("test");
+    subvolume->set_nocow(true);
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    Mockup::set_command(BTRFSBIN " subvolume create '/tmp/test'", RemoteCommand());
+    Mockup::set_command(BTRFSBIN " subvolume list -a -p (device:/dev/sda1)",
+			RemoteCommand({ "ID 257 gen 8 parent 5 top level 5 path test" }));
+    Mockup::set_command(CHATTRBIN " +C '/tmp/test'", RemoteCommand());
+    Mockup::set_command(BTRFSBIN " subvolume set-default 257 '/tmp'", RemoteCommand());
+    Mockup::set_command(BTRFSBIN " subvolume delete '/tmp/test'", RemoteCommand());
+
+    // Mockup throws for commands not set above.
+
+    BOOST_CHECK_NO_THROW(subvolume->get_impl().do_create());
+    BOOST_CHECK_EQUAL(subvolume->get_id(), 257);
+
+    BOOST_CHECK_NO_THROW(subvolume->get_impl().do_set_nocow());
+    BOOST_CHECK_NO_THROW(subvolume->get_impl().do_set_default_btrfs_subvolume());
+    BOOST_CHECK_NO_THROW(subvolume->get_impl().do_delete());
+
+    Mockup::set_mode(Mockup::Mode::NONE);
+}
@@ -17,6 +17,7 @@
 #include "storage/Environment.h"
 #include "storage/Storage.h"
 #include "storage/Devicegraph.h"
+#include "storage/DevicegraphImpl.h"
 
 
 using namespace storage;
@@ -58,3 +59,100 @@ BOOST_AUTO_TEST_CASE(copy)
 
     devicegraph_copy->check();
 }
+
+
+BOOST_AUTO_TEST_CASE(independent_copies)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda", Region(0, 1000000, 512));
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+
+    // modifying the source must not modify the copy
+
+    Devicegraph* copy1 = storage.copy_devicegraph("staging", "copy1");
+
+    sda->set_size(2 * sda->get_size());
+
+    BOOST_CHECK_EQUAL(Disk::find_by_name(copy1, "/dev/sda")->get_region().get_length(), 1000000);
+
+    // modifying the copy must not modify the source
+
+    Devicegraph* copy2 = storage.copy_devicegraph("staging", "copy2");
+
+    Disk::find_by_name(copy2, "/dev/sda")->set_name("/dev/sdb");
+
+    BOOST_CHECK_EQUAL(sda->get_name(), "/dev/sda");
+    BOOST_CHECK_EQUAL(copy2->num_devices(), 3);
+
+    // modifying a holder of the source
+
+    Devicegraph* copy3 = storage.copy_devicegraph("staging", "copy3");
+
+    staging->remove_device(Partition::find_by_name(staging, "/dev/sda1"));
+
+    BOOST_CHECK_EQUAL(copy3->num_devices(), 3);
+    BOOST_CHECK_EQUAL(copy3->num_holders(), 2);
+
+    // copies of copies and removing the source
+
+    storage.copy_devicegraph("copy3", "copy4");
+    Devicegraph* copy5 = storage.copy_devicegraph("copy4", "copy5");
+
+    storage.remove_devicegraph("copy4");
+    storage.remove_devicegraph("copy3");
+
+    BOOST_CHECK_EQUAL(copy5->num_devices(), 3);
+
+    copy5->check();
+
+    BOOST_CHECK(*copy1 != *staging);
+    BOOST_CHECK(*copy5 != *staging);
+
+    storage.check();
+}
+
+
+BOOST_AUTO_TEST_CASE(update)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    Disk* sda = Disk::create(lhs, "/dev/sda", Region(0, 1000000, 512));
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+    gpt->create_partition("/dev/sda2", Region(6144, 4096, 512), PartitionType::PRIMARY);
+
+    Disk* sdb = Disk::create(lhs, "/dev/sdb", Region(0, 1000000, 512));
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    // modify a device, remove a device and add devices with holders
+
+    Partition::find_by_name(rhs, "/dev/sda1")->set_region(Region(2048, 2048, 512));
+    rhs->remove_device(Partition::find_by_name(rhs, "/dev/sda2"));
+    Disk::find_by_name(rhs, "/dev/sdb")->create_filesystem(FsType::EXT4);
+
+    lhs->get_impl().update(lhs, rhs->get_impl());
+
+    lhs->check();
+
+    BOOST_CHECK(*lhs == *rhs);
+
+    // unchanged devices are kept
+
+    BOOST_CHECK_EQUAL(Disk::find_by_name(lhs, "/dev/sda"), sda);
+    BOOST_CHECK_EQUAL(Disk::find_by_name(lhs, "/dev/sdb"), sdb);
+    BOOST_CHECK_EQUAL(sda->get_partition_table(), gpt);
+
+    BOOST_CHECK_EQUAL(Partition::find_by_name(lhs, "/dev/sda1")->get_region().get_length(), 2048);
+    BOOST_CHECK_EQUAL(lhs->num_devices(), 5);
+}
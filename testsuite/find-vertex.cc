@@ -6,6 +6,7 @@
 
 #include "storage/Devices/Disk.h"
 #include "storage/Devices/Partition.h"
+#include "storage/Devices/LvmVg.h"
 #include "storage/Holders/Subdevice.h"
 #include "storage/Environment.h"
 #include "storage/Storage.h"
@@ -39,3 +40,64 @@ BOOST_AUTO_TEST_CASE(find_vertex)
     BOOST_CHECK(!sda->exists_in_probed());
     BOOST_CHECK(sda->exists_in_staging());
 }
+
+
+BOOST_AUTO_TEST_CASE(find_after_rename)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+
+    LvmVg* lvm_vg = LvmVg::create(devicegraph, "system");
+
+    sda->set_name("/dev/sdb");
+    lvm_vg->set_vg_name("data");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(devicegraph, "/dev/sdb"), sda);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda"), DeviceNotFound);
+
+    BOOST_CHECK_EQUAL(LvmVg::find_by_vg_name(devicegraph, "data"), lvm_vg);
+    BOOST_CHECK_THROW(LvmVg::find_by_vg_name(devicegraph, "system"), DeviceNotFound);
+
+    Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    sda->set_name("/dev/sdc");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(copy, "/dev/sdb")->get_sid(), sda->get_sid());
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(copy, "/dev/sdc"), DeviceNotFound);
+
+    devicegraph->remove_device(sda);
+
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sdc"), DeviceNotFound);
+}
+
+
+BOOST_AUTO_TEST_CASE(find_duplicate_name)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    // several devices with the same name, e.g. during a rename, the first
+    // one created is found
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb");
+
+    sdb->set_name("/dev/sda");
+
+    for (int i = 0; i < 20; ++i)
+	Disk::create(devicegraph, "/dev/sdc")->set_name("/dev/sda");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(devicegraph, "/dev/sda"), sda);
+
+    devicegraph->remove_device(sda);
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(devicegraph, "/dev/sda"), sdb);
+}
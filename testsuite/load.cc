@@ -0,0 +1,200 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <unistd.h>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/Ext4.h"
+#include "storage/Devices/LvmVg.h"
+#include "storage/Devices/LvmLv.h"
+#include "storage/Filesystems/MountPoint.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+#include "storage/Utils/Exception.h"
+#include "storage/Utils/HumanString.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+namespace
+{
+
+    void
+    create_devicegraph(Devicegraph* devicegraph)
+    {
+	Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+	Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+	Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+	Ext4* ext4 = to_ext4(sda1->create_blk_filesystem(FsType::EXT4));
+	ext4->create_mount_point("/");
+	ext4->set_label("root");
+
+	Partition* sda2 = gpt->create_partition("/dev/sda2", Region(6144, 100000, 512), PartitionType::PRIMARY);
+	LvmVg* system = LvmVg::create(devicegraph, "system");
+	system->add_lvm_pv(sda2);
+	system->create_lvm_lv("home", LvType::NORMAL, 16 * MiB);
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE(save_and_load)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+    create_devicegraph(staging);
+
+    staging->save("load.xml");
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    loaded->load("load.xml");
+
+    BOOST_CHECK_EQUAL(loaded->num_devices(), staging->num_devices());
+    BOOST_CHECK_EQUAL(loaded->num_holders(), staging->num_holders());
+    BOOST_CHECK(*loaded == *staging);
+
+    loaded->check();
+
+    unlink("load.xml");
+}
+
+
+BOOST_AUTO_TEST_CASE(save_and_load_binary)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+    create_devicegraph(staging);
+
+    staging->save_binary("load.bin");
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    loaded->load_binary("load.bin");
+
+    BOOST_CHECK_EQUAL(loaded->num_devices(), staging->num_devices());
+    BOOST_CHECK_EQUAL(loaded->num_holders(), staging->num_holders());
+    BOOST_CHECK(*loaded == *staging);
+
+    loaded->check();
+
+    // the xml loader does not accept the binary format
+
+    BOOST_CHECK_THROW(loaded->load("load.bin"), Exception);
+
+    unlink("load.bin");
+}
+
+
+BOOST_AUTO_TEST_CASE(probe_binary)
+{
+    Environment environment1(true, ProbeMode::NONE, TargetMode::DIRECT);
+    Storage storage1(environment1);
+
+    Devicegraph* saved = storage1.get_staging();
+    create_devicegraph(saved);
+    saved->save_binary("load.bin");
+
+    Environment environment2(true, ProbeMode::READ_DEVICEGRAPH, TargetMode::DIRECT);
+    environment2.set_devicegraph_filename("load.bin");
+
+    Storage storage2(environment2);
+    storage2.probe();
+
+    BOOST_CHECK_EQUAL(storage2.get_probed()->num_devices(), saved->num_devices());
+    BOOST_CHECK_EQUAL(storage2.get_probed()->num_holders(), saved->num_holders());
+
+    unlink("load.bin");
+}
+
+
+BOOST_AUTO_TEST_CASE(load_binary_truncated)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+    create_devicegraph(staging);
+
+    staging->save_binary("load.bin");
+    BOOST_CHECK_EQUAL(truncate("load.bin", 100), 0);
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    BOOST_CHECK_THROW(loaded->load_binary("load.bin"), Exception);
+
+    unlink("load.bin");
+}
+
+
+BOOST_AUTO_TEST_CASE(load_binary_invalid_number_of_strings)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    // header with version 2 and 0xffffffff strings but no data
+
+    ofstream file("load.bin", ofstream::binary);
+    file << "STDGBIN\n" << string("\x02\x00\x00\x00\xff\xff\xff\xff", 8);
+    file.close();
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    BOOST_CHECK_THROW(loaded->load_binary("load.bin"), Exception);
+
+    unlink("load.bin");
+}
+
+
+BOOST_AUTO_TEST_CASE(load_unknown_class)
+{
+    ofstream fout("load.xml");
+    fout << "<?xml version=\"1.0\"?>\n"
+	"<Devicegraph>\n"
+	"  <Devices>\n"
+	"    <Floppy>\n"
+	"      <sid>42</sid>\n"
+	"    </Floppy>\n"
+	"  </Devices>\n"
+	"</Devicegraph>\n";
+    fout.close();
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    BOOST_CHECK_THROW(loaded->load("load.xml"), Exception);
+
+    unlink("load.xml");
+}
+
+
+BOOST_AUTO_TEST_CASE(load_wrong_root)
+{
+    ofstream fout("load.xml");
+    fout << "<?xml version=\"1.0\"?>\n"
+	"<Something/>\n";
+    fout.close();
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    BOOST_CHECK_THROW(loaded->load("load.xml"), Exception);
+
+    unlink("load.xml");
+}
@@ -0,0 +1,159 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Msdos.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Region.h"
+#include "storage/Utils/HumanString.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(test_gpt)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    vector<Partition*> partitions = gpt->create_partitions({
+	PartitionRequest(100 * MiB, 100 * MiB),
+	PartitionRequest(50 * MiB, 1 * TiB, 1),
+	PartitionRequest(50 * MiB, 1 * TiB, 3)
+    });
+
+    storage.check();
+
+    BOOST_REQUIRE_EQUAL(partitions.size(), 3);
+
+    BOOST_CHECK_EQUAL(partitions[0]->get_name(), "/dev/sda1");
+    BOOST_CHECK_EQUAL(partitions[0]->get_region(), Region(1 * 2048, 100 * 2048, 512));
+
+    BOOST_CHECK_EQUAL(partitions[1]->get_name(), "/dev/sda2");
+    BOOST_CHECK_EQUAL(partitions[1]->get_region(), Region(101 * 2048, 122 * 2048, 512));
+
+    BOOST_CHECK_EQUAL(partitions[2]->get_name(), "/dev/sda3");
+    BOOST_CHECK_EQUAL(partitions[2]->get_region(), Region(223 * 2048, 265 * 2048, 512));
+
+    // only the unaligned end of the disk is left
+
+    vector<PartitionSlot> slots = gpt->get_unused_partition_slots();
+
+    BOOST_REQUIRE_EQUAL(slots.size(), 1);
+    BOOST_CHECK_EQUAL(slots[0].region.get_start(), 488 * 2048);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_gpt_first_fit)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    gpt->create_partition("/dev/sda1", Region(21 * 2048, 100 * 2048, 512), PartitionType::PRIMARY);
+
+    vector<Partition*> partitions = gpt->create_partitions({
+	PartitionRequest(50 * MiB, 50 * MiB, 0),
+	PartitionRequest(10 * MiB, 10 * MiB, 0),
+	PartitionRequest(10 * MiB, 10 * MiB, 0)
+    });
+
+    storage.check();
+
+    BOOST_REQUIRE_EQUAL(partitions.size(), 3);
+
+    BOOST_CHECK_EQUAL(partitions[0]->get_name(), "/dev/sda2");
+    BOOST_CHECK_EQUAL(partitions[0]->get_region(), Region(121 * 2048, 50 * 2048, 512));
+
+    BOOST_CHECK_EQUAL(partitions[1]->get_name(), "/dev/sda3");
+    BOOST_CHECK_EQUAL(partitions[1]->get_region(), Region(1 * 2048, 10 * 2048, 512));
+
+    BOOST_CHECK_EQUAL(partitions[2]->get_name(), "/dev/sda4");
+    BOOST_CHECK_EQUAL(partitions[2]->get_region(), Region(11 * 2048, 10 * 2048, 512));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_does_not_fit)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    BOOST_CHECK_THROW(gpt->create_partitions({
+	PartitionRequest(300 * MiB, 300 * MiB),
+	PartitionRequest(300 * MiB, 300 * MiB)
+    }), Exception);
+
+    BOOST_CHECK_EQUAL(gpt->num_primary(), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_msdos_logical)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    PartitionTable* msdos = sda->create_partition_table(PtType::MSDOS);
+
+    msdos->create_partition("/dev/sda1", Region(1 * 2048, 200 * 2048, 512), PartitionType::EXTENDED);
+
+    vector<Partition*> partitions = msdos->create_partitions({
+	PartitionRequest(10 * MiB, 10 * MiB, 0, PartitionType::LOGICAL),
+	PartitionRequest(10 * MiB, 10 * MiB, 0, PartitionType::LOGICAL),
+	PartitionRequest(20 * MiB, 20 * MiB, 0, PartitionType::PRIMARY)
+    });
+
+    storage.check();
+
+    BOOST_REQUIRE_EQUAL(partitions.size(), 3);
+
+    BOOST_CHECK_EQUAL(partitions[0]->get_name(), "/dev/sda5");
+    BOOST_CHECK_EQUAL(partitions[0]->get_region(), Region(2 * 2048, 10 * 2048, 512));
+
+    // one grain for the EBR between the logical partitions
+    BOOST_CHECK_EQUAL(partitions[1]->get_name(), "/dev/sda6");
+    BOOST_CHECK_EQUAL(partitions[1]->get_region(), Region(13 * 2048, 10 * 2048, 512));
+
+    BOOST_CHECK_EQUAL(partitions[2]->get_name(), "/dev/sda2");
+    BOOST_CHECK_EQUAL(partitions[2]->get_region(), Region(201 * 2048, 20 * 2048, 512));
+}
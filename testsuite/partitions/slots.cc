@@ -282,3 +282,85 @@ BOOST_AUTO_TEST_CASE(test_dasd1)
     BOOST_CHECK_EQUAL(slots[1].logical_slot, false);
     BOOST_CHECK_EQUAL(slots[1].logical_possible, false);
 }
+
+
+BOOST_AUTO_TEST_CASE(test_slots_after_modifications)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    // Fills the slot index.
+    BOOST_CHECK_EQUAL(gpt->get_unused_partition_slots().size(), 1);
+
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(1 * 2048, 10 * 2048, 512), PartitionType::PRIMARY);
+    Partition* sda2 = gpt->create_partition("/dev/sda2", Region(20 * 2048, 10 * 2048, 512), PartitionType::PRIMARY);
+    gpt->create_partition("/dev/sda3", Region(40 * 2048, 10 * 2048, 512), PartitionType::PRIMARY);
+
+    vector<PartitionSlot> slots = gpt->get_unused_partition_slots();
+
+    BOOST_REQUIRE_EQUAL(slots.size(), 3);
+    BOOST_CHECK_EQUAL(slots[0].region, Region(11 * 2048, 9 * 2048, 512));
+    BOOST_CHECK_EQUAL(slots[1].region, Region(30 * 2048, 10 * 2048, 512));
+    BOOST_CHECK_EQUAL(slots[2].region.get_start(), 50 * 2048);
+    BOOST_CHECK_EQUAL(slots[0].number, 4);
+
+    sda1->set_region(Region(1 * 2048, 15 * 2048, 512));
+    gpt->delete_partition(sda2);
+
+    slots = gpt->get_unused_partition_slots();
+
+    BOOST_REQUIRE_EQUAL(slots.size(), 2);
+    BOOST_CHECK_EQUAL(slots[0].region, Region(16 * 2048, 24 * 2048, 512));
+    BOOST_CHECK_EQUAL(slots[0].number, 2);
+    BOOST_CHECK_EQUAL(slots[0].name, "/dev/sda2");
+    BOOST_CHECK_EQUAL(slots[1].region.get_start(), 50 * 2048);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_largest_slot)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    PartitionTable* msdos = sda->create_partition_table(PtType::MSDOS);
+
+    msdos->create_partition("/dev/sda1", Region(1 * 2048, 100 * 2048, 512), PartitionType::PRIMARY);
+    msdos->create_partition("/dev/sda2", Region(120 * 2048, 300 * 2048, 512), PartitionType::EXTENDED);
+    msdos->create_partition("/dev/sda5", Region(121 * 2048, 10 * 2048, 512), PartitionType::LOGICAL);
+
+    PartitionSlot slot = msdos->get_largest_unused_partition_slot();
+
+    BOOST_CHECK_EQUAL(slot.region, Region(132 * 2048, 288 * 2048, 512));
+    BOOST_CHECK_EQUAL(slot.logical_slot, true);
+    BOOST_CHECK_EQUAL(slot.number, 6);
+
+    msdos->create_partition("/dev/sda3", Region(420 * 2048, 1000000 - 420 * 2048, 512), PartitionType::PRIMARY);
+
+    slot = msdos->get_largest_unused_partition_slot();
+
+    BOOST_CHECK_EQUAL(slot.region, Region(132 * 2048, 288 * 2048, 512));
+
+    msdos->create_partition("/dev/sda6", Region(132 * 2048, 288 * 2048, 512), PartitionType::LOGICAL);
+
+    slot = msdos->get_largest_unused_partition_slot();
+
+    BOOST_CHECK_EQUAL(slot.region, Region(101 * 2048, 19 * 2048, 512));
+    BOOST_CHECK_EQUAL(slot.primary_slot, true);
+    BOOST_CHECK_EQUAL(slot.number, 4);
+}
@@ -0,0 +1,127 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+string
+disk_name(int i)
+{
+    ostringstream s;
+    s << "/dev/disk" << i;
+    return s.str();
+}
+
+
+vector<sid_t>
+add_disks(Devicegraph* devicegraph, int n)
+{
+    vector<sid_t> sids;
+
+    for (int i = 0; i < n; ++i)
+    {
+	Disk* disk = Disk::create(devicegraph, disk_name(i), Region(0, 1000000, 512));
+	PartitionTable* partition_table = disk->create_partition_table(PtType::GPT);
+	Partition* partition = partition_table->create_partition(disk_name(i) + "p1", Region(2048, 4096, 512),
+								 PartitionType::PRIMARY);
+
+	sids.push_back(disk->get_sid());
+	sids.push_back(partition_table->get_sid());
+	sids.push_back(partition->get_sid());
+    }
+
+    return sids;
+}
+
+
+/**
+ * Looks up every device and holder in the devicegraph and returns the time
+ * needed per lookup.
+ */
+double
+lookup(const Devicegraph* devicegraph, const vector<sid_t>& sids, int rounds)
+{
+    Stopwatch stopwatch;
+
+    for (int round = 0; round < rounds; ++round)
+    {
+	for (size_t i = 0; i < sids.size(); i += 3)
+	{
+	    BOOST_REQUIRE(devicegraph->device_exists(sids[i]));
+	    BOOST_REQUIRE(devicegraph->find_device(sids[i + 2])->get_sid() == sids[i + 2]);
+	    BOOST_REQUIRE(devicegraph->find_holder(sids[i + 1], sids[i + 2]));
+	}
+    }
+
+    return stopwatch.read() / (rounds * sids.size());
+}
+
+
+BOOST_AUTO_TEST_CASE(consistency)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    vector<sid_t> sids = add_disks(lhs, 10);
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    lhs->remove_device(sids[2]);
+
+    BOOST_CHECK(!lhs->device_exists(sids[2]));
+    BOOST_CHECK_THROW(lhs->find_holder(sids[1], sids[2]), HolderNotFoundBySids);
+    BOOST_CHECK(lhs->find_holder(sids[0], sids[1]));
+
+    BOOST_CHECK(rhs->device_exists(sids[2]));
+    BOOST_CHECK(rhs->find_holder(sids[1], sids[2]));
+
+    storage.restore_devicegraph("lhs");
+
+    BOOST_CHECK(!storage.get_staging()->device_exists(sids[2]));
+
+    rhs->clear();
+
+    BOOST_CHECK(!rhs->device_exists(sids[0]));
+    BOOST_CHECK_THROW(rhs->find_device(sids[0]), DeviceNotFoundBySid);
+}
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* small = storage.create_devicegraph("small");
+    vector<sid_t> small_sids = add_disks(small, 200);
+
+    Devicegraph* large = storage.create_devicegraph("large");
+    vector<sid_t> large_sids = add_disks(large, 4000);
+
+    // The devicegraph is 20 times larger but the time per lookup should stay
+    // about the same. With a linear search it would be 20 times slower. The
+    // times are only reported since wall-clock limits are not stable on
+    // loaded build hosts.
+
+    double t1 = lookup(small, small_sids, 200);
+    double t2 = lookup(large, large_sids, 10);
+
+    BOOST_TEST_MESSAGE("time per lookup small: " << t1 << " s, large: " << t2 << " s");
+}
@@ -0,0 +1,151 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <new>
+#include <cstdlib>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/AlignmentImpl.h"
+#include "storage/Utils/Topology.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+/**
+ * Number of allocations done by operator new.
+ */
+static unsigned long num_allocations = 0;
+
+
+void*
+operator new(size_t size)
+{
+    ++num_allocations;
+
+    void* p = malloc(size == 0 ? 1 : size);
+    if (!p)
+	throw bad_alloc();
+
+    return p;
+}
+
+
+void
+operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+
+void
+operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+
+BOOST_AUTO_TEST_CASE(align_region)
+{
+    const Alignment alignment(Topology(0, 0), AlignType::OPTIMAL);
+
+    const int rounds = 1000000;
+
+    // align with Region
+
+    unsigned long allocations1 = num_allocations;
+    Stopwatch stopwatch1;
+
+    unsigned long long sum1 = 0;
+    for (int i = 0; i < rounds; ++i)
+    {
+	Region region(i, 1000000, 512);
+	if (alignment.get_impl().align_region_in_place(region, AlignPolicy::ALIGN_END))
+	    sum1 += region.get_start();
+    }
+
+    double t1 = stopwatch1.read();
+    allocations1 = num_allocations - allocations1;
+
+    // align with Region::Impl
+
+    unsigned long allocations2 = num_allocations;
+    Stopwatch stopwatch2;
+
+    unsigned long long sum2 = 0;
+    for (int i = 0; i < rounds; ++i)
+    {
+	Region::Impl region(i, 1000000, 512);
+	if (alignment.get_impl().align_region_in_place(region, AlignPolicy::ALIGN_END))
+	    sum2 += region.get_start();
+    }
+
+    double t2 = stopwatch2.read();
+    allocations2 = num_allocations - allocations2;
+
+    cout << "align with Region " << t1 << " s, " << allocations1 << " allocations" << endl;
+    cout << "align with Region::Impl " << t2 << " s, " << allocations2 << " allocations" << endl;
+
+    BOOST_CHECK_EQUAL(sum1, sum2);
+
+    BOOST_CHECK_EQUAL(allocations1, rounds);
+    BOOST_CHECK_EQUAL(allocations2, 0);
+}
+
+
+/**
+ * Returns the number of allocations needed to query the largest unused
+ * partition slot on a GPT with n partitions.
+ */
+unsigned long
+largest_slot_allocations(int n)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000000, 512));
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    for (int i = 0; i < n; ++i)
+	gpt->create_partition("/dev/sda" + to_string(i + 1), Region((2 * i + 1) * 2048, 2048, 512),
+			      PartitionType::PRIMARY);
+
+    // fill the slot index
+    gpt->get_largest_unused_partition_slot();
+
+    unsigned long allocations = num_allocations;
+
+    Stopwatch stopwatch;
+
+    const int rounds = 1000;
+    for (int i = 0; i < rounds; ++i)
+	BOOST_REQUIRE_EQUAL(gpt->get_largest_unused_partition_slot().region.get_start(), 2 * n * 2048);
+
+    allocations = (num_allocations - allocations) / rounds;
+
+    cout << "largest slot with " << n << " partitions " << stopwatch.read() / rounds << " s, "
+	 << allocations << " allocations" << endl;
+
+    return allocations;
+}
+
+
+BOOST_AUTO_TEST_CASE(largest_slot)
+{
+    // The number of allocations must not depend on the number of
+    // partitions.
+
+    BOOST_CHECK_EQUAL(largest_slot_allocations(10), largest_slot_allocations(120));
+}
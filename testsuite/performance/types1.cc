@@ -0,0 +1,104 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/LvmVg.h"
+#include "storage/Devicegraph.h"
+#include "storage/DevicegraphImpl.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+string
+disk_name(int i)
+{
+    ostringstream s;
+    s << "/dev/disk" << i;
+    return s.str();
+}
+
+
+/**
+ * The old implementation of Devicegraph::Impl::get_devices_of_type().
+ */
+template<typename Type>
+vector<Type*>
+get_devices_of_type_by_scan(const Devicegraph* devicegraph)
+{
+    vector<Type*> ret;
+
+    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+    {
+	Type* device = dynamic_cast<Type*>(devicegraph->get_impl().graph[vertex].get());
+	if (device)
+	    ret.push_back(device);
+    }
+
+    return ret;
+}
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("large");
+
+    // 12500 disks each with a partition table and two partitions give 50000
+    // devices
+
+    const int n = 12500;
+
+    for (int i = 0; i < n; ++i)
+    {
+	Disk* disk = Disk::create(devicegraph, disk_name(i), Region(0, 1000000, 512));
+	PartitionTable* gpt = disk->create_partition_table(PtType::GPT);
+	gpt->create_partition(disk_name(i) + "p1", Region(2048, 2048, 512), PartitionType::PRIMARY);
+	gpt->create_partition(disk_name(i) + "p2", Region(4096, 2048, 512), PartitionType::PRIMARY);
+    }
+
+    LvmVg::create(devicegraph, "system");
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), 4 * n + 1);
+
+    // check that both approaches give the same result in the same order
+
+    BOOST_CHECK(devicegraph->get_impl().get_devices_of_type<Partition>() ==
+		get_devices_of_type_by_scan<Partition>(devicegraph));
+
+    BOOST_CHECK(devicegraph->get_impl().get_devices_of_type<BlkDevice>() ==
+		get_devices_of_type_by_scan<BlkDevice>(devicegraph));
+
+    BOOST_CHECK(devicegraph->get_impl().get_devices_of_type<Device>() ==
+		get_devices_of_type_by_scan<Device>(devicegraph));
+
+    // compare the time for querying a rare type, the times are only reported
+    // since wall-clock limits are not stable on loaded build hosts
+
+    const int rounds = 100;
+
+    Stopwatch stopwatch1;
+    for (int i = 0; i < rounds; ++i)
+	BOOST_REQUIRE(get_devices_of_type_by_scan<LvmVg>(devicegraph).size() == 1);
+    double t1 = stopwatch1.read();
+
+    Stopwatch stopwatch2;
+    for (int i = 0; i < rounds; ++i)
+	BOOST_REQUIRE(devicegraph->get_impl().get_devices_of_type<LvmVg>().size() == 1);
+    double t2 = stopwatch2.read();
+
+    BOOST_TEST_MESSAGE("time by scan: " << t1 << " s, by type: " << t2 << " s");
+}
@@ -4,11 +4,17 @@
 
 #include <iostream>
 #include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include "storage/Environment.h"
 #include "storage/Storage.h"
+#include "storage/Devices/BlkDevice.h"
+#include "storage/Devices/DeviceImpl.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Filesystems/MountPoint.h"
 #include "storage/DevicegraphImpl.h"
 #include "storage/UsedFeatures.h"
+#include "storage/ProbeStatistics.h"
 
 #include "testsuite/helpers/TsCmp.h"
 
@@ -39,3 +45,129 @@ BOOST_AUTO_TEST_CASE(probe)
 
     BOOST_CHECK_BITWISE_EQUAL(probed->used_features(), UF_EXT4 | UF_SWAP);
 }
+
+
+BOOST_AUTO_TEST_CASE(probe_statistics)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::READ_MOCKUP, TargetMode::DIRECT);
+    environment.set_mockup_filename("disk-mockup.xml");
+
+    Storage storage(environment);
+    storage.probe();
+
+    const ProbeStatistics& probe_statistics = storage.get_probe_statistics();
+
+    vector<string> passes;
+    for (const TimeEntry& time_entry : probe_statistics.passes)
+	passes.push_back(time_entry.name);
+
+    BOOST_CHECK_EQUAL(boost::algorithm::join(passes, " "), "prefetch 1a 1b 1c 1d 1e 2");
+
+    vector<string> device_classes;
+    for (const TimeEntry& time_entry : probe_statistics.device_classes)
+	device_classes.push_back(time_entry.name);
+
+    BOOST_CHECK(find(device_classes.begin(), device_classes.end(), "1a Disk") != device_classes.end());
+    BOOST_CHECK(find(device_classes.begin(), device_classes.end(), "1c Disk") != device_classes.end());
+    BOOST_CHECK(find(device_classes.begin(), device_classes.end(), "2 Ext4") != device_classes.end());
+
+    vector<CommandStatistics>::const_iterator it = find_if(probe_statistics.commands.begin(),
+	probe_statistics.commands.end(), [](const CommandStatistics& command_statistics) {
+	    return command_statistics.binary == "/usr/sbin/parted";
+	});
+
+    BOOST_REQUIRE(it != probe_statistics.commands.end());
+    BOOST_CHECK_EQUAL(it->count, 2);
+    BOOST_CHECK_EQUAL(it->slowest.size(), 2);
+
+    BOOST_CHECK(boost::starts_with(probe_statistics.to_json(), "{"));
+}
+
+
+BOOST_AUTO_TEST_CASE(reprobe)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::READ_MOCKUP, TargetMode::DIRECT);
+    environment.set_mockup_filename("disk-mockup.xml");
+
+    Storage storage(environment);
+    storage.probe();
+
+    Devicegraph* full = storage.copy_devicegraph("probed", "full");
+
+    const BlkDevice* sdb = BlkDevice::find_by_name(storage.get_probed(), "/dev/sdb");
+
+    storage.reprobe({ "sda" });
+
+    const Devicegraph* probed = storage.get_probed();
+    probed->check();
+
+    BOOST_CHECK(probed->get_impl() == full->get_impl());
+
+    // the probed devicegraph is updated in place, so unchanged devices are
+    // kept
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(probed, "/dev/sdb"), sdb);
+
+    // parted is only run for sda, not for sdb
+
+    const ProbeStatistics& probe_statistics = storage.get_probe_statistics();
+
+    vector<CommandStatistics>::const_iterator it = find_if(probe_statistics.commands.begin(),
+	probe_statistics.commands.end(), [](const CommandStatistics& command_statistics) {
+	    return command_statistics.binary == "/usr/sbin/parted";
+	});
+
+    BOOST_REQUIRE(it != probe_statistics.commands.end());
+    BOOST_CHECK_EQUAL(it->count, 1);
+}
+
+
+namespace
+{
+
+    string
+    device_order(const Devicegraph* devicegraph)
+    {
+	vector<string> ret;
+
+	for (const Device* device : devicegraph->get_impl().get_devices_of_type<const Device>())
+	    ret.push_back(string(device->get_impl().get_classname()) + " " + device->get_displayname());
+
+	return boost::join(ret, ", ");
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE(reprobe_order)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::READ_MOCKUP, TargetMode::DIRECT);
+    environment.set_mockup_filename("disk-mockup.xml");
+
+    Storage storage(environment);
+    storage.probe();
+
+    Devicegraph* full = storage.copy_devicegraph("probed", "full");
+
+    // modify probed, as if the disk had changed since the probe, so that
+    // the reprobe replaces one device and adds another one
+
+    Devicegraph* probed = const_cast<Devicegraph*>(storage.get_probed());
+
+    BlkFilesystem* blk_filesystem = BlkDevice::find_by_name(probed, "/dev/sda1")->get_blk_filesystem();
+    blk_filesystem->set_label("changed");
+    probed->remove_device(blk_filesystem->get_mount_point());
+
+    storage.reprobe({ "sda" });
+
+    // the devices have the order of a full probe
+
+    BOOST_CHECK_EQUAL(device_order(storage.get_probed()), device_order(full));
+    BOOST_CHECK_EQUAL(device_order(storage.get_staging()), device_order(full));
+}